@@ -22,6 +22,7 @@
 #include <string>
 
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/request_timeout_token.hpp"
 #include "caf/fwd.hpp"
 
 namespace caf {
@@ -60,9 +61,12 @@ public:
                                  std::string type, uint64_t id)
     = 0;
 
-  /// Schedules a `sec::request_timeout` for `self` at time point `t`.
-  virtual void
-  set_request_timeout(time_point t, abstract_actor* self, message_id id)
+  /// Schedules a `sec::request_timeout` for `self` at time point `t`. The
+  /// clock drops the timeout instead if `token` is marked as answered by then.
+  /// Passing `nullptr` disables lazy cancellation.
+  virtual void set_request_timeout(time_point t, abstract_actor* self,
+                                   message_id id,
+                                   detail::request_timeout_token_ptr token)
     = 0;
 
   /// Cancels a pending receive timeout.
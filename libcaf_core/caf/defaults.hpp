@@ -53,7 +53,9 @@ extern CAF_CORE_EXPORT const string_view policy;
 extern CAF_CORE_EXPORT string_view profiling_output_file;
 extern CAF_CORE_EXPORT const size_t max_threads;
 extern CAF_CORE_EXPORT const size_t max_throughput;
+extern CAF_CORE_EXPORT const size_t mailbox_batch_size;
 extern CAF_CORE_EXPORT const timespan profiling_resolution;
+extern CAF_CORE_EXPORT const bool pin_workers;
 
 } // namespace scheduler
 
@@ -64,11 +66,18 @@ extern CAF_CORE_EXPORT const size_t aggressive_steal_interval;
 extern CAF_CORE_EXPORT const size_t moderate_poll_attempts;
 extern CAF_CORE_EXPORT const size_t moderate_steal_interval;
 extern CAF_CORE_EXPORT const timespan moderate_sleep_duration;
-extern CAF_CORE_EXPORT const size_t relaxed_steal_interval;
-extern CAF_CORE_EXPORT const timespan relaxed_sleep_duration;
+extern CAF_CORE_EXPORT const size_t initial_deque_capacity;
+extern CAF_CORE_EXPORT const size_t injection_queue_capacity;
+extern CAF_CORE_EXPORT const bool topology_aware;
 
 } // namespace work_stealing
 
+namespace memory {
+
+extern CAF_CORE_EXPORT const bool enable_pooling;
+
+} // namespace memory
+
 namespace logger {
 
 extern CAF_CORE_EXPORT string_view component_filter;
@@ -78,6 +87,7 @@ extern CAF_CORE_EXPORT const string_view console_verbosity;
 extern CAF_CORE_EXPORT string_view file_format;
 extern CAF_CORE_EXPORT string_view file_name;
 extern CAF_CORE_EXPORT const string_view file_verbosity;
+extern CAF_CORE_EXPORT const size_t queue_size;
 
 } // namespace logger
 
@@ -90,6 +100,16 @@ extern CAF_CORE_EXPORT const size_t heartbeat_interval;
 extern CAF_CORE_EXPORT const size_t cached_udp_buffers;
 extern CAF_CORE_EXPORT const size_t max_pending_msgs;
 extern CAF_CORE_EXPORT const size_t workers;
+extern CAF_CORE_EXPORT const size_t max_workers;
+extern CAF_CORE_EXPORT const timespan worker_idle_timeout;
+extern CAF_CORE_EXPORT const size_t multiplexer_threads;
+extern CAF_CORE_EXPORT const size_t buffer_pool_size;
+extern CAF_CORE_EXPORT const size_t buffer_pool_max_capacity;
+extern CAF_CORE_EXPORT const size_t compression_threshold;
+extern CAF_CORE_EXPORT const size_t high_watermark;
+extern CAF_CORE_EXPORT const size_t low_watermark;
+extern CAF_CORE_EXPORT const string_view local_socket_dir;
+extern CAF_CORE_EXPORT const double udp_loss_rate;
 
 } // namespace middleman
 
@@ -22,8 +22,10 @@
 #include <condition_variable>
 #include <mutex>
 
+#include "caf/actor_clock.hpp"
 #include "caf/detail/core_export.hpp"
 #include "caf/fwd.hpp"
+#include "caf/timespan.hpp"
 
 namespace caf::detail {
 
@@ -45,6 +47,33 @@ public:
   /// Waits until all workers are back at the hub.
   void await_workers();
 
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the number of workers owned by this hub.
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Returns whether all workers are currently back at the hub.
+  bool idle() const noexcept {
+    return running_ == 0;
+  }
+
+  // -- pool management --------------------------------------------------------
+
+  /// Destroys one idle worker if the hub owns more than `min_size` workers.
+  /// @returns `true` if the hub destroyed a worker, `false` otherwise.
+  /// @pre Only the master may call this function.
+  bool shrink(size_t min_size);
+
+  /// Destroys one idle worker if the hub owns more than `min_size` workers and
+  /// the master observed the hub as idle for at least `delay`. Each destroyed
+  /// worker restarts the delay, i.e., the hub removes at most one worker per
+  /// `delay`.
+  /// @returns `true` if the hub destroyed a worker, `false` otherwise.
+  /// @pre Only the master may call this function.
+  bool shrink(size_t min_size, actor_clock::time_point now, timespan delay);
+
 protected:
   // -- worker management ------------------------------------------------------
 
@@ -70,6 +99,13 @@ protected:
 
   std::atomic<size_t> running_;
 
+  /// Number of workers owned by this hub. Only the master modifies this count.
+  size_t size_;
+
+  /// Stores when the master first observed the hub as idle or
+  /// `time_point::max()` while at least one worker is running.
+  actor_clock::time_point idle_since_;
+
   std::mutex mtx_;
 
   std::condition_variable cv_;
@@ -0,0 +1,144 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/logger.hpp"
+#include "caf/string_view.hpp"
+#include "caf/timestamp.hpp"
+
+namespace caf::detail {
+
+/// Writes log events to a binary log file. A file starts with a header that
+/// consists of the magic string `CAFLOG`, a version byte, and the timestamp
+/// of the logger start. Each record starts with a kind byte:
+/// - `S` defines a log site (level, line, component, function, and file)
+///   and assigns an integer ID to it.
+/// - `E` stores an event: the site ID, the time since the logger start, the
+///   thread, the actor ID, and the arguments in the format of
+///   `log_arg_encoder`.
+///
+/// Integers use the varint encoding of `log_arg_encoder`. The writer emits
+/// site definitions once, before the first event that refers to them.
+class CAF_CORE_EXPORT binary_log_writer {
+public:
+  /// Version of the binary log format.
+  static constexpr uint8_t version = 1;
+
+  /// Writes the file header.
+  void write_header(std::ostream& out, timestamp t0);
+
+  /// Writes `x` to `out`, preceded by a site definition on first use.
+  /// @pre `x.message` stores encoded arguments (see `logger::event::encoded`).
+  void write(std::ostream& out, const logger::event& x);
+
+private:
+  struct site_key {
+    const char* fun;
+    const char* component;
+    unsigned line;
+    unsigned level;
+
+    bool operator==(const site_key& other) const noexcept {
+      return fun == other.fun && component == other.component
+             && line == other.line && level == other.level;
+    }
+  };
+
+  struct site_key_hash {
+    size_t operator()(const site_key& x) const noexcept;
+  };
+
+  void put_varint(uint64_t x);
+
+  void put_str(string_view str);
+
+  timestamp t0_;
+
+  std::unordered_map<site_key, uint64_t, site_key_hash> sites_;
+
+  std::string buf_;
+};
+
+/// Reads log events from a file produced by `binary_log_writer`.
+class CAF_CORE_EXPORT binary_log_reader {
+public:
+  /// Describes a single log statement.
+  struct site {
+    unsigned level;
+    unsigned line;
+    std::string component;
+    std::string pretty_fun;
+    std::string simple_fun;
+    std::string file_name;
+  };
+
+  /// Stores a single decoded event. The site pointer remains valid until the
+  /// reader encounters the header of the next run (see `next`).
+  struct event {
+    const site* origin;
+    timestamp tstamp;
+    uint64_t tid;
+    actor_id aid;
+    std::string message;
+  };
+
+  explicit binary_log_reader(std::istream& in);
+
+  /// Reads the file header.
+  /// @returns `false` if the input is not a binary log file.
+  bool read_header();
+
+  /// Returns the timestamp of the logger start.
+  timestamp t0() const noexcept {
+    return t0_;
+  }
+
+  /// Reads the next event from the file, skipping over the headers of
+  /// subsequent runs when reading a file that the logger appended to.
+  /// @returns `false` at the end of the input or on malformed input.
+  bool next(event& x);
+
+  /// Returns whether the reader stopped at malformed input.
+  bool malformed() const noexcept {
+    return malformed_;
+  }
+
+private:
+  bool get_varint(uint64_t& x);
+
+  bool get_str(std::string& x);
+
+  std::istream& in_;
+
+  timestamp t0_;
+
+  bool malformed_ = false;
+
+  std::unordered_map<uint64_t, site> sites_;
+
+  std::string buf_;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,182 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "caf/config.hpp"
+
+namespace caf::detail {
+
+/// A lock-free work-stealing deque as described by Chase and Lev in "Dynamic
+/// Circular Work-Stealing Deque" (SPAA '05), using the C11 memory orderings
+/// from Lê et al., "Correct and Efficient Work-Stealing for Weak Memory
+/// Models" (PPoPP '13).
+///
+/// Only the owner of the deque may call `push` and `take`, which operate on
+/// the *bottom* end in LIFO order. Any thread may call `steal`, which removes
+/// elements from the *top* end in FIFO order. The deque stores raw pointers
+/// and never allocates on `push` unless it needs to grow its buffer. Retired
+/// buffers stay alive until the deque gets destroyed, because concurrent
+/// thieves may still read from them.
+template <class T>
+class chase_lev_deque {
+public:
+  using value_type = T;
+
+  using pointer = value_type*;
+
+  explicit chase_lev_deque(size_t initial_capacity = 64)
+    : top_(0), bottom_(0) {
+    size_t capacity = 2;
+    while (capacity < initial_capacity)
+      capacity <<= 1;
+    retired_.emplace_back(new buffer(capacity));
+    buf_ = retired_.back().get();
+  }
+
+  chase_lev_deque(const chase_lev_deque&) = delete;
+
+  chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+  /// Pushes `x` to the bottom of the deque.
+  /// @warning Must only be called by the owner.
+  void push(pointer x) {
+    CAF_ASSERT(x != nullptr);
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_acquire);
+    auto buf = buf_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(buf->mask))
+      buf = grow(buf, t, b);
+    buf->store(b, x);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /// Removes the element at the bottom of the deque. Returns `nullptr` if the
+  /// deque is empty or a thief took the last element.
+  /// @warning Must only be called by the owner.
+  pointer take() {
+    auto b = bottom_.load(std::memory_order_relaxed) - 1;
+    auto buf = buf_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Empty deque.
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    auto result = buf->load(b);
+    if (t == b) {
+      // Last element, race against thieves.
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed))
+        result = nullptr;
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  /// Removes the element at the top of the deque. Returns `nullptr` if the
+  /// deque is empty or if another thread won the race for the top element.
+  /// Safe to call from any thread.
+  pointer steal() {
+    auto t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = bottom_.load(std::memory_order_acquire);
+    if (t >= b)
+      return nullptr;
+    auto buf = buf_.load(std::memory_order_acquire);
+    auto result = buf->load(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return nullptr;
+    return result;
+  }
+
+  /// Returns whether the deque appears empty. The result is only a snapshot
+  /// when other threads access the deque concurrently.
+  bool empty() const noexcept {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+  /// Returns the approximate number of elements in the deque.
+  size_t size() const noexcept {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0u;
+  }
+
+  /// Returns the current capacity of the deque.
+  size_t capacity() const noexcept {
+    return buf_.load(std::memory_order_relaxed)->mask + 1;
+  }
+
+private:
+  // Circular array with power-of-two capacity.
+  struct buffer {
+    explicit buffer(size_t capacity)
+      : mask(capacity - 1), slots(new std::atomic<pointer>[capacity]) {
+      // nop
+    }
+
+    pointer load(int64_t pos) const noexcept {
+      return slots[static_cast<size_t>(pos) & mask].load(
+        std::memory_order_relaxed);
+    }
+
+    void store(int64_t pos, pointer x) noexcept {
+      slots[static_cast<size_t>(pos) & mask].store(x,
+                                                   std::memory_order_relaxed);
+    }
+
+    size_t mask;
+    std::unique_ptr<std::atomic<pointer>[]> slots;
+  };
+
+  buffer* grow(buffer* old, int64_t t, int64_t b) {
+    retired_.emplace_back(new buffer((old->mask + 1) * 2));
+    auto result = retired_.back().get();
+    for (auto i = t; i != b; ++i)
+      result->store(i, old->load(i));
+    buf_.store(result, std::memory_order_release);
+    return result;
+  }
+
+  // Read by thieves and modified by CAS from any thread.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<int64_t> top_;
+
+  // Only modified by the owner.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<int64_t> bottom_;
+
+  // Points to the current buffer.
+  std::atomic<buffer*> buf_;
+
+  // Owns the current buffer and all buffers used previously.
+  std::vector<std::unique_ptr<buffer>> retired_;
+};
+
+} // namespace caf::detail
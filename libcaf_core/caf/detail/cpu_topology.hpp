@@ -0,0 +1,93 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::detail {
+
+/// Describes the CPUs available to this process, grouped by NUMA node and by
+/// last-level cache (LLC). CPUs sharing an LLC form a *core complex*.
+class CAF_CORE_EXPORT cpu_topology {
+public:
+  /// Locality levels for work stealing, ordered from near to far.
+  enum level : size_t {
+    same_cache,
+    same_node,
+    remote,
+    num_levels,
+  };
+
+  /// Describes a single logical CPU.
+  struct cpu_info {
+    /// Index of the CPU as used by the operating system.
+    size_t id;
+
+    /// NUMA node of the CPU.
+    size_t node;
+
+    /// Smallest CPU ID sharing the last-level cache with this CPU.
+    size_t cache;
+  };
+
+  /// Lists candidate victims for one worker, grouped by locality level.
+  using victim_groups = std::array<std::vector<size_t>, num_levels>;
+
+  /// Creates a topology from given CPUs.
+  explicit cpu_topology(std::vector<cpu_info> cpus);
+
+  /// Reads the CPU topology of the host from the operating system. Falls back
+  /// to a flat topology with `std::thread::hardware_concurrency()` CPUs on a
+  /// single node if the platform provides no topology information.
+  static cpu_topology discover();
+
+  /// Parses a list of CPU IDs in the Linux format, e.g., `0-3,8,10-11`.
+  static std::vector<size_t> parse_cpu_list(string_view str);
+
+  /// Returns all available CPUs, sorted by node, cache and ID.
+  const std::vector<cpu_info>& cpus() const noexcept {
+    return cpus_;
+  }
+
+  /// Returns the CPU assigned to the worker with ID `worker_id`. Workers fill
+  /// up core complexes and NUMA nodes one by one to keep neighboring workers
+  /// close to each other.
+  const cpu_info& cpu_of(size_t worker_id) const noexcept {
+    return cpus_[worker_id % cpus_.size()];
+  }
+
+  /// Computes the victims for each of `num_workers` workers, assuming each
+  /// worker runs on the CPU returned by `cpu_of`.
+  std::vector<victim_groups> make_victim_groups(size_t num_workers) const;
+
+private:
+  std::vector<cpu_info> cpus_;
+};
+
+/// Restricts `thread` to run only on the CPU with given ID. Returns `false`
+/// if the platform does not support thread pinning or the call failed.
+CAF_CORE_EXPORT bool pin_thread(std::thread& thread, size_t cpu_id);
+
+} // namespace caf::detail
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "caf/config.hpp"
+#include "caf/detail/core_export.hpp"
+
+#ifndef CAF_LINUX
+#  include <condition_variable>
+#  include <mutex>
+#endif
+
+namespace caf::detail {
+
+/// A synchronization primitive for parking threads until some condition
+/// becomes true, similar to a condition variable without a mutex. Waiting
+/// follows a two-phase protocol:
+///
+/// ~~~
+/// auto key = ec.prepare_wait();
+/// if (condition()) {
+///   ec.cancel_wait();
+///   return;
+/// }
+/// ec.wait(key);
+/// ~~~
+///
+/// Notifiers first make the condition true and then call `notify_one` or
+/// `notify_all`. Notifying is a single fence plus a load when no thread waits.
+/// On Linux, waiting threads block on a futex. Other platforms fall back to a
+/// mutex and a condition variable.
+class CAF_CORE_EXPORT eventcount {
+public:
+  using key_type = uint32_t;
+
+  eventcount() noexcept;
+
+  eventcount(const eventcount&) = delete;
+
+  eventcount& operator=(const eventcount&) = delete;
+
+  /// Announces that the calling thread is about to wait.
+  key_type prepare_wait() noexcept {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+  }
+
+  /// Withdraws a previous call to `prepare_wait`.
+  void cancel_wait() noexcept {
+    waiters_.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  /// Blocks until a notification arrives after the call to `prepare_wait`
+  /// that returned `key`.
+  void wait(key_type key);
+
+  /// Like `wait`, but gives up once `timeout` passes.
+  /// @returns `false` if the timeout passed before a notification arrived,
+  ///          `true` otherwise.
+  bool wait_until(key_type key, std::chrono::steady_clock::time_point timeout);
+
+  /// Wakes up one waiting thread, if any.
+  void notify_one() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) != 0)
+      do_notify(false);
+  }
+
+  /// Wakes up all waiting threads.
+  void notify_all() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) != 0)
+      do_notify(true);
+  }
+
+  /// Returns the number of threads that called `prepare_wait` without
+  /// returning from `wait` or calling `cancel_wait` yet.
+  uint32_t waiters() const noexcept {
+    return waiters_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void do_notify(bool all) noexcept;
+
+  // Incremented by each notification. Waiting threads block on this value.
+  std::atomic<uint32_t> epoch_;
+
+  // Number of threads in `prepare_wait` or `wait`.
+  std::atomic<uint32_t> waiters_;
+
+#ifndef CAF_LINUX
+  // Guards `cv_`.
+  std::mutex mtx_;
+
+  // Signals changes to `epoch_`.
+  std::condition_variable cv_;
+#endif
+};
+
+} // namespace caf::detail
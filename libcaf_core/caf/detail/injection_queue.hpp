@@ -0,0 +1,170 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "caf/config.hpp"
+
+namespace caf::detail {
+
+/// A queue for transferring pointers from any number of producers to a
+/// worker. The fast path uses a bounded, lock-free ring buffer as described by
+/// Dmitry Vyukov ("Bounded MPMC queue", 1024cores.net) and thus never
+/// allocates. Pushing to a full ring spills into a mutex-protected overflow
+/// list instead of blocking the producer. Consumers also synchronize via CAS,
+/// which allows other workers to steal from an injection queue.
+/// @note Elements retain FIFO order as long as the ring never overflows.
+template <class T>
+class injection_queue {
+public:
+  using value_type = T;
+
+  using pointer = value_type*;
+
+  explicit injection_queue(size_t capacity = 1024)
+    : head_(0), tail_(0), overflow_size_(0) {
+    size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    mask_ = n - 1;
+    cells_.reset(new cell[n]);
+    for (size_t i = 0; i < n; ++i)
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  injection_queue(const injection_queue&) = delete;
+
+  injection_queue& operator=(const injection_queue&) = delete;
+
+  /// Appends `x` to the queue. Safe to call from any thread.
+  void push(pointer x) {
+    CAF_ASSERT(x != nullptr);
+    if (!try_push(x)) {
+      std::unique_lock<std::mutex> guard{overflow_mtx_};
+      overflow_.push_back(x);
+      overflow_size_.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  /// Tries to append `x` to the ring buffer without touching the overflow
+  /// list. Returns `false` if the ring buffer is full.
+  bool try_push(pointer x) {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& c = cells_[pos & mask_];
+      auto seq = c.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          c.value = x;
+          c.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Removes the oldest element from the queue or returns `nullptr` if the
+  /// queue is empty. Safe to call from any thread.
+  pointer pop() {
+    auto pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& c = cells_[pos & mask_];
+      auto seq = c.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          auto result = c.value;
+          c.seq.store(pos + mask_ + 1, std::memory_order_release);
+          return result;
+        }
+      } else if (diff < 0) {
+        return pop_overflow();
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Returns whether the queue appears empty. The result is only a snapshot
+  /// when other threads access the queue concurrently.
+  bool empty() const noexcept {
+    return head_.load(std::memory_order_acquire)
+             == tail_.load(std::memory_order_acquire)
+           && overflow_size_.load(std::memory_order_acquire) == 0;
+  }
+
+  /// Returns the capacity of the ring buffer.
+  size_t capacity() const noexcept {
+    return mask_ + 1;
+  }
+
+private:
+  pointer pop_overflow() {
+    if (overflow_size_.load(std::memory_order_acquire) == 0)
+      return nullptr;
+    std::unique_lock<std::mutex> guard{overflow_mtx_};
+    if (overflow_.empty())
+      return nullptr;
+    auto result = overflow_.front();
+    overflow_.pop_front();
+    overflow_size_.fetch_sub(1, std::memory_order_release);
+    return result;
+  }
+
+  struct cell {
+    std::atomic<size_t> seq;
+    pointer value;
+  };
+
+  // Read position of consumers.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<size_t> head_;
+
+  // Write position of producers.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<size_t> tail_;
+
+  // Number of elements in `overflow_`, allows consumers to skip the lock.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<size_t> overflow_size_;
+
+  // Capacity of the ring minus one.
+  size_t mask_;
+
+  // Stores elements in a circular buffer.
+  std::unique_ptr<cell[]> cells_;
+
+  // Guards `overflow_`.
+  std::mutex overflow_mtx_;
+
+  // Stores elements that did not fit into the ring.
+  std::deque<pointer> overflow_;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,153 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "caf/deep_to_string.hpp"
+#include "caf/detail/arg_wrapper.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/fwd.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::detail {
+
+/// Identifies the kind of an argument in a binary-encoded log message.
+enum class log_arg_tag : uint8_t {
+  /// A string that gets separated from its predecessor by a space unless the
+  /// predecessor already ends with one.
+  text,
+  /// A string produced by `deep_to_string`.
+  value,
+  /// A signed integer in zigzag varint encoding.
+  signed_integer,
+  /// An unsigned integer in varint encoding.
+  unsigned_integer,
+  /// A `double` in native byte order.
+  floating_point,
+  /// A single byte with value 0 or 1.
+  boolean,
+  /// Renders as `<name> = ` in front of the next argument (see `CAF_ARG`).
+  name,
+};
+
+/// Stores the arguments of a log statement in binary encoding.
+struct encoded_log_args {
+  std::string bytes;
+};
+
+/// Encodes the arguments of a log statement into a compact binary format that
+/// the logger renders to text later. Numbers, booleans and strings get stored
+/// as raw bytes. All other types still get converted via `deep_to_string` on
+/// the calling thread, because the logger cannot access them safely later.
+/// Renders to the same text as `logger::line_builder`.
+class CAF_CORE_EXPORT log_arg_encoder {
+public:
+  log_arg_encoder() = default;
+
+  template <class T>
+  std::enable_if_t<!std::is_pointer<T>::value, log_arg_encoder&>
+  operator<<(const T& x) {
+    if constexpr (is_primitive<T>::value) {
+      put(x);
+    } else if constexpr (is_single_arg_wrapper<T>::value) {
+      put_str(log_arg_tag::name, string_view{x.name, strlen(x.name)});
+      if constexpr (is_primitive<std::decay_t<decltype(x.value)>>::value)
+        put(x.value);
+      else
+        put_str(log_arg_tag::value, deep_to_string(x.value));
+    } else {
+      put_str(log_arg_tag::value, deep_to_string(x));
+    }
+    return *this;
+  }
+
+  log_arg_encoder& operator<<(const local_actor* self);
+
+  log_arg_encoder& operator<<(const std::string& str);
+
+  log_arg_encoder& operator<<(string_view str);
+
+  log_arg_encoder& operator<<(const char* str);
+
+  log_arg_encoder& operator<<(char x);
+
+  encoded_log_args get() {
+    return {std::move(buf_)};
+  }
+
+private:
+  template <class T>
+  struct is_primitive
+    : std::integral_constant<bool, std::is_arithmetic<T>::value
+                                     && !std::is_same<T, char>::value> {};
+
+  template <class T>
+  struct is_single_arg_wrapper : std::false_type {};
+
+  template <class T>
+  struct is_single_arg_wrapper<single_arg_wrapper<T>> : std::true_type {};
+
+  template <class T>
+  void put(T x) {
+    if constexpr (std::is_same<T, bool>::value) {
+      put_tag(log_arg_tag::boolean);
+      buf_ += static_cast<char>(x ? 1 : 0);
+    } else if constexpr (std::is_floating_point<T>::value) {
+      put_tag(log_arg_tag::floating_point);
+      auto y = static_cast<double>(x);
+      char tmp[sizeof(double)];
+      memcpy(tmp, &y, sizeof(double));
+      buf_.append(tmp, sizeof(double));
+    } else if constexpr (std::is_signed<T>::value) {
+      put_tag(log_arg_tag::signed_integer);
+      auto y = static_cast<int64_t>(x);
+      auto zigzag = static_cast<uint64_t>(y) << 1;
+      put_varint(y < 0 ? ~zigzag : zigzag);
+    } else {
+      put_tag(log_arg_tag::unsigned_integer);
+      put_varint(static_cast<uint64_t>(x));
+    }
+  }
+
+  void put_tag(log_arg_tag x) {
+    buf_ += static_cast<char>(x);
+  }
+
+  void put_varint(uint64_t x);
+
+  void put_str(log_arg_tag tag, string_view str);
+
+  std::string buf_;
+};
+
+/// Renders binary-encoded log arguments to human-readable text.
+/// @relates log_arg_encoder
+CAF_CORE_EXPORT std::string render_log_args(string_view encoded);
+
+/// Reads a varint from `encoded`, starting at `pos`.
+/// @returns `false` if `encoded` ends prematurely.
+/// @relates log_arg_encoder
+CAF_CORE_EXPORT bool read_log_varint(string_view encoded, size_t& pos,
+                                     uint64_t& x);
+
+} // namespace caf::detail
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/fwd.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::detail {
+
+/// Interns the name of a log component to an integer ID by computing its
+/// 64-bit FNV-1a hash. Evaluates at compile time for string literals.
+constexpr uint64_t log_component_id(string_view name) noexcept {
+  uint64_t result = 14695981039346656037u;
+  for (auto c : name) {
+    result ^= static_cast<uint8_t>(c);
+    result *= 1099511628211u;
+  }
+  return result;
+}
+
+/// Stores the static state of a single log statement. Each expansion of
+/// `CAF_LOG_IMPL` owns one instance with static storage duration. A site
+/// caches whether any active logger accepts its events. Hence, disabled sites
+/// only cost a single branch on a relaxed load. Sites evaluate their flag
+/// lazily and start over whenever the set of active loggers changes.
+class CAF_CORE_EXPORT log_site {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  constexpr log_site(unsigned level, uint64_t component) noexcept
+    : level_(level),
+      component_(component),
+      state_(unknown_state),
+      registered_(false),
+      next_(nullptr) {
+    // nop
+  }
+
+  log_site(const log_site&) = delete;
+
+  log_site& operator=(const log_site&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns whether any active logger accepts events from this site.
+  bool enabled() noexcept {
+    auto state = state_.load(std::memory_order_relaxed);
+    if (state == disabled_state)
+      return false;
+    return state == enabled_state || evaluate();
+  }
+
+  /// Returns the log level of this site.
+  unsigned level() const noexcept {
+    return level_;
+  }
+
+  /// Returns the interned name of the component of this site.
+  uint64_t component_id() const noexcept {
+    return component_;
+  }
+
+  // -- logger registration ----------------------------------------------------
+
+  /// Adds `ptr` to the set of active loggers and resets all sites.
+  static void add_logger(const logger* ptr);
+
+  /// Removes `ptr` from the set of active loggers and resets all sites.
+  static void remove_logger(const logger* ptr);
+
+private:
+  static constexpr uint8_t unknown_state = 0;
+
+  static constexpr uint8_t disabled_state = 1;
+
+  static constexpr uint8_t enabled_state = 2;
+
+  /// Computes the flag for this site and registers it on first use.
+  bool evaluate();
+
+  unsigned level_;
+
+  uint64_t component_;
+
+  std::atomic<uint8_t> state_;
+
+  // Guarded by the mutex of the site registry.
+  bool registered_;
+
+  // Guarded by the mutex of the site registry.
+  log_site* next_;
+};
+
+} // namespace caf::detail
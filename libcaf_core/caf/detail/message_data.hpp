@@ -24,6 +24,7 @@
 
 #include "caf/config.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/message_pool.hpp"
 #include "caf/detail/type_list.hpp"
 #include "caf/fwd.hpp"
 #include "caf/intrusive_cow_ptr.hpp"
@@ -47,6 +48,16 @@ public:
 
   ~message_data() override;
 
+#ifndef CAF_NO_MEM_MANAGEMENT
+  static void* operator new(size_t size) {
+    return message_pool::allocate(size);
+  }
+
+  static void operator delete(void* ptr, size_t size) noexcept {
+    message_pool::deallocate(ptr, size);
+  }
+#endif // CAF_NO_MEM_MANAGEMENT
+
   // -- pure virtual observers -------------------------------------------------
 
   virtual message_data* copy() const = 0;
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include "caf/detail/core_export.hpp"
+
+namespace caf::detail {
+
+/// Recycles memory for small, short-lived objects such as mailbox elements and
+/// message contents. Each thread caches free blocks in a set of size classes.
+/// Threads that free more blocks than they allocate, e.g., receivers in a
+/// fan-in setup, return surplus blocks in batches to a global depot, from
+/// which allocating threads refill their caches. Hence, sending a message in a
+/// steady state neither calls `malloc` nor `free`, while synchronizing across
+/// threads only once per batch.
+///
+/// Pooling is a process-wide setting that can be turned on or off at any time.
+/// Blocks allocated while pooling is off are compatible with the pool and vice
+/// versa. Since messages travel freely between actor systems in the same
+/// process, actor systems do not have a pool of their own. Instead, the first
+/// actor system in the process configures the pool via `configure`.
+class CAF_CORE_EXPORT message_pool {
+public:
+  /// Distance between two size classes.
+  static constexpr size_t granularity = 64;
+
+  /// Number of size classes.
+  static constexpr size_t num_size_classes = 8;
+
+  /// Size of the largest pooled block. Larger allocations bypass the pool.
+  static constexpr size_t max_block_size = granularity * num_size_classes;
+
+  /// Number of blocks the threads move to and from the depot at once.
+  static constexpr size_t batch_size = 64;
+
+  /// Allocates memory for an object of `size` bytes.
+  static void* allocate(size_t size);
+
+  /// Returns the memory of an object of `size` bytes to the pool.
+  static void deallocate(void* ptr, size_t size) noexcept;
+
+  /// Enables or disables pooling for the entire process.
+  static void enable(bool flag) noexcept;
+
+  /// Enables or disables pooling for the entire process unless a previous call
+  /// to `configure` already did so.
+  /// @returns `true` if this call configured the pool, `false` otherwise.
+  static bool configure(bool flag) noexcept;
+
+  /// Returns whether pooling is active.
+  static bool enabled() noexcept;
+
+  /// Returns the number of blocks in the cache of the calling thread for
+  /// objects of `size` bytes.
+  static size_t cached_blocks(size_t size) noexcept;
+
+  /// Returns the number of blocks that CAF allocated from the heap for the
+  /// size class of `size` bytes.
+  static size_t heap_allocations(size_t size) noexcept;
+};
+
+} // namespace caf::detail
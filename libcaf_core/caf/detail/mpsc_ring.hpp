@@ -0,0 +1,250 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "caf/config.hpp"
+#include "caf/detail/eventcount.hpp"
+
+namespace caf::detail {
+
+/// A bounded, lock-free ring buffer for transferring values from any number of
+/// producers to a single consumer. Each cell carries a sequence number as
+/// described by Dmitry Vyukov ("Bounded MPMC queue", 1024cores.net), which
+/// tells producers and the consumer whether the cell is free or holds a
+/// published element. Producers only block while the ring is full and the
+/// consumer only blocks while the ring is empty. Both sides park on an
+/// `eventcount`, so notifying a running thread costs a fence plus a load.
+template <class T>
+class mpsc_ring {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a ring without any storage.
+  /// @post `capacity() == 0`
+  /// @warning Users must call `resize` before accessing the ring.
+  mpsc_ring() noexcept : head_(0), tail_(0), mask_(0) {
+    // nop
+  }
+
+  /// Creates a ring that holds at least `capacity` elements. The capacity is
+  /// rounded up to the next power of two.
+  explicit mpsc_ring(size_t capacity) {
+    init(capacity);
+  }
+
+  mpsc_ring(const mpsc_ring&) = delete;
+
+  mpsc_ring& operator=(const mpsc_ring&) = delete;
+
+  ~mpsc_ring() {
+    clear();
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the maximum number of elements in the ring.
+  size_t capacity() const noexcept {
+    return cells_ ? mask_ + 1 : 0;
+  }
+
+  /// Queries whether the consumer would find no element in the ring.
+  /// @warning Only the consumer may call this member function.
+  bool empty() const noexcept {
+    auto pos = head_.load(std::memory_order_relaxed);
+    auto& c = cells_[pos & mask_];
+    return c.seq.load(std::memory_order_acquire) != pos + 1;
+  }
+
+  /// Returns the approximate number of elements in the ring.
+  size_t size() const noexcept {
+    auto wr = tail_.load(std::memory_order_relaxed);
+    auto rd = head_.load(std::memory_order_relaxed);
+    return wr > rd ? wr - rd : 0;
+  }
+
+  // -- producer interface -----------------------------------------------------
+
+  /// Tries to append `x` to the ring without blocking.
+  /// @returns `false` if the ring is full, in which case `x` remains unchanged.
+  bool try_push(T&& x) {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& c = cells_[pos & mask_];
+      auto seq = c.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          new (c.storage()) T(std::move(x));
+          c.seq.store(pos + 1, std::memory_order_release);
+          non_empty_.notify_one();
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Appends `x` to the ring, blocking while the ring is full.
+  void push(T&& x) {
+    while (!try_push(std::move(x))) {
+      auto key = non_full_.prepare_wait();
+      if (try_push(std::move(x))) {
+        non_full_.cancel_wait();
+        return;
+      }
+      non_full_.wait(key);
+    }
+  }
+
+  // -- consumer interface -----------------------------------------------------
+
+  /// Blocks until the ring contains at least one element.
+  void wait_nonempty() {
+    if (!empty())
+      return;
+    auto key = non_empty_.prepare_wait();
+    if (!empty()) {
+      non_empty_.cancel_wait();
+      return;
+    }
+    non_empty_.wait(key);
+  }
+
+  /// Returns the oldest element in the ring.
+  /// @pre `!empty()`
+  T& front() noexcept {
+    auto pos = head_.load(std::memory_order_relaxed);
+    return *cells_[pos & mask_].value();
+  }
+
+  /// Removes the oldest element from the ring.
+  /// @pre `!empty()`
+  void pop_front() {
+    auto pos = head_.load(std::memory_order_relaxed);
+    release(pos);
+    head_.store(pos + 1, std::memory_order_relaxed);
+    non_full_.notify_all();
+  }
+
+  /// Removes up to `max_items` elements from the ring and passes them to `f`
+  /// in FIFO order. Wakes up blocked producers only once per batch.
+  /// @returns the number of consumed elements.
+  template <class F>
+  size_t consume(F f, size_t max_items = static_cast<size_t>(-1)) {
+    auto pos = head_.load(std::memory_order_relaxed);
+    size_t n = 0;
+    for (; n < max_items; ++n) {
+      auto& c = cells_[pos & mask_];
+      if (c.seq.load(std::memory_order_acquire) != pos + 1)
+        break;
+      f(*c.value());
+      release(pos++);
+    }
+    if (n > 0) {
+      head_.store(pos, std::memory_order_relaxed);
+      non_full_.notify_all();
+    }
+    return n;
+  }
+
+  /// Reallocates the ring for holding at least `capacity` elements. Keeps all
+  /// elements currently stored in the ring, growing the capacity if needed.
+  /// @pre No other thread accesses the ring concurrently.
+  void resize(size_t capacity) {
+    std::vector<T> xs;
+    if (cells_) {
+      xs.reserve(size());
+      consume([&](T& x) { xs.emplace_back(std::move(x)); });
+    }
+    init(std::max(capacity, xs.size()));
+    for (auto& x : xs)
+      try_push(std::move(x));
+  }
+
+private:
+  struct cell {
+    std::atomic<size_t> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+
+    void* storage() noexcept {
+      return &buf;
+    }
+
+    T* value() noexcept {
+      return std::launder(reinterpret_cast<T*>(&buf));
+    }
+  };
+
+  void init(size_t capacity) {
+    size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    cells_.reset(new cell[n]);
+    for (size_t i = 0; i < n; ++i)
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+    mask_ = n - 1;
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+  }
+
+  void clear() {
+    if (cells_)
+      consume([](T&) {});
+  }
+
+  // Destroys the element at `pos` and hands its cell back to the producers.
+  void release(size_t pos) {
+    auto& c = cells_[pos & mask_];
+    c.value()->~T();
+    c.seq.store(pos + mask_ + 1, std::memory_order_release);
+  }
+
+  // Read position of the consumer.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<size_t> head_;
+
+  // Write position of producers.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<size_t> tail_;
+
+  // Capacity of the ring minus one.
+  size_t mask_;
+
+  // Stores elements in a circular buffer.
+  std::unique_ptr<cell[]> cells_;
+
+  // Signals the consumer that the ring became non-empty.
+  eventcount non_empty_;
+
+  // Signals producers that the ring became non-full.
+  eventcount non_full_;
+};
+
+} // namespace caf::detail
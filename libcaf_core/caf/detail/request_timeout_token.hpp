@@ -0,0 +1,53 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include "caf/intrusive_ptr.hpp"
+#include "caf/ref_counted.hpp"
+
+namespace caf::detail {
+
+/// Shared state between an actor and the clock for lazily cancelling a
+/// request timeout. Instead of sending a cancellation to the clock, the actor
+/// marks the token once the response arrives and the clock drops the timeout
+/// when it fires.
+class request_timeout_token : public ref_counted {
+public:
+  /// Marks the request as answered.
+  void mark_answered() noexcept {
+    // Relaxed ordering suffices: the flag publishes no other data and the
+    // actor drops timeouts without matching response handler anyway.
+    answered_.store(true, std::memory_order_relaxed);
+  }
+
+  /// Queries whether the actor received a response for the request.
+  bool answered() const noexcept {
+    return answered_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<bool> answered_{false};
+};
+
+/// @relates request_timeout_token
+using request_timeout_token_ptr = intrusive_ptr<request_timeout_token>;
+
+} // namespace caf::detail
@@ -26,6 +26,7 @@
 #include "caf/actor_control_block.hpp"
 #include "caf/detail/core_export.hpp"
 #include "caf/detail/make_unique.hpp"
+#include "caf/detail/timing_wheel.hpp"
 #include "caf/group.hpp"
 #include "caf/mailbox_element.hpp"
 #include "caf/message.hpp"
@@ -79,10 +80,13 @@ public:
 
     /// Identifies the actual type of this object.
     event_type subtype;
+
+    /// Intrusive pointer for queueing events.
+    event* next = nullptr;
   };
 
   /// An event with a timeout attached to it.
-  struct delayed_event : event {
+  struct delayed_event : event, timing_wheel_node {
     delayed_event(event_type type, time_point due) : event(type), due(due) {
       // nop
     }
@@ -92,6 +96,12 @@ public:
 
     /// Links back to the actor lookup map.
     actor_lookup_map::iterator backlink;
+
+    /// Points to the previous pending event of the same actor.
+    delayed_event* actor_prev = nullptr;
+
+    /// Points to the next pending event of the same actor.
+    delayed_event* actor_next = nullptr;
   };
 
   /// An ordinary timeout event for actors. Only one timeout for any timeout
@@ -137,15 +147,20 @@ public:
   struct request_timeout final : delayed_event {
     static constexpr bool cancellable = true;
 
-    request_timeout(time_point due, strong_actor_ptr self, message_id id)
+    request_timeout(time_point due, strong_actor_ptr self, message_id id,
+                    request_timeout_token_ptr token = nullptr)
       : delayed_event(request_timeout_type, due),
         self(std::move(self)),
-        id(id) {
+        id(id),
+        token(std::move(token)) {
       // nop
     }
 
     strong_actor_ptr self;
     message_id id;
+
+    /// Allows the actor to cancel this timeout without notifying the clock.
+    request_timeout_token_ptr token;
   };
 
   /// A delayed ::message to an actor.
@@ -283,8 +298,8 @@ public:
   void set_multi_timeout(time_point t, abstract_actor* self, std::string type,
                          uint64_t id) override;
 
-  void set_request_timeout(time_point t, abstract_actor* self,
-                           message_id id) override;
+  void set_request_timeout(time_point t, abstract_actor* self, message_id id,
+                           request_timeout_token_ptr token) override;
 
   void cancel_ordinary_timeout(abstract_actor* self, std::string type) override;
 
@@ -20,35 +20,52 @@
 
 #include <array>
 #include <atomic>
-#include <condition_variable>
-#include <memory>
-#include <mutex>
+#include <chrono>
 #include <string>
+#include <unordered_map>
 
 #include "caf/abstract_actor.hpp"
+#include "caf/config.hpp"
 #include "caf/detail/core_export.hpp"
-#include "caf/detail/ringbuffer.hpp"
+#include "caf/detail/eventcount.hpp"
+#include "caf/detail/fnv_hash.hpp"
 #include "caf/detail/simple_actor_clock.hpp"
+#include "caf/detail/timing_wheel.hpp"
 
 namespace caf::detail {
 
+/// An actor clock that runs in its own thread. Other threads submit events via
+/// lock-free queues. The clock thread stores pending events in a
+/// ::timing_wheel instead of the ordered maps of the `simple_actor_clock`.
 class CAF_CORE_EXPORT thread_safe_actor_clock : public simple_actor_clock {
 public:
   // -- constants --------------------------------------------------------------
 
-  static constexpr size_t buffer_size = 64;
+  /// Number of submission queues. Producers select a queue based on the actor
+  /// ID, i.e., all events for the same actor arrive in order.
+  static constexpr size_t num_queues = 16;
+
+  /// Granularity of the timing wheel. Events never trigger early, but may
+  /// trigger up to one tick late.
+  static constexpr duration_type resolution = std::chrono::milliseconds{1};
 
   // -- member types -----------------------------------------------------------
 
   using super = simple_actor_clock;
 
+  // -- constructors, destructors, and assignment operators --------------------
+
+  thread_safe_actor_clock();
+
+  ~thread_safe_actor_clock() override;
+
   // -- member functions -------------------------------------------------------
 
   void set_ordinary_timeout(time_point t, abstract_actor* self,
                             std::string type, uint64_t id) override;
 
-  void set_request_timeout(time_point t, abstract_actor* self,
-                           message_id id) override;
+  void set_request_timeout(time_point t, abstract_actor* self, message_id id,
+                           request_timeout_token_ptr token) override;
 
   void set_multi_timeout(time_point t, abstract_actor* self, std::string type,
                          uint64_t id) override;
@@ -72,13 +89,75 @@ public:
   void cancel_dispatch_loop();
 
 private:
-  void push(event* ptr);
+  // -- member types -----------------------------------------------------------
+
+  /// Head of an intrusive, lock-free stack of events.
+  struct alignas(CAF_CACHE_LINE_SIZE) submission_queue {
+    std::atomic<event*> head{nullptr};
+  };
+
+  /// Intrusive list of all cancellable events for one actor. Ordinary
+  /// timeouts are at the front of the list.
+  struct actor_timers {
+    delayed_event* first = nullptr;
+    delayed_event* last = nullptr;
+  };
+
+  /// Identifies a request timeout.
+  using request_key = std::pair<actor_id, uint64_t>;
+
+  struct request_key_hash {
+    size_t operator()(const request_key& x) const noexcept {
+      // Actor and request IDs are both small, increasing counters. Mixing
+      // them arithmetically would map many pairs to the same value.
+      return fnv_hash_append(fnv_hash(x.first), x.second);
+    }
+  };
+
+  // -- utility functions ------------------------------------------------------
+
+  static uint64_t to_tick(time_point t, bool round_up) noexcept;
+
+  static time_point from_tick(uint64_t tick) noexcept;
+
+  void push(actor_id key, event* ptr);
+
+  /// Handles all events in the submission queues.
+  /// @returns `false` after receiving a `shutdown` event, `true` otherwise.
+  bool drain();
+
+  bool handle(unique_event_ptr x);
+
+  void add(delayed_event* x);
+
+  void link(actor_id aid, delayed_event* x, bool front);
+
+  void unlink(delayed_event* x);
+
+  /// Removes `x` from all data structures and deletes it.
+  void erase(delayed_event* x);
+
+  void trigger(delayed_event* x);
+
+  void clear();
+
+  // -- member variables -------------------------------------------------------
 
   /// Receives timer events from other threads.
-  detail::ringbuffer<unique_event_ptr, buffer_size> queue_;
+  std::array<submission_queue, num_queues> queues_;
+
+  /// Wakes up the clock thread when new events arrive.
+  eventcount ready_;
+
+  /// Stores pending events, ordered by their due time.
+  timing_wheel wheel_;
+
+  /// Maps actor IDs to their pending events.
+  std::unordered_map<actor_id, actor_timers> actors_;
 
-  /// Locally caches events for processing.
-  std::array<unique_event_ptr, buffer_size> events_;
+  /// Maps request IDs to their pending timeout.
+  std::unordered_map<request_key, request_timeout*, request_key_hash>
+    requests_;
 };
 
 } // namespace caf::detail
@@ -0,0 +1,207 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/optional.hpp"
+
+namespace caf::detail {
+
+/// Intrusive hook for elements of a ::timing_wheel.
+struct timing_wheel_node {
+  /// Stores the tick at which this node expires.
+  uint64_t wheel_tick = 0;
+
+  /// Stores the position of this node in the wheel.
+  size_t wheel_slot = static_cast<size_t>(-1);
+
+  /// Points to the previous node in the same slot.
+  timing_wheel_node* wheel_prev = nullptr;
+
+  /// Points to the next node in the same slot.
+  timing_wheel_node* wheel_next = nullptr;
+};
+
+/// A hierarchical timing wheel as described by Varghese and Lauck ("Hashed and
+/// Hierarchical Timing Wheels", 1987) that stores intrusive nodes. Each level
+/// consists of 64 slots and each slot on level `n` covers `64^n` ticks. Nodes
+/// enter the lowest level that can distinguish their tick from the current
+/// tick and cascade down one level at a time while the wheel advances.
+/// Inserting and erasing nodes runs in constant time and never allocates.
+/// Advancing the wheel only visits occupied slots, because each level keeps a
+/// bitmap of its non-empty slots.
+/// @note Nodes with the same tick expire in insertion order.
+class CAF_CORE_EXPORT timing_wheel {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Number of bits for addressing a slot on one level.
+  static constexpr size_t slot_bits = 6;
+
+  /// Number of slots per level.
+  static constexpr size_t num_slots = size_t{1} << slot_bits;
+
+  /// Number of levels in the wheel.
+  static constexpr size_t num_levels = 6;
+
+  /// Number of ticks the wheel covers. Nodes that expire later wait on the
+  /// highest level until they are in range.
+  static constexpr uint64_t max_ticks = uint64_t{1}
+                                        << (slot_bits * num_levels);
+
+  /// Position of nodes that already expired but did not run yet.
+  static constexpr size_t expired_slot = num_levels * num_slots;
+
+  /// Position of nodes outside of the wheel.
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  explicit timing_wheel(uint64_t now = 0) noexcept;
+
+  timing_wheel(const timing_wheel&) = delete;
+
+  timing_wheel& operator=(const timing_wheel&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the tick the wheel advanced to last.
+  uint64_t now() const noexcept {
+    return elapsed_;
+  }
+
+  /// Returns the number of nodes in the wheel.
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Returns whether the wheel contains no nodes.
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  /// Returns whether `x` is stored in a wheel.
+  static bool linked(const timing_wheel_node* x) noexcept {
+    return x->wheel_slot != npos;
+  }
+
+  /// Returns the tick at which the wheel needs to advance next or `none` if
+  /// the wheel is empty. The result may lie before the earliest tick of any
+  /// node when the wheel merely needs to cascade nodes to a lower level.
+  optional<uint64_t> next_expiration() const noexcept;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Adds `x` to the wheel. The node expires once the wheel advances to
+  /// `tick` or later.
+  /// @pre `!linked(x)`
+  void insert(timing_wheel_node* x, uint64_t tick) noexcept;
+
+  /// Removes `x` from the wheel.
+  /// @pre `linked(x)`
+  void erase(timing_wheel_node* x) noexcept;
+
+  /// Advances the wheel to `now` and calls `f` for each expired node after
+  /// removing it from the wheel. The callback may insert new nodes.
+  /// @returns The number of expired nodes.
+  template <class F>
+  size_t advance(uint64_t now, F f) {
+    size_t result = 0;
+    do {
+      while (auto x = pop_expired()) {
+        f(x);
+        ++result;
+      }
+    } while (cascade(now));
+    if (now > elapsed_)
+      elapsed_ = now;
+    return result;
+  }
+
+  /// Removes all nodes from the wheel and calls `f` for each one.
+  template <class F>
+  void clear(F f) {
+    for (size_t i = 0; i <= expired_slot; ++i) {
+      auto x = slots_[i].head;
+      slots_[i] = slot{};
+      while (x != nullptr) {
+        auto next = x->wheel_next;
+        reset(x);
+        f(x);
+        x = next;
+      }
+    }
+    occupied_.fill(0);
+    size_ = 0;
+  }
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  struct slot {
+    timing_wheel_node* head = nullptr;
+    timing_wheel_node* tail = nullptr;
+  };
+
+  // -- utility functions ------------------------------------------------------
+
+  static void reset(timing_wheel_node* x) noexcept {
+    x->wheel_slot = npos;
+    x->wheel_prev = nullptr;
+    x->wheel_next = nullptr;
+  }
+
+  /// Computes the slot for `x` relative to the current tick.
+  size_t slot_of(const timing_wheel_node* x) const noexcept;
+
+  /// Computes the tick at which the wheel must visit the next occupied slot
+  /// on `level`.
+  uint64_t deadline(size_t level) const noexcept;
+
+  void link(timing_wheel_node* x, size_t pos) noexcept;
+
+  void unlink(timing_wheel_node* x) noexcept;
+
+  timing_wheel_node* pop_expired() noexcept;
+
+  /// Moves all nodes of the next slot to lower levels if the wheel must visit
+  /// that slot at or before `now`.
+  /// @returns `true` if the wheel visited a slot, `false` otherwise.
+  bool cascade(uint64_t now) noexcept;
+
+  // -- member variables -------------------------------------------------------
+
+  /// Stores the tick the wheel advanced to last.
+  uint64_t elapsed_;
+
+  /// Stores the number of nodes in the wheel.
+  size_t size_;
+
+  /// Stores one bit per slot that signals whether the slot has any nodes.
+  std::array<uint64_t, num_levels> occupied_;
+
+  /// Stores the lists of all levels, followed by the list of expired nodes.
+  std::array<slot, expired_slot + 1> slots_;
+};
+
+} // namespace caf::detail
@@ -119,6 +119,7 @@ class ipv6_address;
 class ipv6_endpoint;
 class ipv6_subnet;
 class local_actor;
+class logger;
 class mailbox_element;
 class message;
 class message_builder;
@@ -272,6 +273,7 @@ class stream_distribution_tree;
 
 class abstract_worker;
 class abstract_worker_hub;
+class binary_log_writer;
 class disposer;
 class dynamic_message_data;
 class group_manager;
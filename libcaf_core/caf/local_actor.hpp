@@ -23,6 +23,7 @@
 #include <exception>
 #include <functional>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 #include "caf/abstract_actor.hpp"
@@ -35,6 +36,7 @@
 #include "caf/check_typed_input.hpp"
 #include "caf/delegated.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/request_timeout_token.hpp"
 #include "caf/detail/type_traits.hpp"
 #include "caf/detail/typed_actor_util.hpp"
 #include "caf/detail/unique_function.hpp"
@@ -87,6 +89,19 @@ public:
   /// @pre `mid.is_request()`
   void request_response_timeout(timespan d, message_id mid);
 
+  /// Marks the pending request timeout for the response ID `mid` as
+  /// obsolete. Rather than sending a cancellation to the clock, the actor
+  /// only flags the timeout and the clock drops it once it fires.
+  void response_arrived(message_id mid) {
+    if (pending_timeouts_.empty())
+      return;
+    auto i = pending_timeouts_.find(mid);
+    if (i != pending_timeouts_.end()) {
+      i->second->mark_answered();
+      pending_timeouts_.erase(i);
+    }
+  }
+
   // -- spawn functions --------------------------------------------------------
 
   template <class T, spawn_options Os = no_spawn_options, class... Ts>
@@ -411,6 +426,10 @@ protected:
   // last used request ID
   message_id last_request_id_;
 
+  // tokens for lazily cancelling pending request timeouts
+  std::unordered_map<message_id, detail::request_timeout_token_ptr>
+    pending_timeouts_;
+
   /// Factory function for returning initial behavior in function-based actors.
   detail::unique_function<behavior(local_actor*)> initial_behavior_fac_;
 };
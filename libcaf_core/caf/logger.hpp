@@ -21,6 +21,7 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <thread>
 #include <type_traits>
@@ -32,9 +33,11 @@
 #include "caf/deep_to_string.hpp"
 #include "caf/detail/arg_wrapper.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/log_arg_encoder.hpp"
 #include "caf/detail/log_level.hpp"
+#include "caf/detail/log_site.hpp"
+#include "caf/detail/mpsc_ring.hpp"
 #include "caf/detail/pretty_type_name.hpp"
-#include "caf/detail/ringbuffer.hpp"
 #include "caf/detail/scope_guard.hpp"
 #include "caf/detail/shared_spinlock.hpp"
 #include "caf/fwd.hpp"
@@ -71,11 +74,6 @@ public:
 
   friend class actor_system;
 
-  // -- constants --------------------------------------------------------------
-
-  /// Configures the size of the circular event queue.
-  static constexpr size_t queue_size = 128;
-
   // -- member types -----------------------------------------------------------
 
   /// Combines various logging-related flags and parameters into a bitfield.
@@ -97,6 +95,10 @@ public:
     /// Configures whether the logger generates colored output.
     bool console_coloring : 1;
 
+    /// Configures whether the logger writes binary records to its log file
+    /// instead of rendering each event to text.
+    bool binary_output : 1;
+
     config();
   };
 
@@ -118,6 +120,10 @@ public:
           string_view fun, string_view fn, std::string msg, std::thread::id t,
           actor_id a, timestamp ts);
 
+    event(unsigned lvl, unsigned line, string_view cat, string_view full_fun,
+          string_view fun, string_view fn, detail::encoded_log_args args,
+          std::thread::id t, actor_id a, timestamp ts);
+
     // -- member variables -----------------------------------------------------
 
     /// Level/priority of the event.
@@ -141,6 +147,10 @@ public:
     /// User-provided message.
     std::string message;
 
+    /// Stores whether `message` holds the arguments of the log statement in
+    /// the binary format of `detail::log_arg_encoder` instead of plain text.
+    bool encoded = false;
+
     /// Thread ID of the caller.
     std::thread::id tid;
 
@@ -229,7 +239,13 @@ public:
 
   /// Returns whether the logger is configured to accept input for given
   /// component and log level.
-  bool accepts(unsigned level, string_view component_name);
+  bool accepts(unsigned level, string_view component_name) const;
+
+  /// Returns whether the logger is configured to accept input for given
+  /// component and log level.
+  /// @param component_id The interned component name as returned by
+  ///                     `detail::log_component_id`.
+  bool accepts(unsigned level, uint64_t component_id) const;
 
   /// Returns the output format used for the log file.
   const line_format& file_format() const {
@@ -319,7 +335,7 @@ private:
 
   // -- event handling ---------------------------------------------------------
 
-  void handle_event(const event& x);
+  void handle_event(event& x);
 
   void handle_file_event(const event& x);
 
@@ -345,6 +361,9 @@ private:
   // Filters events by component name.
   std::vector<std::string> component_blacklist;
 
+  // Stores the interned names of all components in `component_blacklist`.
+  std::vector<uint64_t> component_blacklist_ids_;
+
   // References the parent system.
   actor_system& system_;
 
@@ -363,8 +382,11 @@ private:
   // Stream for file output.
   std::fstream file_;
 
+  // Writes binary records to `file_` if `cfg_.binary_output` is set.
+  std::unique_ptr<detail::binary_log_writer> binary_writer_;
+
   // Filled with log events by other threads.
-  detail::ringbuffer<event, queue_size> queue_;
+  detail::mpsc_ring<event> queue_;
 
   // Stores the assembled name of the log file.
   std::string file_name_;
@@ -412,7 +434,7 @@ CAF_CORE_EXPORT bool operator==(const logger::field& x, const logger::field& y);
 #define CAF_LOG_MAKE_EVENT(aid, component, loglvl, message)                    \
   ::caf::logger::event(loglvl, __LINE__, component, CAF_PRETTY_FUN, __func__,  \
                        caf::logger::skip_path(__FILE__),                       \
-                       (::caf::logger::line_builder{} << message).get(),       \
+                       (::caf::detail::log_arg_encoder{} << message).get(),    \
                        ::std::this_thread::get_id(), aid,                      \
                        ::caf::make_timestamp())
 
@@ -430,12 +452,17 @@ CAF_CORE_EXPORT bool operator==(const logger::field& x, const logger::field& y);
 
 #define CAF_LOG_IMPL(component, loglvl, message)                               \
   do {                                                                         \
-    auto CAF_UNIFYN(caf_logger) = caf::logger::current_logger();               \
-    if (CAF_UNIFYN(caf_logger) != nullptr                                      \
-        && CAF_UNIFYN(caf_logger)->accepts(loglvl, component))                 \
-      CAF_UNIFYN(caf_logger)                                                   \
-        ->log(CAF_LOG_MAKE_EVENT(CAF_UNIFYN(caf_logger)->thread_local_aid(),   \
-                                 component, loglvl, message));                 \
+    static ::caf::detail::log_site CAF_UNIFYN(caf_log_site){                   \
+      loglvl, ::caf::detail::log_component_id(component)};                    \
+    if (CAF_UNIFYN(caf_log_site).enabled()) {                                  \
+      auto CAF_UNIFYN(caf_logger) = caf::logger::current_logger();             \
+      if (CAF_UNIFYN(caf_logger) != nullptr                                    \
+          && CAF_UNIFYN(caf_logger)->accepts(                                  \
+            loglvl, CAF_UNIFYN(caf_log_site).component_id()))                  \
+        CAF_UNIFYN(caf_logger)                                                 \
+          ->log(CAF_LOG_MAKE_EVENT(CAF_UNIFYN(caf_logger)->thread_local_aid(), \
+                                   component, loglvl, message));               \
+    }                                                                          \
   } while (false)
 
 #define CAF_PUSH_AID(aarg)                                                     \
@@ -25,6 +25,7 @@
 #include "caf/config.hpp"
 #include "caf/detail/core_export.hpp"
 #include "caf/detail/disposer.hpp"
+#include "caf/detail/message_pool.hpp"
 #include "caf/detail/tuple_vals.hpp"
 #include "caf/detail/type_erased_tuple_view.hpp"
 #include "caf/extend.hpp"
@@ -76,6 +77,16 @@ public:
     return mid.category() == message_id::urgent_message_category;
   }
 
+#ifndef CAF_NO_MEM_MANAGEMENT
+  static void* operator new(size_t size) {
+    return detail::message_pool::allocate(size);
+  }
+
+  static void operator delete(void* ptr, size_t size) noexcept {
+    detail::message_pool::deallocate(ptr, size);
+  }
+#endif // CAF_NO_MEM_MANAGEMENT
+
   mailbox_element(mailbox_element&&) = delete;
   mailbox_element(const mailbox_element&) = delete;
   mailbox_element& operator=(mailbox_element&&) = delete;
@@ -116,7 +127,10 @@ typename Inspector::result_type inspect(Inspector& f, mailbox_element& x) {
            x.content());
 }
 
-/// Encapsulates arbitrary data in a message element.
+/// Encapsulates arbitrary data in a message element. The payload lives inline,
+/// i.e., sending a message to a single receiver requires only one allocation.
+/// The element promotes its payload to a shared `message` only when calling
+/// `move_content_to_message` or `copy_content_to_message`.
 template <class... Ts>
 class mailbox_element_vals final
   : public mailbox_element,
@@ -134,28 +148,52 @@ public:
   }
 
   type_erased_tuple& content() override {
+    if (promoted_.vals())
+      return promoted_.content();
     return *this;
   }
 
   const type_erased_tuple& content() const override {
+    if (promoted_.vals())
+      return static_cast<const message&>(promoted_).content();
     return *this;
   }
 
   message move_content_to_message() override {
-    message_factory f;
-    auto& xs = this->data();
-    return detail::apply_moved_args(f, detail::get_indices(xs), xs);
+    return promote();
   }
 
   message copy_content_to_message() const override {
-    message_factory f;
-    auto& xs = this->data();
-    return detail::apply_args(f, detail::get_indices(xs), xs);
+    return promote();
   }
 
   void dispose() noexcept {
     this->deref();
   }
+
+  /// Drops the shared payload created by a previous promotion and redirects
+  /// `content()` back to the inline payload. Owners that reuse an element for
+  /// multiple messages call this before overriding the inline values.
+  void reset_promotion() noexcept {
+    promoted_.reset();
+  }
+
+private:
+  /// Moves the inline payload into a shared `message_data` on first use and
+  /// redirects `content()` to it. Afterwards, moving or copying the content
+  /// only increments the reference count of the shared representation.
+  const message& promote() const {
+    if (!promoted_.vals()) {
+      message_factory f;
+      // Mailbox elements are always heap-allocated as non-const objects.
+      auto& xs = const_cast<mailbox_element_vals*>(this)->data();
+      promoted_ = detail::apply_moved_args(f, detail::get_indices(xs), xs);
+    }
+    return promoted_;
+  }
+
+  /// Stores the payload after the receiver copied or forwarded it.
+  mutable message promoted_;
 };
 
 /// Provides a view for treating arbitrary data as message element.
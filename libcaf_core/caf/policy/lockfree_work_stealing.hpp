@@ -0,0 +1,225 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <thread>
+
+#include "caf/detail/chase_lev_deque.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/detail/injection_queue.hpp"
+#include "caf/policy/unprofiled.hpp"
+#include "caf/policy/work_stealing.hpp"
+#include "caf/resumable.hpp"
+
+namespace caf::policy {
+
+/// Implements scheduling of actors via work stealing with lock-free queues.
+/// Each worker owns a Chase-Lev deque for jobs enqueued by the worker itself
+/// and an injection queue for jobs enqueued by other threads. Neither queue
+/// allocates memory on the fast path.
+/// @extends scheduler_policy
+class CAF_CORE_EXPORT lockfree_work_stealing : public unprofiled {
+public:
+  ~lockfree_work_stealing() override;
+
+  // A lock-free deque that only allows the owner to push.
+  using queue_type = detail::chase_lev_deque<resumable>;
+
+  // A lock-free queue that allows any thread to push.
+  using inbox_type = detail::injection_queue<resumable>;
+
+  // configuration for aggressive/moderate poll strategies.
+  using poll_strategy = work_stealing::poll_strategy;
+
+  // The coordinator has a counter for round-robin enqueue to its workers and
+  // keeps track of idle workers.
+  using coordinator_data = work_stealing::coordinator_data;
+
+  // Holds the job queues of a worker and a random number generator.
+  struct worker_data {
+    explicit worker_data(scheduler::abstract_coordinator* p);
+    worker_data(const worker_data& other);
+
+    // Jobs enqueued by the worker itself. Other workers may steal from the
+    // top of this deque.
+    queue_type queue;
+    // Jobs enqueued by other threads. Other workers may steal from this queue
+    // as well if the owner is busy.
+    inbox_type inbox;
+    // needed to generate pseudo random numbers
+    std::default_random_engine rengine;
+    std::uniform_int_distribution<size_t> uniform;
+    std::array<poll_strategy, 2> strategies;
+    // Non-null if workers are pinned to CPUs and steal from near victims
+    // first.
+    work_stealing::victims_ptr victims;
+  };
+
+  // Steals the oldest job of `victim`.
+  static resumable* steal_from(worker_data& victim) {
+    auto job = victim.queue.steal();
+    return job != nullptr ? job : victim.inbox.pop();
+  }
+
+  // Goes on a raid in quest for a shiny new job.
+  template <class Worker>
+  resumable* try_steal(Worker* self) {
+    auto p = self->parent();
+    if (p->num_workers() < 2) {
+      // you can't steal from yourself, can you?
+      return nullptr;
+    }
+    if (d(self).victims)
+      return work_stealing::steal_near_first(self, [](worker_data& victim) {
+        return steal_from(victim);
+      });
+    // roll the dice to pick a victim other than ourselves
+    auto victim = d(self).uniform(d(self).rengine);
+    if (victim == self->id())
+      victim = p->num_workers() - 1;
+    return steal_from(d(p->worker_by_id(victim)));
+  }
+
+  // Visits all queues once before going to sleep.
+  template <class Worker>
+  resumable* try_steal_any(Worker* self) {
+    auto p = self->parent();
+    auto n = p->num_workers();
+    auto offset = self->id() + 1;
+    for (size_t i = 0; i < n; ++i) {
+      auto victim = p->worker_by_id((offset + i) % n);
+      auto job = victim == self ? take_head(self) : steal_from(d(victim));
+      if (job)
+        return job;
+    }
+    return nullptr;
+  }
+
+  // Wakes up a parked worker unless another worker is already looking for
+  // jobs. Called after making a new job visible to other workers.
+  template <class Coordinator>
+  void notify_idle_worker(Coordinator* self) {
+    auto& cd = d(self);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (cd.searching.load(std::memory_order_relaxed) == 0)
+      cd.parked.notify_one();
+  }
+
+  template <class Coordinator>
+  void central_enqueue(Coordinator* self, resumable* job) {
+    auto w = self->worker_by_id(d(self).next_worker++ % self->num_workers());
+    w->external_enqueue(job);
+  }
+
+  template <class Worker>
+  void external_enqueue(Worker* self, resumable* job) {
+    d(self).inbox.push(job);
+    notify_idle_worker(self->parent());
+  }
+
+  template <class Worker>
+  void internal_enqueue(Worker* self, resumable* job) {
+    // Actors may enqueue with the stored context of another worker, e.g., when
+    // delivering a response promise. Only the owner may push to its deque.
+    if (std::this_thread::get_id() == self->get_thread().get_id())
+      d(self).queue.push(job);
+    else
+      d(self).inbox.push(job);
+    notify_idle_worker(self->parent());
+  }
+
+  template <class Worker>
+  void resume_job_later(Worker* self, resumable* job) {
+    // job has voluntarily released the CPU to let others run instead
+    // this means we are going to put this job to the very end of our queue
+    d(self).inbox.push(job);
+  }
+
+  template <class Worker>
+  resumable* take_head(Worker* self) {
+    auto job = d(self).queue.take();
+    return job != nullptr ? job : d(self).inbox.pop();
+  }
+
+  template <class Worker>
+  resumable* dequeue(Worker* self) {
+    auto job = take_head(self);
+    if (job)
+      return job;
+    // same polling and parking scheme as in `work_stealing`
+    auto& cd = d(self->parent());
+    auto& strategies = d(self).strategies;
+    cd.searching.fetch_add(1, std::memory_order_seq_cst);
+    for (;;) {
+      for (auto& strategy : strategies) {
+        for (size_t i = 0; i < strategy.attempts; i += strategy.step_size) {
+          job = take_head(self);
+          // try to steal every X poll attempts
+          if (!job && (i % strategy.steal_interval) == 0)
+            job = try_steal(self);
+          if (job) {
+            // make sure that at least one worker keeps looking for jobs if
+            // we were the last one
+            if (cd.searching.fetch_sub(1, std::memory_order_seq_cst) == 1)
+              cd.parked.notify_one();
+            return job;
+          }
+          if (strategy.sleep_duration.count() > 0) {
+#ifdef CAF_MSVC
+            if (strategy.sleep_duration.count() < 1000)
+              std::this_thread::yield();
+            else
+              std::this_thread::sleep_for(strategy.sleep_duration);
+#else
+            std::this_thread::sleep_for(strategy.sleep_duration);
+#endif
+          }
+        }
+      }
+      cd.searching.fetch_sub(1, std::memory_order_seq_cst);
+      auto key = cd.parked.prepare_wait();
+      job = try_steal_any(self);
+      if (job) {
+        cd.parked.cancel_wait();
+        return job;
+      }
+      cd.parked.wait(key);
+      cd.searching.fetch_add(1, std::memory_order_seq_cst);
+    }
+  }
+
+  template <class Worker, class UnaryFunction>
+  void foreach_resumable(Worker* self, UnaryFunction f) {
+    auto next = [&] { return take_head(self); };
+    for (auto job = next(); job != nullptr; job = next()) {
+      f(job);
+    }
+  }
+
+  template <class Coordinator, class UnaryFunction>
+  void foreach_central_resumable(Coordinator*, UnaryFunction) {
+    // nop
+  }
+};
+
+} // namespace caf::policy
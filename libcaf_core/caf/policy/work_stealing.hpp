@@ -19,17 +19,18 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <chrono>
-#include <condition_variable>
 #include <cstddef>
-#include <deque>
-#include <mutex>
+#include <memory>
 #include <random>
 #include <thread>
 
 #include "caf/actor_system_config.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/cpu_topology.hpp"
 #include "caf/detail/double_ended_queue.hpp"
+#include "caf/detail/eventcount.hpp"
 #include "caf/policy/unprofiled.hpp"
 #include "caf/resumable.hpp"
 #include "caf/timespan.hpp"
@@ -45,7 +46,7 @@ public:
   // A thread-safe queue implementation.
   using queue_type = detail::double_ended_queue<resumable>;
 
-  // configuration for aggressive/moderate/relaxed poll strategies.
+  // configuration for aggressive/moderate poll strategies.
   struct poll_strategy {
     size_t attempts;
     size_t step_size;
@@ -53,23 +54,25 @@ public:
     timespan sleep_duration;
   };
 
-  // what is needed to implement the waiting strategy.
-  struct wait_strategy {
-    std::mutex lock;
-    std::condition_variable cv;
-    bool sleeping{false};
-  };
-
-  // The coordinator has only a counter for round-robin enqueue to its workers.
+  // The coordinator has a counter for round-robin enqueue to its workers and
+  // keeps track of idle workers.
   struct coordinator_data {
     inline explicit coordinator_data(scheduler::abstract_coordinator*)
-      : next_worker(0) {
+      : next_worker(0), searching(0) {
       // nop
     }
 
     std::atomic<size_t> next_worker;
+    // Workers that ran out of work and currently poll for new jobs.
+    std::atomic<size_t> searching;
+    // Parks workers after polling failed.
+    detail::eventcount parked;
   };
 
+  // Victims of all workers, grouped by their distance to the thief.
+  using victims_ptr
+    = std::shared_ptr<const std::vector<detail::cpu_topology::victim_groups>>;
+
   // Holds job job queue of a worker and a random number generator.
   struct worker_data {
     explicit worker_data(scheduler::abstract_coordinator* p);
@@ -81,10 +84,31 @@ public:
     // needed to generate pseudo random numbers
     std::default_random_engine rengine;
     std::uniform_int_distribution<size_t> uniform;
-    std::array<poll_strategy, 3> strategies;
-    wait_strategy waitdata;
+    std::array<poll_strategy, 2> strategies;
+    // Non-null if workers are pinned to CPUs and steal from near victims
+    // first.
+    victims_ptr victims;
   };
 
+  // Computes victim groups for topology-aware stealing if enabled in the
+  // config of `p`.
+  static victims_ptr make_victims(scheduler::abstract_coordinator* p);
+
+  // Picks a victim from the nearest non-empty group and calls `f` on it until
+  // `f` returns a job.
+  template <class Worker, class F>
+  static resumable* steal_near_first(Worker* self, F f) {
+    auto& data = d(self);
+    for (auto& group : (*data.victims)[self->id()]) {
+      if (group.empty())
+        continue;
+      auto victim = group[data.rengine() % group.size()];
+      if (auto job = f(d(self->parent()->worker_by_id(victim))))
+        return job;
+    }
+    return nullptr;
+  }
+
   // Goes on a raid in quest for a shiny new job.
   template <class Worker>
   resumable* try_steal(Worker* self) {
@@ -93,6 +117,10 @@ public:
       // you can't steal from yourself, can you?
       return nullptr;
     }
+    if (d(self).victims)
+      return steal_near_first(self, [](worker_data& victim) {
+        return victim.queue.take_tail();
+      });
     // roll the dice to pick a victim other than ourselves
     auto victim = d(self).uniform(d(self).rengine);
     if (victim == self->id())
@@ -101,6 +129,32 @@ public:
     return d(p->worker_by_id(victim)).queue.take_tail();
   }
 
+  // Visits all queues once before going to sleep.
+  template <class Worker>
+  resumable* try_steal_any(Worker* self) {
+    auto p = self->parent();
+    auto n = p->num_workers();
+    auto offset = self->id() + 1;
+    for (size_t i = 0; i < n; ++i) {
+      auto victim = p->worker_by_id((offset + i) % n);
+      auto job = victim == self ? d(self).queue.take_head()
+                                : d(victim).queue.take_tail();
+      if (job)
+        return job;
+    }
+    return nullptr;
+  }
+
+  // Wakes up a parked worker unless another worker is already looking for
+  // jobs. Called after making a new job visible to other workers.
+  template <class Coordinator>
+  void notify_idle_worker(Coordinator* self) {
+    auto& cd = d(self);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (cd.searching.load(std::memory_order_relaxed) == 0)
+      cd.parked.notify_one();
+  }
+
   template <class Coordinator>
   void central_enqueue(Coordinator* self, resumable* job) {
     auto w = self->worker_by_id(d(self).next_worker++ % self->num_workers());
@@ -110,19 +164,13 @@ public:
   template <class Worker>
   void external_enqueue(Worker* self, resumable* job) {
     d(self).queue.append(job);
-    auto& lock = d(self).waitdata.lock;
-    auto& cv = d(self).waitdata.cv;
-    { // guard scope
-      std::unique_lock<std::mutex> guard(lock);
-      // check if the worker is sleeping
-      if (d(self).waitdata.sleeping && !d(self).queue.empty())
-        cv.notify_one();
-    }
+    notify_idle_worker(self->parent());
   }
 
   template <class Worker>
   void internal_enqueue(Worker* self, resumable* job) {
     d(self).queue.prepend(job);
+    notify_idle_worker(self->parent());
   }
 
   template <class Worker>
@@ -134,67 +182,57 @@ public:
 
   template <class Worker>
   resumable* dequeue(Worker* self) {
+    auto job = d(self).queue.take_head();
+    if (job)
+      return job;
     // we wait for new jobs by polling our external queue: first, we
     // assume an active work load on the machine and perform aggressive
     // polling, then we relax our polling a bit and wait 50 us between
     // dequeue attempts
+    auto& cd = d(self->parent());
     auto& strategies = d(self).strategies;
-    resumable* job = nullptr;
-    for (size_t k = 0; k < 2; ++k) { // iterate over the first two strategies
-      for (size_t i = 0; i < strategies[k].attempts;
-           i += strategies[k].step_size) {
-        job = d(self).queue.take_head();
-        if (job)
-          return job;
-        // try to steal every X poll attempts
-        if ((i % strategies[k].steal_interval) == 0) {
-          job = try_steal(self);
-          if (job)
+    cd.searching.fetch_add(1, std::memory_order_seq_cst);
+    for (;;) {
+      for (auto& strategy : strategies) {
+        for (size_t i = 0; i < strategy.attempts; i += strategy.step_size) {
+          job = d(self).queue.take_head();
+          // try to steal every X poll attempts
+          if (!job && (i % strategy.steal_interval) == 0)
+            job = try_steal(self);
+          if (job) {
+            // make sure that at least one worker keeps looking for jobs if
+            // we were the last one
+            if (cd.searching.fetch_sub(1, std::memory_order_seq_cst) == 1)
+              cd.parked.notify_one();
             return job;
-        }
-        if (strategies[k].sleep_duration.count() > 0) {
+          }
+          if (strategy.sleep_duration.count() > 0) {
 #ifdef CAF_MSVC
-          // Windows cannot sleep less than 1000 us, so timeout is converted to
-          // 0 inside sleep_for(), but Sleep(0) is dangerous so replace it with
-          // yield()
-          if (strategies[k].sleep_duration.count() < 1000)
-            std::this_thread::yield();
-          else
-            std::this_thread::sleep_for(strategies[k].sleep_duration);
+            // Windows cannot sleep less than 1000 us, so timeout is converted
+            // to 0 inside sleep_for(), but Sleep(0) is dangerous so replace it
+            // with yield()
+            if (strategy.sleep_duration.count() < 1000)
+              std::this_thread::yield();
+            else
+              std::this_thread::sleep_for(strategy.sleep_duration);
 #else
-          std::this_thread::sleep_for(strategies[k].sleep_duration);
+            std::this_thread::sleep_for(strategy.sleep_duration);
 #endif
+          }
         }
       }
-    }
-    // we assume pretty much nothing is going on so we can relax polling
-    // and falling to sleep on a condition variable whose timeout is the one
-    // of the relaxed polling strategy
-    auto& relaxed = strategies[2];
-    auto& sleeping = d(self).waitdata.sleeping;
-    auto& lock = d(self).waitdata.lock;
-    auto& cv = d(self).waitdata.cv;
-    bool notimeout = true;
-    size_t i = 1;
-    do {
-      { // guard scope
-        std::unique_lock<std::mutex> guard(lock);
-        sleeping = true;
-        if (!cv.wait_for(guard, relaxed.sleep_duration,
-                         [&] { return !d(self).queue.empty(); }))
-          notimeout = false;
-        sleeping = false;
-      }
-      if (notimeout) {
-        job = d(self).queue.take_head();
-      } else {
-        notimeout = true;
-        if ((i % relaxed.steal_interval) == 0)
-          job = try_steal(self);
+      // we assume pretty much nothing is going on so we park this worker
+      // until some other thread enqueues a new job
+      cd.searching.fetch_sub(1, std::memory_order_seq_cst);
+      auto key = cd.parked.prepare_wait();
+      job = try_steal_any(self);
+      if (job) {
+        cd.parked.cancel_wait();
+        return job;
       }
-      ++i;
-    } while (job == nullptr);
-    return job;
+      cd.parked.wait(key);
+      cd.searching.fetch_add(1, std::memory_order_seq_cst);
+    }
   }
 
   template <class Worker, class UnaryFunction>
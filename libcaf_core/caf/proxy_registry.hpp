@@ -20,7 +20,6 @@
 
 #include <functional>
 #include <map>
-#include <mutex>
 #include <unordered_map>
 #include <utility>
 
@@ -28,6 +27,7 @@
 #include "caf/actor_cast.hpp"
 #include "caf/actor_proxy.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/shared_spinlock.hpp"
 #include "caf/exit_reason.hpp"
 #include "caf/fwd.hpp"
 #include "caf/node_id.hpp"
@@ -119,7 +119,11 @@ private:
 
   actor_system& system_;
   backend& backend_;
-  mutable std::mutex mtx_;
+
+  /// Allows concurrent lookups from BASP workers. Only adding or removing
+  /// proxies requires exclusive access.
+  mutable detail::shared_spinlock mtx_;
+
   std::unordered_map<node_id, proxy_map> proxies_;
 };
 
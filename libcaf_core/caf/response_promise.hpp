@@ -25,8 +25,10 @@
 #include "caf/actor_cast.hpp"
 #include "caf/check_typed_input.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/mailbox_element.hpp"
 #include "caf/message.hpp"
 #include "caf/message_id.hpp"
+#include "caf/no_stages.hpp"
 #include "caf/response_type.hpp"
 
 namespace caf {
@@ -65,8 +67,10 @@ public:
                   "it is not possible to deliver objects of type result<T>");
     static_assert(!detail::tl_exists<ts, detail::is_expected>::value,
                   "mixing expected<T> with regular values is not supported");
-    return deliver_impl(
-      make_message(std::forward<T>(x), std::forward<Ts>(xs)...));
+    // Store the response inline. Sender, ID and stages get filled in later.
+    deliver_impl(make_mailbox_element(nullptr, id_, no_stages,
+                                      std::forward<T>(x),
+                                      std::forward<Ts>(xs)...));
   }
 
   template <class T>
@@ -140,6 +144,8 @@ private:
 
   void deliver_impl(message msg);
 
+  void deliver_impl(mailbox_element_ptr ptr);
+
   void delegate_impl(abstract_actor* receiver, message msg);
 
   strong_actor_ptr self_;
@@ -24,6 +24,7 @@
 #  include <exception>
 #endif // CAF_NO_EXCEPTIONS
 
+#include <atomic>
 #include <forward_list>
 #include <map>
 #include <type_traits>
@@ -919,6 +920,10 @@ protected:
   /// Pointer to a private thread object associated with a detached actor.
   detail::private_thread* private_thread_;
 
+  /// Tells `resume` to end the current round, because an urgent message
+  /// arrived while the actor consumed a batch of messages.
+  std::atomic<bool> urgent_pending_;
+
 #ifndef CAF_NO_EXCEPTIONS
   /// Customization point for setting a default exception callback.
   exception_handler exception_handler_;
@@ -66,6 +66,10 @@ public:
     return max_throughput_;
   }
 
+  inline size_t mailbox_batch_size() const {
+    return mailbox_batch_size_;
+  }
+
   inline size_t num_workers() const {
     return num_workers_;
   }
@@ -94,6 +98,9 @@ protected:
   /// Number of messages each actor is allowed to consume per resume.
   size_t max_throughput_;
 
+  /// Number of ordinary messages each actor consumes per mailbox round.
+  size_t mailbox_batch_size_;
+
   /// Configured number of workers.
   size_t num_workers_;
 
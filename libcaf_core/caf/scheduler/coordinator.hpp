@@ -25,6 +25,10 @@
 #include <memory>
 #include <thread>
 
+#include "caf/actor_system_config.hpp"
+#include "caf/config_value.hpp"
+#include "caf/defaults.hpp"
+#include "caf/detail/cpu_topology.hpp"
 #include "caf/detail/set_thread_name.hpp"
 #include "caf/detail/thread_safe_actor_clock.hpp"
 #include "caf/scheduler/abstract_coordinator.hpp"
@@ -71,6 +75,16 @@ protected:
     // Start all workers.
     for (auto& w : workers_)
       w->start();
+    // Pin workers to CPUs if requested by the user.
+    if (get_or(config(), "scheduler.pin-workers",
+               defaults::scheduler::pin_workers)) {
+      auto topology = detail::cpu_topology::discover();
+      for (size_t i = 0; i < num; ++i) {
+        auto cpu = topology.cpu_of(i).id;
+        if (!detail::pin_thread(workers_[i]->get_thread(), cpu))
+          CAF_LOG_WARNING("failed to pin worker" << CAF_ARG(i) << CAF_ARG(cpu));
+      }
+    }
     // Launch an additional background thread for dispatching timeouts and
     // delayed messages.
     timer_ = std::thread{[&] {
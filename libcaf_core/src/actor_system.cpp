@@ -23,7 +23,9 @@
 #include "caf/actor.hpp"
 #include "caf/actor_system_config.hpp"
 #include "caf/defaults.hpp"
+#include "caf/detail/message_pool.hpp"
 #include "caf/event_based_actor.hpp"
+#include "caf/policy/lockfree_work_stealing.hpp"
 #include "caf/policy/work_sharing.hpp"
 #include "caf/policy/work_stealing.hpp"
 #include "caf/raise_error.hpp"
@@ -229,6 +231,10 @@ actor_system::actor_system(actor_system_config& cfg)
     logger_dtor_done_(false),
     tracing_context_(cfg.tracing_context) {
   CAF_SET_LOGGER_SYS(this);
+  // Pooling is process-wide. Hence, only the first actor system applies its
+  // setting and all later systems share the pool as configured.
+  detail::message_pool::configure(get_or(cfg, "memory.enable-pooling",
+                                         defaults::memory::enable_pooling));
   for (auto& hook : cfg.thread_hooks_)
     hook->init(*this);
   for (auto& f : cfg.module_factories) {
@@ -237,16 +243,19 @@ actor_system::actor_system(actor_system_config& cfg)
   }
   auto& sched = modules_[module::scheduler];
   using namespace scheduler;
+  using policy::lockfree_work_stealing;
   using policy::work_sharing;
   using policy::work_stealing;
   using share = coordinator<work_sharing>;
   using steal = coordinator<work_stealing>;
+  using lockfree_steal = coordinator<lockfree_work_stealing>;
   // set scheduler only if not explicitly loaded by user
   if (!sched) {
     enum sched_conf {
       stealing = 0x0001,
       sharing = 0x0002,
       testing = 0x0003,
+      lockfree_stealing = 0x0004,
     };
     sched_conf sc = stealing;
     namespace sr = defaults::scheduler;
@@ -255,6 +264,8 @@ actor_system::actor_system(actor_system_config& cfg)
       sc = sharing;
     else if (sr_policy == "testing")
       sc = testing;
+    else if (sr_policy == "lockfree-stealing")
+      sc = lockfree_stealing;
     else if (sr_policy != "stealing")
       std::cerr << "[WARNING] " << deep_to_string(sr_policy)
                 << " is an unrecognized scheduler pollicy, "
@@ -269,6 +280,9 @@ actor_system::actor_system(actor_system_config& cfg)
         break;
       case testing:
         sched.reset(new test_coordinator(*this));
+        break;
+      case lockfree_stealing:
+        sched.reset(new lockfree_steal(*this));
     }
   }
   // initialize state for each module and give each module the opportunity
@@ -85,9 +85,13 @@ actor_system_config::actor_system_config()
     .add<std::string>("credit-policy",
                       "selects an algorithm for credit computation");
   opt_group{custom_options_, "scheduler"}
-    .add<std::string>("policy", "'stealing' (default) or 'sharing'")
+    .add<std::string>("policy", "'stealing' (default), 'lockfree-stealing' "
+                                "or 'sharing'")
     .add<size_t>("max-threads", "maximum number of worker threads")
     .add<size_t>("max-throughput", "nr. of messages actors can consume per run")
+    .add<size_t>("mailbox-batch-size",
+                 "nr. of ordinary messages actors consume per mailbox round")
+    .add<bool>("pin-workers", "pins each worker thread to a single CPU")
     .add<bool>("enable-profiling", "enables profiler output")
     .add<timespan>("profiling-resolution", "data collection rate")
     .add<string>("profiling-output-file", "output file for the profiler");
@@ -100,10 +104,16 @@ actor_system_config::actor_system_config()
                  "frequency of moderate steal attempts")
     .add<timespan>("moderate-sleep-duration",
                    "sleep duration between moderate steal attempts")
-    .add<size_t>("relaxed-steal-interval",
-                 "frequency of relaxed steal attempts")
-    .add<timespan>("relaxed-sleep-duration",
-                   "sleep duration between relaxed steal attempts");
+    .add<size_t>("initial-deque-capacity",
+                 "initial capacity of lock-free work-stealing deques")
+    .add<size_t>("injection-queue-capacity",
+                 "capacity of lock-free ring buffers for external jobs")
+    .add<bool>("topology-aware",
+               "steal from nearby workers first (requires pinned workers)");
+  opt_group{custom_options_, "memory"}
+    .add<bool>("enable-pooling",
+               "recycles memory of messages in thread-local pools "
+               "(process-wide, only the first actor system applies it)");
   opt_group{custom_options_, "logger"}
     .add<std::string>("verbosity", "default verbosity for file and console")
     .add<string>("file-name", "filesystem path of the log file")
@@ -115,10 +125,12 @@ actor_system_config::actor_system_config()
     .add<std::string>("console-verbosity", "console output verbosity")
     .add<std::vector<std::string>>("component-blacklist",
                                    "excluded components for logging")
-    .add<bool>("inline-output", "disable logger thread (for testing only!)");
+    .add<bool>("inline-output", "disable logger thread (for testing only!)")
+    .add<size_t>("queue-size", "maximum number of queued log events")
+    .add<bool>("binary-output", "write binary records to the log file");
   opt_group{custom_options_, "middleman"}
     .add<std::string>("network-backend",
-                      "either 'default' or 'asio' (if available)")
+                      "either 'default', 'epoll-et' or 'io-uring' (Linux)")
     .add<std::vector<string>>("app-identifiers",
                               "valid application identifiers of this node")
     .add<string>("app-identifier", "DEPRECATED: use app-identifiers instead")
@@ -131,7 +143,27 @@ actor_system_config::actor_system_config()
                "schedule utility actors instead of dedicating threads")
     .add<bool>("manual-multiplexing",
                "disables background activity of the multiplexer")
-    .add<size_t>("workers", "number of deserialization workers");
+    .add<size_t>("workers", "number of deserialization workers")
+    .add<size_t>("max-workers",
+                 "max. number of deserialization workers under high load")
+    .add<timespan>("worker-idle-timeout",
+                   "idle time before removing workers added under high load")
+    .add<size_t>("multiplexer-threads",
+                 "number of multiplexers, each running in its own thread")
+    .add<size_t>("buffer-pool-size",
+                 "max. number of recycled I/O buffers per multiplexer")
+    .add<size_t>("buffer-pool-max-capacity",
+                 "max. capacity of recycled I/O buffers in bytes")
+    .add<size_t>("compression-threshold",
+                 "min. payload size for compressing BASP messages (0 = off)")
+    .add<size_t>("high-watermark",
+                 "max. pending bytes per connection before dropping (0 = off)")
+    .add<size_t>("low-watermark",
+                 "pending bytes per connection for accepting messages again")
+    .add<string>("local-socket-dir",
+                 "directory for Unix sockets to local peers (empty = off)")
+    .add<double>("udp-loss-rate",
+                 "drop rate for outgoing UDP datagrams (for testing only)");
   opt_group(custom_options_, "openssl")
     .add<string>(openssl_certificate, "certificate",
                  "path to the PEM-formatted certificate file")
@@ -170,6 +202,9 @@ settings actor_system_config::dump_content() const {
   put_missing(scheduler_group, "max-threads", defaults::scheduler::max_threads);
   put_missing(scheduler_group, "max-throughput",
               defaults::scheduler::max_throughput);
+  put_missing(scheduler_group, "mailbox-batch-size",
+              defaults::scheduler::mailbox_batch_size);
+  put_missing(scheduler_group, "pin-workers", defaults::scheduler::pin_workers);
   put_missing(scheduler_group, "enable-profiling", false);
   put_missing(scheduler_group, "profiling-resolution",
               defaults::scheduler::profiling_resolution);
@@ -186,10 +221,15 @@ settings actor_system_config::dump_content() const {
               defaults::work_stealing::moderate_steal_interval);
   put_missing(work_stealing_group, "moderate-sleep-duration",
               defaults::work_stealing::moderate_sleep_duration);
-  put_missing(work_stealing_group, "relaxed-steal-interval",
-              defaults::work_stealing::relaxed_steal_interval);
-  put_missing(work_stealing_group, "relaxed-sleep-duration",
-              defaults::work_stealing::relaxed_sleep_duration);
+  put_missing(work_stealing_group, "initial-deque-capacity",
+              defaults::work_stealing::initial_deque_capacity);
+  put_missing(work_stealing_group, "injection-queue-capacity",
+              defaults::work_stealing::injection_queue_capacity);
+  put_missing(work_stealing_group, "topology-aware",
+              defaults::work_stealing::topology_aware);
+  // -- memory parameters
+  auto& memory_group = result["memory"].as_dictionary();
+  put_missing(memory_group, "enable-pooling", defaults::memory::enable_pooling);
   // -- logger parameters
   auto& logger_group = result["logger"].as_dictionary();
   put_missing(logger_group, "file-name", defaults::logger::file_name);
@@ -201,6 +241,8 @@ settings actor_system_config::dump_content() const {
               defaults::logger::console_verbosity);
   put_missing(logger_group, "component-blacklist", std::vector<std::string>{});
   put_missing(logger_group, "inline-output", false);
+  put_missing(logger_group, "queue-size", defaults::logger::queue_size);
+  put_missing(logger_group, "binary-output", false);
   // -- middleman parameters
   auto& middleman_group = result["middleman"].as_dictionary();
   put_missing(middleman_group, "app-identifiers",
@@ -211,6 +253,25 @@ settings actor_system_config::dump_content() const {
   put_missing(middleman_group, "heartbeat-interval",
               defaults::middleman::heartbeat_interval);
   put_missing(middleman_group, "workers", defaults::middleman::workers);
+  put_missing(middleman_group, "max-workers", defaults::middleman::max_workers);
+  put_missing(middleman_group, "worker-idle-timeout",
+              defaults::middleman::worker_idle_timeout);
+  put_missing(middleman_group, "multiplexer-threads",
+              defaults::middleman::multiplexer_threads);
+  put_missing(middleman_group, "buffer-pool-size",
+              defaults::middleman::buffer_pool_size);
+  put_missing(middleman_group, "buffer-pool-max-capacity",
+              defaults::middleman::buffer_pool_max_capacity);
+  put_missing(middleman_group, "compression-threshold",
+              defaults::middleman::compression_threshold);
+  put_missing(middleman_group, "high-watermark",
+              defaults::middleman::high_watermark);
+  put_missing(middleman_group, "low-watermark",
+              defaults::middleman::low_watermark);
+  put_missing(middleman_group, "local-socket-dir",
+              defaults::middleman::local_socket_dir);
+  put_missing(middleman_group, "udp-loss-rate",
+              defaults::middleman::udp_loss_rate);
   // -- openssl parameters
   auto& openssl_group = result["openssl"].as_dictionary();
   put_missing(openssl_group, "certificate", std::string{});
@@ -172,6 +172,10 @@ blocking_actor::mailbox_visitor::operator()(mailbox_element& x) {
       done = true;
       return intrusive::task_result::stop;
     };
+    // Any response renders the pending request timeout obsolete, even if
+    // the current receive skips the response.
+    if (x.mid.is_response())
+      self->response_arrived(x.mid);
     // Skip messages that don't match our message ID.
     if (mid.is_response()) {
       if (mid != x.mid) {
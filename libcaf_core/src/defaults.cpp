@@ -84,7 +84,9 @@ const string_view policy = "stealing";
 string_view profiling_output_file = "";
 const size_t max_threads = max(std::thread::hardware_concurrency(), 4u);
 const size_t max_throughput = std::numeric_limits<size_t>::max();
+const size_t mailbox_batch_size = 64;
 const timespan profiling_resolution = ms(100);
+const bool pin_workers = false;
 
 } // namespace scheduler
 
@@ -95,11 +97,18 @@ const size_t aggressive_steal_interval = 10;
 const size_t moderate_poll_attempts = 500;
 const size_t moderate_steal_interval = 5;
 const timespan moderate_sleep_duration = us(50);
-const size_t relaxed_steal_interval = 1;
-const timespan relaxed_sleep_duration = ms(10);
+const size_t initial_deque_capacity = 256;
+const size_t injection_queue_capacity = 1024;
+const bool topology_aware = true;
 
 } // namespace work_stealing
 
+namespace memory {
+
+const bool enable_pooling = true;
+
+} // namespace memory
+
 namespace logger {
 
 string_view component_filter = "";
@@ -109,6 +118,7 @@ const string_view console_verbosity = default_log_level;
 string_view file_format = "%r %c %p %a %t %C %M %F:%L %m%n";
 string_view file_name = "actor_log_[PID]_[TIMESTAMP]_[NODE].log";
 const string_view file_verbosity = default_log_level;
+const size_t queue_size = 1024;
 
 } // namespace logger
 
@@ -121,6 +131,16 @@ const size_t heartbeat_interval = 0;
 const size_t cached_udp_buffers = 10;
 const size_t max_pending_msgs = 10;
 const size_t workers = min(3u, std::thread::hardware_concurrency() / 4u) + 1;
+const size_t max_workers = max(std::thread::hardware_concurrency() / 2u, 4u);
+const timespan worker_idle_timeout = ms(1000);
+const size_t multiplexer_threads = 1;
+const size_t buffer_pool_size = 64;
+const size_t buffer_pool_max_capacity = 64 * 1024;
+const size_t compression_threshold = 0;
+const size_t high_watermark = 0;
+const size_t low_watermark = 0;
+const string_view local_socket_dir = "";
+const double udp_loss_rate = 0.0;
 
 } // namespace middleman
 
@@ -24,7 +24,11 @@ namespace caf::detail {
 
 // -- constructors, destructors, and assignment operators ----------------------
 
-abstract_worker_hub::abstract_worker_hub() : head_(nullptr), running_(0) {
+abstract_worker_hub::abstract_worker_hub()
+  : head_(nullptr),
+    running_(0),
+    size_(0),
+    idle_since_(actor_clock::time_point::max()) {
   // nop
 }
 
@@ -48,7 +52,41 @@ void abstract_worker_hub::await_workers() {
 
 // -- worker management --------------------------------------------------------
 
+bool abstract_worker_hub::shrink(size_t min_size) {
+  if (size_ <= min_size)
+    return false;
+  // Other threads only ever push to the stack. Hence, the master can safely
+  // remove the top element without running into the ABA problem.
+  auto ptr = head_.load();
+  while (ptr != nullptr) {
+    auto next = ptr->next_.load();
+    if (head_.compare_exchange_strong(ptr, next)) {
+      ptr->intrusive_ptr_release_impl();
+      --size_;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool abstract_worker_hub::shrink(size_t min_size, actor_clock::time_point now,
+                                 timespan delay) {
+  if (!idle() || size_ <= min_size) {
+    idle_since_ = actor_clock::time_point::max();
+    return false;
+  }
+  if (idle_since_ == actor_clock::time_point::max()) {
+    idle_since_ = now;
+    return false;
+  }
+  if (now - idle_since_ < delay || !shrink(min_size))
+    return false;
+  idle_since_ = now;
+  return true;
+}
+
 void abstract_worker_hub::push_new(abstract_worker* ptr) {
+  ++size_;
   auto next = head_.load();
   for (;;) {
     ptr->next_ = next;
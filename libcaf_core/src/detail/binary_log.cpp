@@ -0,0 +1,205 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/binary_log.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <thread>
+
+#include "caf/detail/fnv_hash.hpp"
+#include "caf/detail/log_arg_encoder.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+constexpr char magic[] = "CAFLOG";
+
+constexpr size_t magic_size = sizeof(magic) - 1;
+
+int64_t to_ns(timespan x) {
+  return x.count();
+}
+
+} // namespace
+
+// -- binary_log_writer --------------------------------------------------------
+
+size_t binary_log_writer::site_key_hash::operator()(const site_key& x) const
+  noexcept {
+  // Sites compare by the addresses of their string literals.
+  auto result = fnv_hash(reinterpret_cast<uintptr_t>(x.fun));
+  result = fnv_hash_append(result, reinterpret_cast<uintptr_t>(x.component));
+  result = fnv_hash_append(result, x.line);
+  return fnv_hash_append(result, x.level);
+}
+
+void binary_log_writer::write_header(std::ostream& out, timestamp t0) {
+  t0_ = t0;
+  buf_.assign(magic, magic_size);
+  buf_ += static_cast<char>(version);
+  put_varint(static_cast<uint64_t>(to_ns(t0.time_since_epoch())));
+  out.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+}
+
+void binary_log_writer::write(std::ostream& out, const logger::event& x) {
+  buf_.clear();
+  site_key key{x.pretty_fun.data(), x.category_name.data(), x.line_number,
+               x.level};
+  auto i = sites_.find(key);
+  if (i == sites_.end()) {
+    i = sites_.emplace(key, sites_.size()).first;
+    buf_ += 'S';
+    put_varint(i->second);
+    put_varint(x.level);
+    put_varint(x.line_number);
+    put_str(x.category_name);
+    put_str(x.pretty_fun);
+    put_str(x.simple_fun);
+    put_str(x.file_name);
+  }
+  buf_ += 'E';
+  put_varint(i->second);
+  auto dt = to_ns(x.tstamp - t0_);
+  put_varint(dt < 0 ? 0 : static_cast<uint64_t>(dt));
+  put_varint(std::hash<std::thread::id>{}(x.tid));
+  put_varint(x.aid);
+  put_str(x.message);
+  out.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+}
+
+void binary_log_writer::put_varint(uint64_t x) {
+  while (x > 0x7f) {
+    buf_ += static_cast<char>((x & 0x7f) | 0x80);
+    x >>= 7;
+  }
+  buf_ += static_cast<char>(x);
+}
+
+void binary_log_writer::put_str(string_view str) {
+  put_varint(str.size());
+  buf_.insert(buf_.end(), str.begin(), str.end());
+}
+
+// -- binary_log_reader --------------------------------------------------------
+
+binary_log_reader::binary_log_reader(std::istream& in) : in_(in) {
+  // nop
+}
+
+bool binary_log_reader::read_header() {
+  char tmp[magic_size + 1];
+  if (!in_.read(tmp, sizeof(tmp)) || string_view{tmp, magic_size} != magic
+      || static_cast<uint8_t>(tmp[magic_size]) != binary_log_writer::version) {
+    malformed_ = true;
+    return false;
+  }
+  uint64_t ns = 0;
+  if (!get_varint(ns))
+    return false;
+  t0_ = timestamp{timespan{static_cast<int64_t>(ns)}};
+  return true;
+}
+
+bool binary_log_reader::next(event& x) {
+  for (;;) {
+    auto kind = in_.get();
+    if (kind == std::istream::traits_type::eof())
+      return false;
+    if (kind == magic[0]) {
+      // The logger appends to existing files. Hence, a file may contain the
+      // output of multiple runs, each starting with its own header.
+      in_.unget();
+      sites_.clear();
+      if (!read_header())
+        return false;
+    } else if (kind == 'S') {
+      uint64_t id = 0;
+      uint64_t level = 0;
+      uint64_t line = 0;
+      site tmp;
+      if (!get_varint(id) || !get_varint(level) || !get_varint(line)
+          || !get_str(tmp.component) || !get_str(tmp.pretty_fun)
+          || !get_str(tmp.simple_fun) || !get_str(tmp.file_name))
+        return false;
+      tmp.level = static_cast<unsigned>(level);
+      tmp.line = static_cast<unsigned>(line);
+      sites_[id] = std::move(tmp);
+    } else if (kind == 'E') {
+      uint64_t id = 0;
+      uint64_t dt = 0;
+      uint64_t aid = 0;
+      if (!get_varint(id) || !get_varint(dt) || !get_varint(x.tid)
+          || !get_varint(aid) || !get_str(buf_))
+        return false;
+      auto i = sites_.find(id);
+      if (i == sites_.end()) {
+        malformed_ = true;
+        return false;
+      }
+      x.origin = &i->second;
+      x.tstamp = t0_ + timespan{static_cast<int64_t>(dt)};
+      x.aid = aid;
+      x.message = render_log_args(buf_);
+      return true;
+    } else {
+      malformed_ = true;
+      return false;
+    }
+  }
+}
+
+bool binary_log_reader::get_varint(uint64_t& x) {
+  x = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    auto byte = in_.get();
+    if (byte == std::istream::traits_type::eof())
+      break;
+    x |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  malformed_ = true;
+  return false;
+}
+
+bool binary_log_reader::get_str(std::string& x) {
+  uint64_t len = 0;
+  if (!get_varint(len))
+    return false;
+  // Corrupt or truncated files may announce arbitrary lengths. Hence, we
+  // never allocate more memory than the input actually provides.
+  x.clear();
+  char chunk[1024];
+  while (len > 0) {
+    auto n = static_cast<size_t>(std::min(len, uint64_t{sizeof(chunk)}));
+    if (!in_.read(chunk, static_cast<std::streamsize>(n))) {
+      malformed_ = true;
+      return false;
+    }
+    x.append(chunk, n);
+    len -= n;
+  }
+  return true;
+}
+
+} // namespace caf::detail
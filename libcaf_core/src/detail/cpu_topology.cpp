@@ -0,0 +1,193 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/cpu_topology.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "caf/config.hpp"
+
+#ifdef CAF_LINUX
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+namespace caf::detail {
+
+namespace {
+
+#ifdef CAF_LINUX
+
+constexpr const char* sysfs_cpu = "/sys/devices/system/cpu/";
+
+constexpr const char* sysfs_node = "/sys/devices/system/node/";
+
+bool read_line(const std::string& path, std::string& line) {
+  std::ifstream in{path};
+  return in && std::getline(in, line);
+}
+
+std::vector<size_t> read_cpu_list(const std::string& path) {
+  std::string line;
+  if (!read_line(path, line))
+    return {};
+  return cpu_topology::parse_cpu_list(line);
+}
+
+// Returns the smallest CPU sharing the highest-level cache with `cpu`.
+size_t read_llc(size_t cpu) {
+  auto prefix = std::string{sysfs_cpu} + "cpu" + std::to_string(cpu)
+                + "/cache/index";
+  size_t result = cpu;
+  size_t max_level = 0;
+  for (size_t index = 0;; ++index) {
+    auto dir = prefix + std::to_string(index);
+    // The file contains a single number, i.e., a valid CPU list.
+    auto levels = read_cpu_list(dir + "/level");
+    if (levels.size() != 1)
+      break;
+    auto level = levels.front();
+    if (level < max_level)
+      continue;
+    auto shared = read_cpu_list(dir + "/shared_cpu_list");
+    if (!shared.empty()) {
+      max_level = level;
+      result = *std::min_element(shared.begin(), shared.end());
+    }
+  }
+  return result;
+}
+
+#endif // CAF_LINUX
+
+} // namespace
+
+cpu_topology::cpu_topology(std::vector<cpu_info> cpus) : cpus_(std::move(cpus)) {
+  if (cpus_.empty())
+    cpus_.push_back(cpu_info{0, 0, 0});
+  auto key = [](const cpu_info& x) {
+    return std::make_tuple(x.node, x.cache, x.id);
+  };
+  std::sort(cpus_.begin(), cpus_.end(),
+            [&](const cpu_info& x, const cpu_info& y) {
+              return key(x) < key(y);
+            });
+}
+
+cpu_topology cpu_topology::discover() {
+  std::vector<cpu_info> cpus;
+#ifdef CAF_LINUX
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  auto have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+  std::map<size_t, size_t> nodes;
+  for (auto node : read_cpu_list(std::string{sysfs_node} + "online"))
+    for (auto cpu : read_cpu_list(std::string{sysfs_node} + "node"
+                                  + std::to_string(node) + "/cpulist"))
+      nodes.emplace(cpu, node);
+  for (auto cpu : read_cpu_list(std::string{sysfs_cpu} + "online")) {
+    if (have_mask && (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed)))
+      continue;
+    auto i = nodes.find(cpu);
+    cpus.push_back(cpu_info{cpu, i != nodes.end() ? i->second : 0u,
+                            read_llc(cpu)});
+  }
+#endif // CAF_LINUX
+  if (cpus.empty()) {
+    auto n = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t cpu = 0; cpu < n; ++cpu)
+      cpus.push_back(cpu_info{cpu, 0, 0});
+  }
+  return cpu_topology{std::move(cpus)};
+}
+
+std::vector<size_t> cpu_topology::parse_cpu_list(string_view str) {
+  std::vector<size_t> result;
+  auto parse_num = [&](size_t& pos, size_t& out) {
+    auto first = pos;
+    out = 0;
+    while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9')
+      out = out * 10 + static_cast<size_t>(str[pos++] - '0');
+    return pos != first;
+  };
+  size_t pos = 0;
+  while (pos < str.size()) {
+    size_t first = 0;
+    if (!parse_num(pos, first))
+      return {};
+    size_t last = first;
+    if (pos < str.size() && str[pos] == '-') {
+      ++pos;
+      if (!parse_num(pos, last) || last < first)
+        return {};
+    }
+    for (auto cpu = first; cpu <= last; ++cpu)
+      result.push_back(cpu);
+    if (pos < str.size()) {
+      if (str[pos] == ',')
+        ++pos;
+      else if (str[pos] == '\n')
+        break;
+      else
+        return {};
+    }
+  }
+  return result;
+}
+
+std::vector<cpu_topology::victim_groups>
+cpu_topology::make_victim_groups(size_t num_workers) const {
+  std::vector<victim_groups> result(num_workers);
+  for (size_t self = 0; self < num_workers; ++self) {
+    auto& x = cpu_of(self);
+    for (size_t other = 0; other < num_workers; ++other) {
+      if (other == self)
+        continue;
+      auto& y = cpu_of(other);
+      if (x.node != y.node)
+        result[self][remote].push_back(other);
+      else if (x.cache != y.cache)
+        result[self][same_node].push_back(other);
+      else
+        result[self][same_cache].push_back(other);
+    }
+  }
+  return result;
+}
+
+bool pin_thread(std::thread& thread, size_t cpu_id) {
+#ifdef CAF_LINUX
+  if (cpu_id >= CPU_SETSIZE)
+    return false;
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu_id, &cpus);
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus)
+         == 0;
+#else
+  CAF_IGNORE_UNUSED(thread);
+  CAF_IGNORE_UNUSED(cpu_id);
+  return false;
+#endif
+}
+
+} // namespace caf::detail
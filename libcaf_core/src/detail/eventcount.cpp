@@ -0,0 +1,119 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/eventcount.hpp"
+
+#include <climits>
+
+#ifdef CAF_LINUX
+#  include <ctime>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace caf::detail {
+
+#ifdef CAF_LINUX
+
+namespace {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex requires std::atomic<uint32_t> without padding");
+
+void futex_wait(std::atomic<uint32_t>* addr, uint32_t expected,
+                const timespec* timeout = nullptr) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT_PRIVATE,
+          expected, timeout, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>* addr, int num) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE_PRIVATE,
+          num, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+#endif // CAF_LINUX
+
+eventcount::eventcount() noexcept : epoch_(0), waiters_(0) {
+  // nop
+}
+
+void eventcount::wait(key_type key) {
+#ifdef CAF_LINUX
+  // The kernel only blocks if the epoch still equals `key`, i.e., we cannot
+  // miss a notification that happened after `prepare_wait`.
+  while (epoch_.load(std::memory_order_acquire) == key)
+    futex_wait(&epoch_, key);
+#else
+  std::unique_lock<std::mutex> guard{mtx_};
+  while (epoch_.load(std::memory_order_acquire) == key)
+    cv_.wait(guard);
+#endif
+  waiters_.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+bool eventcount::wait_until(key_type key,
+                            std::chrono::steady_clock::time_point timeout) {
+  using clock_type = std::chrono::steady_clock;
+#ifdef CAF_LINUX
+  while (epoch_.load(std::memory_order_acquire) == key) {
+    auto now = clock_type::now();
+    if (now >= timeout) {
+      waiters_.fetch_sub(1, std::memory_order_seq_cst);
+      return false;
+    }
+    // FUTEX_WAIT interprets the timeout as relative time.
+    auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout
+                                                                      - now);
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(delta.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(delta.count() % 1000000000);
+    futex_wait(&epoch_, key, &ts);
+  }
+#else
+  std::unique_lock<std::mutex> guard{mtx_};
+  while (epoch_.load(std::memory_order_acquire) == key) {
+    if (cv_.wait_until(guard, timeout) == std::cv_status::timeout
+        && epoch_.load(std::memory_order_acquire) == key) {
+      waiters_.fetch_sub(1, std::memory_order_seq_cst);
+      return false;
+    }
+  }
+#endif
+  waiters_.fetch_sub(1, std::memory_order_seq_cst);
+  return true;
+}
+
+void eventcount::do_notify(bool all) noexcept {
+  epoch_.fetch_add(1, std::memory_order_acq_rel);
+#ifdef CAF_LINUX
+  futex_wake(&epoch_, all ? INT_MAX : 1);
+#else
+  // Acquiring the mutex makes sure that a waiting thread either observes the
+  // new epoch or already blocks on the condition variable.
+  std::unique_lock<std::mutex> guard{mtx_};
+  if (all)
+    cv_.notify_all();
+  else
+    cv_.notify_one();
+#endif
+}
+
+} // namespace caf::detail
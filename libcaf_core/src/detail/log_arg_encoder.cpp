@@ -0,0 +1,166 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/log_arg_encoder.hpp"
+
+#include "caf/local_actor.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+bool read_str(string_view encoded, size_t& pos, string_view& str) {
+  uint64_t len = 0;
+  if (!read_log_varint(encoded, pos, len) || encoded.size() - pos < len)
+    return false;
+  str = encoded.substr(pos, static_cast<size_t>(len));
+  pos += static_cast<size_t>(len);
+  return true;
+}
+
+// Appends the value that starts with `tag` at `pos` to `result`.
+bool render_value(log_arg_tag tag, string_view encoded, size_t& pos,
+                  std::string& result) {
+  switch (tag) {
+    case log_arg_tag::text:
+    case log_arg_tag::value: {
+      string_view str;
+      if (!read_str(encoded, pos, str))
+        return false;
+      result.insert(result.end(), str.begin(), str.end());
+      return true;
+    }
+    case log_arg_tag::signed_integer: {
+      uint64_t x = 0;
+      if (!read_log_varint(encoded, pos, x))
+        return false;
+      auto y = static_cast<int64_t>(x >> 1);
+      result += deep_to_string((x & 1) != 0 ? ~y : y);
+      return true;
+    }
+    case log_arg_tag::unsigned_integer: {
+      uint64_t x = 0;
+      if (!read_log_varint(encoded, pos, x))
+        return false;
+      result += deep_to_string(x);
+      return true;
+    }
+    case log_arg_tag::floating_point: {
+      double x;
+      if (encoded.size() - pos < sizeof(double))
+        return false;
+      memcpy(&x, encoded.data() + pos, sizeof(double));
+      pos += sizeof(double);
+      result += std::to_string(x);
+      return true;
+    }
+    case log_arg_tag::boolean:
+      if (pos == encoded.size())
+        return false;
+      result += encoded[pos++] != 0 ? "true" : "false";
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+log_arg_encoder& log_arg_encoder::operator<<(const local_actor* self) {
+  return *this << self->name();
+}
+
+log_arg_encoder& log_arg_encoder::operator<<(const std::string& str) {
+  put_str(log_arg_tag::text, str);
+  return *this;
+}
+
+log_arg_encoder& log_arg_encoder::operator<<(string_view str) {
+  put_str(log_arg_tag::text, str);
+  return *this;
+}
+
+log_arg_encoder& log_arg_encoder::operator<<(const char* str) {
+  put_str(log_arg_tag::text, string_view{str, strlen(str)});
+  return *this;
+}
+
+log_arg_encoder& log_arg_encoder::operator<<(char x) {
+  put_str(log_arg_tag::text, string_view{&x, 1});
+  return *this;
+}
+
+void log_arg_encoder::put_varint(uint64_t x) {
+  while (x > 0x7f) {
+    buf_ += static_cast<char>((x & 0x7f) | 0x80);
+    x >>= 7;
+  }
+  buf_ += static_cast<char>(x);
+}
+
+void log_arg_encoder::put_str(log_arg_tag tag, string_view str) {
+  put_tag(tag);
+  put_varint(str.size());
+  buf_.insert(buf_.end(), str.begin(), str.end());
+}
+
+bool read_log_varint(string_view encoded, size_t& pos, uint64_t& x) {
+  x = 0;
+  for (unsigned shift = 0; pos < encoded.size() && shift < 64; shift += 7) {
+    auto byte = static_cast<uint8_t>(encoded[pos++]);
+    x |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+std::string render_log_args(string_view encoded) {
+  std::string result;
+  size_t pos = 0;
+  while (pos < encoded.size()) {
+    // Drops any partial output of the current argument on malformed input.
+    auto valid_size = result.size();
+    auto tag = static_cast<log_arg_tag>(encoded[pos++]);
+    // Strings only get a separator if the output does not end with a space.
+    // This mirrors `logger::line_builder`.
+    if (tag == log_arg_tag::text) {
+      if (!result.empty() && result.back() != ' ')
+        result += ' ';
+    } else if (!result.empty()) {
+      result += ' ';
+    }
+    if (tag == log_arg_tag::name) {
+      string_view name;
+      if (!read_str(encoded, pos, name) || pos == encoded.size()) {
+        result.resize(valid_size);
+        break;
+      }
+      result.insert(result.end(), name.begin(), name.end());
+      result += " = ";
+      tag = static_cast<log_arg_tag>(encoded[pos++]);
+    }
+    if (!render_value(tag, encoded, pos, result)) {
+      result.resize(valid_size);
+      break;
+    }
+  }
+  return result;
+}
+
+} // namespace caf::detail
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/log_site.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "caf/logger.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+struct log_site_registry {
+  std::mutex mtx;
+  std::vector<const logger*> loggers;
+  log_site* sites = nullptr;
+};
+
+log_site_registry& registry() {
+  static log_site_registry instance;
+  return instance;
+}
+
+} // namespace
+
+void log_site::add_logger(const logger* ptr) {
+  auto& reg = registry();
+  std::unique_lock<std::mutex> guard{reg.mtx};
+  reg.loggers.emplace_back(ptr);
+  for (auto site = reg.sites; site != nullptr; site = site->next_)
+    site->state_.store(unknown_state, std::memory_order_relaxed);
+}
+
+void log_site::remove_logger(const logger* ptr) {
+  auto& reg = registry();
+  std::unique_lock<std::mutex> guard{reg.mtx};
+  auto i = std::find(reg.loggers.begin(), reg.loggers.end(), ptr);
+  if (i == reg.loggers.end())
+    return;
+  reg.loggers.erase(i);
+  for (auto site = reg.sites; site != nullptr; site = site->next_)
+    site->state_.store(unknown_state, std::memory_order_relaxed);
+}
+
+bool log_site::evaluate() {
+  auto& reg = registry();
+  std::unique_lock<std::mutex> guard{reg.mtx};
+  if (!registered_) {
+    registered_ = true;
+    next_ = reg.sites;
+    reg.sites = this;
+  }
+  auto accepted = std::any_of(reg.loggers.begin(), reg.loggers.end(),
+                              [this](const logger* ptr) {
+                                return ptr->accepts(level_, component_);
+                              });
+  state_.store(accepted ? enabled_state : disabled_state,
+               std::memory_order_relaxed);
+  return accepted;
+}
+
+} // namespace caf::detail
@@ -0,0 +1,228 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/message_pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "caf/config.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+// A free block stores the pointer to the next free block.
+struct free_block {
+  free_block* next;
+};
+
+// A singly linked list of free blocks with known length.
+struct block_list {
+  free_block* head = nullptr;
+  size_t size = 0;
+
+  void push(void* ptr) noexcept {
+    auto blk = static_cast<free_block*>(ptr);
+    blk->next = head;
+    head = blk;
+    ++size;
+  }
+
+  void* pop() noexcept {
+    auto result = head;
+    head = head->next;
+    --size;
+    return result;
+  }
+
+  // Moves up to `n` blocks from this list into a new list.
+  block_list split(size_t n) noexcept {
+    block_list result;
+    while (head != nullptr && result.size < n)
+      result.push(pop());
+    return result;
+  }
+
+  void release() noexcept {
+    while (head != nullptr)
+      ::operator delete(pop());
+  }
+};
+
+// Maximum number of blocks per size class in a thread-local cache.
+constexpr size_t max_cached_blocks = 4 * message_pool::batch_size;
+
+// Maximum number of batches per size class in the depot.
+constexpr size_t max_depot_batches = 64;
+
+size_t size_class(size_t size) noexcept {
+  return (size - 1) / message_pool::granularity;
+}
+
+size_t block_size(size_t size_class) noexcept {
+  return (size_class + 1) * message_pool::granularity;
+}
+
+// Exchanges batches of blocks between threads.
+class depot {
+public:
+  bool get(size_t sc, block_list& out) {
+    auto& slot = slots_[sc];
+    std::unique_lock<std::mutex> guard{slot.mtx};
+    if (slot.batches.empty())
+      return false;
+    out = slot.batches.back();
+    slot.batches.pop_back();
+    return true;
+  }
+
+  void put(size_t sc, block_list batch) {
+    auto& slot = slots_[sc];
+    { // Lifetime scope of guard.
+      std::unique_lock<std::mutex> guard{slot.mtx};
+      if (slot.batches.size() < max_depot_batches) {
+        slot.batches.push_back(batch);
+        return;
+      }
+    }
+    batch.release();
+  }
+
+  std::atomic<size_t>& heap_allocations(size_t sc) {
+    return slots_[sc].heap_allocations;
+  }
+
+  static depot& instance() {
+    // Intentionally leaked to make sure that threads can still return blocks
+    // during static destruction.
+    static auto ptr = new depot;
+    return *ptr;
+  }
+
+private:
+  struct slot {
+    std::mutex mtx;
+    std::vector<block_list> batches;
+    std::atomic<size_t> heap_allocations{0};
+  };
+
+  std::array<slot, message_pool::num_size_classes> slots_;
+};
+
+// Caches free blocks for the current thread.
+class thread_cache {
+public:
+  thread_cache(bool& destroyed) : destroyed_(destroyed) {
+    // nop
+  }
+
+  ~thread_cache() {
+    destroyed_ = true;
+    auto& dp = depot::instance();
+    for (size_t sc = 0; sc < lists_.size(); ++sc)
+      while (lists_[sc].size > 0)
+        dp.put(sc, lists_[sc].split(message_pool::batch_size));
+  }
+
+  void* allocate(size_t sc) {
+    auto& xs = lists_[sc];
+    if (xs.size == 0 && !depot::instance().get(sc, xs)) {
+      depot::instance().heap_allocations(sc).fetch_add(
+        1, std::memory_order_relaxed);
+      return ::operator new(block_size(sc));
+    }
+    return xs.pop();
+  }
+
+  void deallocate(size_t sc, void* ptr) {
+    auto& xs = lists_[sc];
+    xs.push(ptr);
+    if (xs.size > max_cached_blocks)
+      depot::instance().put(sc, xs.split(message_pool::batch_size));
+  }
+
+  size_t cached_blocks(size_t sc) const noexcept {
+    return lists_[sc].size;
+  }
+
+private:
+  bool& destroyed_;
+  std::array<block_list, message_pool::num_size_classes> lists_;
+};
+
+std::atomic<bool> pooling_enabled{true};
+
+std::atomic<bool> pooling_configured{false};
+
+// Trivially destructible, i.e., remains valid after `tls_cache` is gone.
+thread_local bool tls_cache_destroyed;
+
+thread_local thread_cache tls_cache{tls_cache_destroyed};
+
+} // namespace
+
+void* message_pool::allocate(size_t size) {
+  if (size > max_block_size)
+    return ::operator new(size);
+  auto sc = size_class(size);
+  if (!pooling_enabled.load(std::memory_order_relaxed) || tls_cache_destroyed)
+    return ::operator new(block_size(sc));
+  return tls_cache.allocate(sc);
+}
+
+void message_pool::deallocate(void* ptr, size_t size) noexcept {
+  if (size > max_block_size || tls_cache_destroyed
+      || !pooling_enabled.load(std::memory_order_relaxed)) {
+    ::operator delete(ptr);
+    return;
+  }
+  tls_cache.deallocate(size_class(size), ptr);
+}
+
+void message_pool::enable(bool flag) noexcept {
+  pooling_enabled = flag;
+}
+
+bool message_pool::configure(bool flag) noexcept {
+  if (pooling_configured.exchange(true))
+    return false;
+  pooling_enabled = flag;
+  return true;
+}
+
+bool message_pool::enabled() noexcept {
+  return pooling_enabled;
+}
+
+size_t message_pool::cached_blocks(size_t size) noexcept {
+  if (size == 0 || size > max_block_size || tls_cache_destroyed)
+    return 0;
+  return tls_cache.cached_blocks(size_class(size));
+}
+
+size_t message_pool::heap_allocations(size_t size) noexcept {
+  if (size == 0 || size > max_block_size)
+    return 0;
+  return depot::instance().heap_allocations(size_class(size)).load();
+}
+
+} // namespace caf::detail
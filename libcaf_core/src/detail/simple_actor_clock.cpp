@@ -40,8 +40,9 @@ void simple_actor_clock::set_multi_timeout(time_point t, abstract_actor* self,
 }
 
 void simple_actor_clock::set_request_timeout(time_point t, abstract_actor* self,
-                                             message_id id) {
-  new_schedule_entry<request_timeout>(t, self->ctrl(), id);
+                                             message_id id,
+                                             request_timeout_token_ptr token) {
+  new_schedule_entry<request_timeout>(t, self->ctrl(), id, std::move(token));
 }
 
 void simple_actor_clock::cancel_ordinary_timeout(abstract_actor* self,
@@ -101,6 +102,9 @@ void simple_actor_clock::ship(delayed_event& x) {
     }
     case request_timeout_type: {
       auto& dref = static_cast<request_timeout&>(x);
+      // Drop timeouts for requests that the actor already marked as answered.
+      if (dref.token && dref.token->answered())
+        break;
       auto& self = dref.self;
       self->get()->eq_impl(dref.id, self, nullptr, sec::request_timeout);
       break;
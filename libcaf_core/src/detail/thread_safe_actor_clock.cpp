@@ -25,141 +25,340 @@
 
 namespace caf::detail {
 
+namespace {
+
+// Returns the ID of the actor that may cancel `x` or 0 if `x` is not
+// cancellable.
+actor_id owner_of(const simple_actor_clock::delayed_event& x) {
+  using clock = simple_actor_clock;
+  switch (x.subtype) {
+    case clock::ordinary_timeout_type:
+      return static_cast<const clock::ordinary_timeout&>(x).self->id();
+    case clock::multi_timeout_type:
+      return static_cast<const clock::multi_timeout&>(x).self->id();
+    case clock::request_timeout_type:
+      return static_cast<const clock::request_timeout&>(x).self->id();
+    default:
+      return 0;
+  }
+}
+
+} // namespace
+
+thread_safe_actor_clock::thread_safe_actor_clock()
+  : wheel_(to_tick(clock_type::now(), false)) {
+  // nop
+}
+
+thread_safe_actor_clock::~thread_safe_actor_clock() {
+  // Discard events that never reached the clock thread.
+  for (auto& queue : queues_) {
+    auto ptr = queue.head.exchange(nullptr, std::memory_order_acquire);
+    while (ptr != nullptr) {
+      auto next = ptr->next;
+      delete ptr;
+      ptr = next;
+    }
+  }
+  clear();
+}
+
 void thread_safe_actor_clock::set_ordinary_timeout(time_point t,
                                                    abstract_actor* self,
                                                    std::string type,
                                                    uint64_t id) {
-  push(new ordinary_timeout(t, self->ctrl(), type, id));
+  push(self->id(), new ordinary_timeout(t, self->ctrl(), type, id));
 }
 
-void thread_safe_actor_clock::set_request_timeout(time_point t,
-                                                  abstract_actor* self,
-                                                  message_id id) {
-  push(new request_timeout(t, self->ctrl(), id));
+void thread_safe_actor_clock::set_request_timeout(
+  time_point t, abstract_actor* self, message_id id,
+  request_timeout_token_ptr token) {
+  push(self->id(), new request_timeout(t, self->ctrl(), id, std::move(token)));
 }
 
 void thread_safe_actor_clock::set_multi_timeout(time_point t,
                                                 abstract_actor* self,
                                                 std::string type, uint64_t id) {
-  push(new multi_timeout(t, self->ctrl(), type, id));
+  push(self->id(), new multi_timeout(t, self->ctrl(), type, id));
 }
 
 void thread_safe_actor_clock::cancel_ordinary_timeout(abstract_actor* self,
                                                       std::string type) {
-  push(new ordinary_timeout_cancellation(self->id(), type));
+  push(self->id(), new ordinary_timeout_cancellation(self->id(), type));
 }
 
 void thread_safe_actor_clock::cancel_request_timeout(abstract_actor* self,
                                                      message_id id) {
-  push(new request_timeout_cancellation(self->id(), id));
+  push(self->id(), new request_timeout_cancellation(self->id(), id));
 }
 
 void thread_safe_actor_clock::cancel_timeouts(abstract_actor* self) {
-  push(new timeouts_cancellation(self->id()));
+  push(self->id(), new timeouts_cancellation(self->id()));
 }
 
 void thread_safe_actor_clock::schedule_message(time_point t,
                                                strong_actor_ptr receiver,
                                                mailbox_element_ptr content) {
-  push(new actor_msg(t, std::move(receiver), std::move(content)));
+  auto key = receiver ? receiver->id() : 0;
+  push(key, new actor_msg(t, std::move(receiver), std::move(content)));
 }
 
 void thread_safe_actor_clock::schedule_message(time_point t, group target,
                                                strong_actor_ptr sender,
                                                message content) {
+  auto key = sender ? sender->id() : 0;
   auto ptr = new group_msg(t, std::move(target), std::move(sender),
                            std::move(content));
-  push(ptr);
+  push(key, ptr);
 }
 
 void thread_safe_actor_clock::cancel_all() {
-  push(new drop_all);
+  push(0, new drop_all);
 }
 
 void thread_safe_actor_clock::run_dispatch_loop() {
   for (;;) {
-    // Wait until queue is non-empty.
-    if (schedule_.empty()) {
-      queue_.wait_nonempty();
-    } else {
-      auto t = schedule_.begin()->second->due;
-      if (!queue_.wait_nonempty(t)) {
-        // Handle timeout by shipping timed-out events and starting anew.
-        trigger_expired_timeouts();
-        continue;
-      }
+    if (!drain())
+      return;
+    auto trigger_fn = [this](timing_wheel_node* x) {
+      trigger(static_cast<delayed_event*>(x));
+    };
+    wheel_.advance(to_tick(now(), false), trigger_fn);
+    // Go to sleep unless new events arrived in the meantime.
+    auto key = ready_.prepare_wait();
+    auto has_events = [this] {
+      for (auto& queue : queues_)
+        if (queue.head.load(std::memory_order_relaxed) != nullptr)
+          return true;
+      return false;
+    };
+    if (has_events()) {
+      ready_.cancel_wait();
+      continue;
     }
-    // Push all elements from the queue to the events buffer.
-    auto i = events_.begin();
-    auto e = queue_.get_all(i);
-    for (; i != e; ++i) {
-      auto& x = *i;
-      CAF_ASSERT(x != nullptr);
-      switch (x->subtype) {
-        case ordinary_timeout_cancellation_type: {
-          handle(static_cast<ordinary_timeout_cancellation&>(*x));
-          break;
-        }
-        case request_timeout_cancellation_type: {
-          handle(static_cast<request_timeout_cancellation&>(*x));
-          break;
-        }
-        case timeouts_cancellation_type: {
-          handle(static_cast<timeouts_cancellation&>(*x));
-          break;
-        }
-        case drop_all_type: {
-          schedule_.clear();
-          actor_lookup_.clear();
-          break;
-        }
-        case shutdown_type: {
-          schedule_.clear();
-          actor_lookup_.clear();
-          // Call it a day.
-          return;
-        }
-        case ordinary_timeout_type: {
-          auto dptr = static_cast<ordinary_timeout*>(x.release());
-          add_schedule_entry(std::unique_ptr<ordinary_timeout>{dptr});
-          break;
-        }
-        case multi_timeout_type: {
-          auto dptr = static_cast<multi_timeout*>(x.release());
-          add_schedule_entry(std::unique_ptr<multi_timeout>{dptr});
-          break;
-        }
-        case request_timeout_type: {
-          auto dptr = static_cast<request_timeout*>(x.release());
-          add_schedule_entry(std::unique_ptr<request_timeout>{dptr});
-          break;
-        }
-        case actor_msg_type: {
-          auto dptr = static_cast<actor_msg*>(x.release());
-          add_schedule_entry(std::unique_ptr<actor_msg>{dptr});
-          break;
+    if (auto tick = wheel_.next_expiration())
+      ready_.wait_until(key, from_tick(*tick));
+    else
+      ready_.wait(key);
+  }
+}
+
+void thread_safe_actor_clock::cancel_dispatch_loop() {
+  push(0, new shutdown);
+}
+
+uint64_t thread_safe_actor_clock::to_tick(time_point t,
+                                          bool round_up) noexcept {
+  auto ticks = t.time_since_epoch().count();
+  auto res = resolution.count();
+  if (round_up)
+    ticks += res - 1;
+  return static_cast<uint64_t>(ticks / res);
+}
+
+thread_safe_actor_clock::time_point
+thread_safe_actor_clock::from_tick(uint64_t tick) noexcept {
+  return time_point{resolution * static_cast<duration_type::rep>(tick)};
+}
+
+void thread_safe_actor_clock::push(actor_id key, event* ptr) {
+  auto& head = queues_[key % num_queues].head;
+  auto top = head.load(std::memory_order_relaxed);
+  do {
+    ptr->next = top;
+  } while (!head.compare_exchange_weak(top, ptr, std::memory_order_release,
+                                       std::memory_order_relaxed));
+  ready_.notify_one();
+}
+
+bool thread_safe_actor_clock::drain() {
+  for (auto& queue : queues_) {
+    auto ptr = queue.head.exchange(nullptr, std::memory_order_acquire);
+    // The submission queues are stacks. Reversing the list restores the order
+    // in which producers pushed the events.
+    event* first = nullptr;
+    while (ptr != nullptr) {
+      auto next = ptr->next;
+      ptr->next = first;
+      first = ptr;
+      ptr = next;
+    }
+    while (first != nullptr) {
+      unique_event_ptr x{first};
+      first = first->next;
+      x->next = nullptr;
+      if (!handle(std::move(x))) {
+        while (first != nullptr) {
+          auto next = first->next;
+          delete first;
+          first = next;
         }
-        case group_msg_type: {
-          auto dptr = static_cast<group_msg*>(x.release());
-          add_schedule_entry(std::unique_ptr<group_msg>{dptr});
-          break;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool thread_safe_actor_clock::handle(unique_event_ptr x) {
+  CAF_ASSERT(x != nullptr);
+  switch (x->subtype) {
+    case ordinary_timeout_type: {
+      auto dptr = static_cast<ordinary_timeout*>(x.release());
+      // Only one ordinary timeout per type can be active.
+      auto aid = dptr->self->id();
+      auto i = actors_.find(aid);
+      if (i != actors_.end()) {
+        auto y = i->second.first;
+        while (y != nullptr && y->subtype == ordinary_timeout_type) {
+          if (static_cast<ordinary_timeout*>(y)->type == dptr->type) {
+            erase(y);
+            break;
+          }
+          y = y->actor_next;
         }
-        default: {
-          CAF_LOG_ERROR("unexpected event type");
+      }
+      link(aid, dptr, true);
+      add(dptr);
+      break;
+    }
+    case multi_timeout_type: {
+      auto dptr = static_cast<multi_timeout*>(x.release());
+      link(dptr->self->id(), dptr, false);
+      add(dptr);
+      break;
+    }
+    case request_timeout_type: {
+      auto dptr = static_cast<request_timeout*>(x.release());
+      auto aid = dptr->self->id();
+      request_key key{aid, dptr->id.integer_value()};
+      auto i = requests_.find(key);
+      if (i != requests_.end())
+        erase(i->second);
+      requests_.emplace(key, dptr);
+      link(aid, dptr, false);
+      add(dptr);
+      break;
+    }
+    case actor_msg_type:
+    case group_msg_type:
+      add(static_cast<delayed_event*>(x.release()));
+      break;
+    case ordinary_timeout_cancellation_type: {
+      auto& dref = static_cast<ordinary_timeout_cancellation&>(*x);
+      auto i = actors_.find(dref.aid);
+      if (i == actors_.end())
+        break;
+      auto y = i->second.first;
+      while (y != nullptr && y->subtype == ordinary_timeout_type) {
+        if (static_cast<ordinary_timeout*>(y)->type == dref.type) {
+          erase(y);
           break;
         }
+        y = y->actor_next;
+      }
+      break;
+    }
+    case request_timeout_cancellation_type: {
+      auto& dref = static_cast<request_timeout_cancellation&>(*x);
+      auto i = requests_.find(request_key{dref.aid, dref.id.integer_value()});
+      if (i != requests_.end())
+        erase(i->second);
+      break;
+    }
+    case timeouts_cancellation_type: {
+      auto& dref = static_cast<timeouts_cancellation&>(*x);
+      auto i = actors_.find(dref.aid);
+      if (i == actors_.end())
+        break;
+      // Erasing the last event also erases the map entry.
+      auto y = i->second.first;
+      while (y != nullptr) {
+        auto next = y->actor_next;
+        erase(y);
+        y = next;
       }
-      x.reset();
+      break;
     }
+    case drop_all_type:
+      clear();
+      break;
+    case shutdown_type:
+      clear();
+      // Call it a day.
+      return false;
+    default:
+      CAF_LOG_ERROR("unexpected event type");
+      break;
   }
+  return true;
 }
 
-void thread_safe_actor_clock::cancel_dispatch_loop() {
-  push(new shutdown);
+void thread_safe_actor_clock::add(delayed_event* x) {
+  wheel_.insert(x, to_tick(x->due, true));
+}
+
+void thread_safe_actor_clock::link(actor_id aid, delayed_event* x,
+                                   bool front) {
+  auto& entry = actors_[aid];
+  if (entry.first == nullptr) {
+    entry.first = x;
+    entry.last = x;
+  } else if (front) {
+    x->actor_next = entry.first;
+    entry.first->actor_prev = x;
+    entry.first = x;
+  } else {
+    x->actor_prev = entry.last;
+    entry.last->actor_next = x;
+    entry.last = x;
+  }
+}
+
+void thread_safe_actor_clock::unlink(delayed_event* x) {
+  auto aid = owner_of(*x);
+  if (aid == 0)
+    return;
+  if (x->subtype == request_timeout_type) {
+    auto& dref = static_cast<request_timeout&>(*x);
+    requests_.erase(request_key{aid, dref.id.integer_value()});
+  }
+  auto i = actors_.find(aid);
+  CAF_ASSERT(i != actors_.end());
+  auto& entry = i->second;
+  if (x->actor_prev != nullptr)
+    x->actor_prev->actor_next = x->actor_next;
+  else
+    entry.first = x->actor_next;
+  if (x->actor_next != nullptr)
+    x->actor_next->actor_prev = x->actor_prev;
+  else
+    entry.last = x->actor_prev;
+  x->actor_prev = nullptr;
+  x->actor_next = nullptr;
+  if (entry.first == nullptr)
+    actors_.erase(i);
+}
+
+void thread_safe_actor_clock::erase(delayed_event* x) {
+  if (timing_wheel::linked(x))
+    wheel_.erase(x);
+  unlink(x);
+  delete x;
+}
+
+void thread_safe_actor_clock::trigger(delayed_event* x) {
+  unique_event_ptr guard{x};
+  unlink(x);
+  ship(*x);
 }
 
-void thread_safe_actor_clock::push(event* ptr) {
-  queue_.push_back(unique_event_ptr{ptr});
+void thread_safe_actor_clock::clear() {
+  wheel_.clear([](timing_wheel_node* x) {
+    delete static_cast<delayed_event*>(x);
+  });
+  actors_.clear();
+  requests_.clear();
 }
 
 } // namespace caf::detail
@@ -0,0 +1,177 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/timing_wheel.hpp"
+
+#include "caf/config.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+constexpr uint64_t slot_mask = timing_wheel::num_slots - 1;
+
+constexpr size_t top_level = timing_wheel::num_levels - 1;
+
+constexpr uint64_t top_slot_range = uint64_t{1}
+                                    << (timing_wheel::slot_bits * top_level);
+
+size_t count_trailing_zeros(uint64_t x) noexcept {
+  CAF_ASSERT(x != 0);
+#if defined(CAF_GCC) || defined(CAF_CLANG)
+  return static_cast<size_t>(__builtin_ctzll(x));
+#else
+  size_t result = 0;
+  while ((x & 1) == 0) {
+    x >>= 1;
+    ++result;
+  }
+  return result;
+#endif
+}
+
+} // namespace
+
+timing_wheel::timing_wheel(uint64_t now) noexcept : elapsed_(now), size_(0) {
+  occupied_.fill(0);
+}
+
+optional<uint64_t> timing_wheel::next_expiration() const noexcept {
+  if (slots_[expired_slot].head != nullptr)
+    return elapsed_;
+  for (size_t level = 0; level < num_levels; ++level)
+    if (occupied_[level] != 0)
+      return deadline(level);
+  return none;
+}
+
+void timing_wheel::insert(timing_wheel_node* x, uint64_t tick) noexcept {
+  CAF_ASSERT(!linked(x));
+  x->wheel_tick = tick;
+  link(x, slot_of(x));
+  ++size_;
+}
+
+void timing_wheel::erase(timing_wheel_node* x) noexcept {
+  CAF_ASSERT(linked(x));
+  unlink(x);
+  --size_;
+}
+
+size_t timing_wheel::slot_of(const timing_wheel_node* x) const noexcept {
+  auto tick = x->wheel_tick;
+  if (tick <= elapsed_)
+    return expired_slot;
+  // Nodes beyond the range of the wheel go to the slot on the highest level
+  // that the wheel visits last. They move back to that slot until they are in
+  // range. This also makes sure that no node on the highest level shares its
+  // slot with the current position of the wheel.
+  if (tick - elapsed_ >= max_ticks - top_slot_range) {
+    auto pos = (elapsed_ >> (slot_bits * top_level)) & slot_mask;
+    return top_level * num_slots + ((pos + slot_mask) & slot_mask);
+  }
+  // The highest bit that differs between the current tick and the node's tick
+  // determines the level.
+  auto masked = (elapsed_ ^ tick) | slot_mask;
+  size_t level = 0;
+  while (level < top_level && (masked >> (slot_bits * (level + 1))) != 0)
+    ++level;
+  return level * num_slots + ((tick >> (slot_bits * level)) & slot_mask);
+}
+
+uint64_t timing_wheel::deadline(size_t level) const noexcept {
+  CAF_ASSERT(occupied_[level] != 0);
+  auto shift = slot_bits * level;
+  auto slot_range = uint64_t{1} << shift;
+  auto level_range = slot_range << slot_bits;
+  auto pos = (elapsed_ >> shift) & slot_mask;
+  // Rotate the bitmap to find the first occupied slot at or after `pos`.
+  auto bits = occupied_[level];
+  if (pos != 0)
+    bits = (bits >> pos) | (bits << (num_slots - pos));
+  auto index = (pos + count_trailing_zeros(bits)) & slot_mask;
+  auto result = (elapsed_ & ~(level_range - 1)) + index * slot_range;
+  // Slots before the current position belong to the next rotation.
+  if (index < pos)
+    result += level_range;
+  return result;
+}
+
+void timing_wheel::link(timing_wheel_node* x, size_t pos) noexcept {
+  auto& dst = slots_[pos];
+  x->wheel_slot = pos;
+  x->wheel_prev = dst.tail;
+  x->wheel_next = nullptr;
+  if (dst.tail != nullptr)
+    dst.tail->wheel_next = x;
+  else
+    dst.head = x;
+  dst.tail = x;
+  if (pos != expired_slot)
+    occupied_[pos / num_slots] |= uint64_t{1} << (pos % num_slots);
+}
+
+void timing_wheel::unlink(timing_wheel_node* x) noexcept {
+  auto pos = x->wheel_slot;
+  auto& src = slots_[pos];
+  if (x->wheel_prev != nullptr)
+    x->wheel_prev->wheel_next = x->wheel_next;
+  else
+    src.head = x->wheel_next;
+  if (x->wheel_next != nullptr)
+    x->wheel_next->wheel_prev = x->wheel_prev;
+  else
+    src.tail = x->wheel_prev;
+  if (src.head == nullptr && pos != expired_slot)
+    occupied_[pos / num_slots] &= ~(uint64_t{1} << (pos % num_slots));
+  reset(x);
+}
+
+timing_wheel_node* timing_wheel::pop_expired() noexcept {
+  auto x = slots_[expired_slot].head;
+  if (x != nullptr)
+    erase(x);
+  return x;
+}
+
+bool timing_wheel::cascade(uint64_t now) noexcept {
+  // Slots on lower levels always expire before slots on higher levels.
+  for (size_t level = 0; level < num_levels; ++level) {
+    if (occupied_[level] == 0)
+      continue;
+    auto t = deadline(level);
+    if (t > now)
+      return false;
+    if (t > elapsed_)
+      elapsed_ = t;
+    auto index = (t >> (slot_bits * level)) & slot_mask;
+    auto pos = level * num_slots + index;
+    auto x = slots_[pos].head;
+    slots_[pos] = slot{};
+    occupied_[level] &= ~(uint64_t{1} << index);
+    while (x != nullptr) {
+      auto next = x->wheel_next;
+      link(x, slot_of(x));
+      x = next;
+    }
+    return true;
+  }
+  return false;
+}
+
+} // namespace caf::detail
@@ -29,6 +29,7 @@
 #include "caf/default_attachable.hpp"
 #include "caf/exit_reason.hpp"
 #include "caf/logger.hpp"
+#include "caf/make_counted.hpp"
 #include "caf/resumable.hpp"
 #include "caf/scheduler.hpp"
 #include "caf/sec.hpp"
@@ -65,7 +66,9 @@ void local_actor::request_response_timeout(timespan timeout, message_id mid) {
     return;
   auto t = clock().now();
   t += timeout;
-  clock().set_request_timeout(t, this, mid.response_id());
+  auto token = make_counted<detail::request_timeout_token>();
+  pending_timeouts_[mid.response_id()] = token;
+  clock().set_request_timeout(t, this, mid.response_id(), std::move(token));
 }
 
 void local_actor::monitor(abstract_actor* ptr, message_priority priority) {
@@ -135,6 +138,7 @@ bool local_actor::cleanup(error&& fail_state, execution_unit* host) {
   CAF_LOG_TERMINATE_EVENT(this, fail_state);
   monitorable_actor::cleanup(std::move(fail_state), host);
   clock().cancel_timeouts(this);
+  pending_timeouts_.clear();
   return true;
 }
 
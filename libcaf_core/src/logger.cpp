@@ -36,6 +36,7 @@
 #include "caf/actor_system_config.hpp"
 #include "caf/config.hpp"
 #include "caf/defaults.hpp"
+#include "caf/detail/binary_log.hpp"
 #include "caf/detail/get_process_id.hpp"
 #include "caf/detail/pretty_type_name.hpp"
 #include "caf/detail/set_thread_name.hpp"
@@ -182,7 +183,8 @@ logger::config::config()
     file_verbosity(CAF_LOG_LEVEL),
     console_verbosity(CAF_LOG_LEVEL),
     inline_output(false),
-    console_coloring(false) {
+    console_coloring(false),
+    binary_output(false) {
   // nop
 }
 
@@ -203,6 +205,15 @@ logger::event::event(unsigned lvl, unsigned line, string_view cat,
   // nop
 }
 
+logger::event::event(unsigned lvl, unsigned line, string_view cat,
+                     string_view full_fun, string_view fun, string_view fn,
+                     detail::encoded_log_args args, std::thread::id t,
+                     actor_id a, timestamp ts)
+  : event(lvl, line, cat, full_fun, fun, fn, std::move(args.bytes),
+          std::move(t), a, ts) {
+  encoded = true;
+}
+
 logger::line_builder::line_builder() {
   // nop
 }
@@ -254,7 +265,7 @@ void logger::log(event&& x) {
   if (cfg_.inline_output)
     handle_event(x);
   else
-    queue_.push_back(std::move(x));
+    queue_.push(std::move(x));
 }
 
 void logger::set_current_actor_system(actor_system* x) {
@@ -265,18 +276,25 @@ logger* logger::current_logger() {
   return current_logger_ptr.get();
 }
 
-bool logger::accepts(unsigned level, string_view cname) {
+bool logger::accepts(unsigned level, string_view cname) const {
+  return accepts(level, detail::log_component_id(cname));
+}
+
+bool logger::accepts(unsigned level, uint64_t component_id) const {
   if (level > cfg_.verbosity)
     return false;
-  return !std::any_of(component_blacklist.begin(), component_blacklist.end(),
-                      [=](string_view name) { return name == cname; });
+  return std::find(component_blacklist_ids_.begin(),
+                   component_blacklist_ids_.end(), component_id)
+         == component_blacklist_ids_.end();
 }
 
-logger::logger(actor_system& sys) : system_(sys), t0_(make_timestamp()) {
+logger::logger(actor_system& sys)
+  : system_(sys), t0_(make_timestamp()) {
   // nop
 }
 
 logger::~logger() {
+  detail::log_site::remove_logger(this);
   stop();
   // tell system our dtor is done
   std::unique_lock<std::mutex> guard{system_.logger_dtor_mtx_};
@@ -291,6 +309,8 @@ void logger::init(actor_system_config& cfg) {
   auto blacklist = get_if<string_list>(&cfg, "logger.component-blacklist");
   if (blacklist)
     component_blacklist = move_if_optional(blacklist);
+  for (auto& name : component_blacklist)
+    component_blacklist_ids_.emplace_back(detail::log_component_id(name));
   // Parse the configured log level. We only store a string_view to the
   // verbosity levels, so we make sure we actually get a string pointer here
   // (and not an optional<string>).
@@ -321,9 +341,13 @@ void logger::init(actor_system_config& cfg) {
     = parse_format(get_or(cfg, "logger.file-format", lg::file_format));
   console_format_
     = parse_format(get_or(cfg, "logger.console-format", lg::console_format));
+  // Allocate the event queue before starting the logger thread.
+  queue_.resize(get_or(cfg, "logger.queue-size", lg::queue_size));
   // Set flags.
   if (get_or(cfg, "logger.inline-output", false))
     cfg_.inline_output = true;
+  if (get_or(cfg, "logger.binary-output", false))
+    cfg_.binary_output = true;
   auto con = get_or(cfg, "logger.console", lg::console);
   if (con == "colored") {
     cfg_.console_coloring = true;
@@ -332,16 +356,25 @@ void logger::init(actor_system_config& cfg) {
     cfg_.console_verbosity = CAF_LOG_LEVEL_QUIET;
     cfg_.verbosity = cfg_.file_verbosity;
   }
+  // Enable all log sites that pass our filter from now on.
+  detail::log_site::add_logger(this);
 }
 
 bool logger::open_file() {
   if (file_verbosity() == CAF_LOG_LEVEL_QUIET || file_name_.empty())
     return false;
-  file_.open(file_name_, std::ios::out | std::ios::app);
+  auto mode = std::ios::out | std::ios::app;
+  if (cfg_.binary_output)
+    mode |= std::ios::binary;
+  file_.open(file_name_, mode);
   if (!file_) {
     std::cerr << "unable to open log file " << file_name_ << std::endl;
     return false;
   }
+  if (cfg_.binary_output) {
+    binary_writer_.reset(new detail::binary_log_writer);
+    binary_writer_->write_header(file_, t0_);
+  }
   return true;
 }
 
@@ -502,6 +535,13 @@ std::string json_vector_timestamp(const std::vector<size_t>& vstamp) {
   oss << '}';
   return oss.str();
 }
+
+void render_message(std::ostream& out, const logger::event& x) {
+  if (x.encoded)
+    out << detail::render_log_args(x.message);
+  else
+    out << x.message;
+}
 } // namespace
 
 // TODO: HERE: The log entry is actually written here.
@@ -526,7 +566,7 @@ void logger::render(std::ostream& out, const line_format& lf,
       case date_field:         render_date(out, x.tstamp);         break;
       case file_field:         out << x.file_name;                 break;
       case line_field:         out << x.line_number;               break;
-      case message_field:      out << x.message;                   break;
+      case message_field:      render_message(out, x);             break;
       case method_field:       render_fun_name(out, x);            break;
       case newline_field:      out << std::endl;                   break;
       case priority_field:     out << log_level_name[x.level];     break;
@@ -603,25 +643,39 @@ void logger::run() {
   if (!open_file() && console_verbosity() == CAF_LOG_LEVEL_QUIET)
     return;
   log_first_line();
-  // Loop until receiving an empty message.
-  for (;;) {
-    // Handle current head of the queue.
-    auto& e = queue_.front();
+  // Loop until receiving an empty message, handling all events that became
+  // available at once in a single batch.
+  auto done = false;
+  auto f = [&](event& e) {
+    if (done)
+      return;
     if (e.message.empty()) {
       log_last_line();
+      done = true;
       return;
     }
     handle_event(e);
-    // Prepare next iteration.
-    queue_.pop_front();
+  };
+  do {
     queue_.wait_nonempty();
-  }
+    queue_.consume(f);
+  } while (!done);
 }
 
 void logger::handle_file_event(const event& x) {
   // Print to file if available.
-  if (file_ && x.level <= file_verbosity())
+  if (!file_ || x.level > file_verbosity())
+    return;
+  if (!binary_writer_) {
     render(file_, file_format_, x);
+  } else if (x.encoded) {
+    binary_writer_->write(file_, x);
+  } else {
+    auto y = x;
+    y.message = (detail::log_arg_encoder{} << x.message).get().bytes;
+    y.encoded = true;
+    binary_writer_->write(file_, y);
+  }
 }
 
 void logger::handle_console_event(const event& x) {
@@ -655,8 +709,20 @@ void logger::handle_console_event(const event& x) {
   }
 }
 
-void logger::handle_event(const event& x) {
-  handle_file_event(x);
+void logger::handle_event(event& x) {
+  // Binary log files store the encoded arguments as-is. Hence, we only render
+  // the message to text if the event also goes to a text file or the console.
+  if (binary_writer_) {
+    handle_file_event(x);
+    if (x.level > console_verbosity())
+      return;
+  }
+  if (x.encoded) {
+    x.message = detail::render_log_args(x.message);
+    x.encoded = false;
+  }
+  if (!binary_writer_)
+    handle_file_event(x);
   handle_console_event(x);
 }
 
@@ -674,6 +740,7 @@ void logger::log_first_line() {
   namespace lg = defaults::logger;
   e.message = make_message("logger.file-verbosity",
                            to_string(lg::file_verbosity));
+  e.encoded = false;
   handle_file_event(e);
   e.message = make_message("logger.console-verbosity",
                            to_string(lg::console_verbosity));
@@ -741,7 +808,7 @@ void logger::stop() {
   if (!thread_.joinable())
     return;
   // A default-constructed event causes the logger to shutdown.
-  queue_.push_back(event{});
+  queue_.push(event{});
   thread_.join();
 }
 
@@ -44,17 +44,30 @@ work_stealing::worker_data::worker_data(scheduler::abstract_coordinator* p)
         timespan{0}},
        {CONFIG("moderate-poll-attempts", moderate_poll_attempts), 1,
         CONFIG("moderate-steal-interval", moderate_steal_interval),
-        CONFIG("moderate-sleep-duration", moderate_sleep_duration)},
-       {1, 0, CONFIG("relaxed-steal-interval", relaxed_steal_interval),
-        CONFIG("relaxed-sleep-duration", relaxed_sleep_duration)}}} {
+        CONFIG("moderate-sleep-duration", moderate_sleep_duration)}}},
+    victims(make_victims(p)) {
   // nop
 }
 
 work_stealing::worker_data::worker_data(const worker_data& other)
   : rengine(std::random_device{}()),
     uniform(other.uniform),
-    strategies(other.strategies) {
+    strategies(other.strategies),
+    victims(other.victims) {
   // nop
 }
 
+work_stealing::victims_ptr
+work_stealing::make_victims(scheduler::abstract_coordinator* p) {
+  if (p->num_workers() < 2
+      || !get_or(p->config(), "scheduler.pin-workers",
+                 defaults::scheduler::pin_workers)
+      || !CONFIG("topology-aware", topology_aware))
+    return nullptr;
+  auto topology = detail::cpu_topology::discover();
+  using vec_type = std::vector<detail::cpu_topology::victim_groups>;
+  return std::make_shared<vec_type>(
+    topology.make_victim_groups(p->num_workers()));
+}
+
 } // namespace caf::policy
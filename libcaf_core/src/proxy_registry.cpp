@@ -27,10 +27,19 @@
 #include "caf/serializer.hpp"
 
 #include "caf/actor_registry.hpp"
+#include "caf/locks.hpp"
 #include "caf/logger.hpp"
 
 namespace caf {
 
+namespace {
+
+using exclusive_guard = unique_lock<detail::shared_spinlock>;
+
+using shared_guard = shared_lock<detail::shared_spinlock>;
+
+} // namespace
+
 proxy_registry::backend::~backend() {
   // nop
 }
@@ -45,13 +54,13 @@ proxy_registry::~proxy_registry() {
 }
 
 size_t proxy_registry::count_proxies(const node_id& node) const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = proxies_.find(node);
   return i != proxies_.end() ? i->second.size() : 0;
 }
 
 strong_actor_ptr proxy_registry::get(const node_id& node, actor_id aid) const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = proxies_.find(node);
   if (i == proxies_.end())
     return nullptr;
@@ -61,7 +70,10 @@ strong_actor_ptr proxy_registry::get(const node_id& node, actor_id aid) const {
 
 strong_actor_ptr proxy_registry::get_or_put(const node_id& nid, actor_id aid) {
   CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(aid));
-  std::unique_lock<std::mutex> guard{mtx_};
+  // Fast path: most calls find an existing proxy.
+  if (auto result = get(nid, aid))
+    return result;
+  exclusive_guard guard{mtx_};
   auto& result = proxies_[nid][aid];
   if (!result)
     result = backend_.make_proxy(nid, aid);
@@ -73,7 +85,7 @@ proxy_registry::get_all(const node_id& node) const {
   // Reserve at least some memory outside of the critical section.
   std::vector<strong_actor_ptr> result;
   result.reserve(128);
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = proxies_.find(node);
   if (i != proxies_.end())
     for (auto& kvp : i->second)
@@ -82,7 +94,7 @@ proxy_registry::get_all(const node_id& node) const {
 }
 
 bool proxy_registry::empty() const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   return proxies_.empty();
 }
 
@@ -92,7 +104,7 @@ void proxy_registry::erase(const node_id& nid) {
   proxy_map tmp;
   {
     using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
+    exclusive_guard guard{mtx_};
     auto i = proxies_.find(nid);
     if (i == proxies_.end())
       return;
@@ -110,7 +122,7 @@ void proxy_registry::erase(const node_id& nid, actor_id aid, error rsn) {
   strong_actor_ptr erased_proxy;
   {
     using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
+    exclusive_guard guard{mtx_};
     auto i = proxies_.find(nid);
     if (i != proxies_.end()) {
       auto& submap = i->second;
@@ -134,7 +146,7 @@ void proxy_registry::clear() {
   std::unordered_map<node_id, proxy_map> tmp;
   {
     using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
+    exclusive_guard guard{mtx_};
     swap(proxies_, tmp);
   }
   // Call kill_proxy outside the critical section.
@@ -34,6 +34,9 @@ invoke_message_result raw_event_based_actor::consume(mailbox_element& x) {
   CAF_BEFORE_PROCESSING(this, x);
   // Wrap the actual body for the function.
   auto body = [this, &x] {
+    // any response renders the pending request timeout obsolete
+    if (x.mid.is_response())
+      response_arrived(x.mid);
     // short-circuit awaited responses
     if (!awaited_responses_.empty()) {
       auto& pr = awaited_responses_.front();
@@ -108,6 +108,38 @@ void response_promise::deliver_impl(message msg) {
   CAF_LOG_WARNING("malformed response promise: self != nullptr && !pending()");
 }
 
+void response_promise::deliver_impl(mailbox_element_ptr ptr) {
+  CAF_LOG_TRACE(CAF_ARG2("content", ptr->content()));
+  if (self_ == nullptr) {
+    CAF_LOG_DEBUG("drop response: invalid promise");
+    return;
+  }
+  auto dptr = self_dptr();
+  if (!stages_.empty()) {
+    auto next = std::move(stages_.back());
+    stages_.pop_back();
+    ptr->sender = std::move(source_);
+    ptr->mid = id_;
+    ptr->stages = std::move(stages_);
+    if (next) {
+      CAF_BEFORE_SENDING(dptr, *ptr);
+      next->enqueue(std::move(ptr), dptr->context());
+    }
+    self_.reset();
+    return;
+  }
+  if (source_) {
+    ptr->sender = self_;
+    ptr->mid = id_.response_id();
+    CAF_BEFORE_SENDING(dptr, *ptr);
+    source_->enqueue(std::move(ptr), dptr->context());
+    self_.reset();
+    source_.reset();
+    return;
+  }
+  CAF_LOG_WARNING("malformed response promise: self != nullptr && !pending()");
+}
+
 void response_promise::delegate_impl(abstract_actor* receiver, message msg) {
   CAF_LOG_TRACE(CAF_ARG(msg));
   if (receiver == nullptr) {
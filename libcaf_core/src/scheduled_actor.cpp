@@ -128,7 +128,8 @@ scheduled_actor::scheduled_actor(actor_config& cfg)
     down_handler_(default_down_handler),
     node_down_handler_(default_node_down_handler),
     exit_handler_(default_exit_handler),
-    private_thread_(nullptr)
+    private_thread_(nullptr),
+    urgent_pending_(false)
 #ifndef CAF_NO_EXCEPTIONS
     ,
     exception_handler_(default_exception_handler)
@@ -191,8 +192,11 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr, execution_unit* eu) {
       break;
     }
     case intrusive::inbox_result::success:
-      // enqueued to a running actors' mailbox; nothing to do
+      // enqueued to a running actors' mailbox; urgent messages must not wait
+      // for the current batch of messages
       CAF_LOG_ACCEPT_EVENT(false);
+      if (mid.category() == message_id::urgent_message_category)
+        urgent_pending_.store(true, std::memory_order_release);
       break;
   }
 }
@@ -373,8 +377,11 @@ scheduled_actor::mailbox_visitor::operator()(mailbox_element& x) {
     case activation_result::terminated:
       return intrusive::task_result::stop;
     case activation_result::success:
-      return ++handled_msgs < max_throughput ? intrusive::task_result::resume
-                                             : intrusive::task_result::stop_all;
+      // Start a new round for fetching urgent messages from the inbox.
+      return ++handled_msgs < max_throughput
+                 && !self->urgent_pending_.load(std::memory_order_acquire)
+               ? intrusive::task_result::resume
+               : intrusive::task_result::stop_all;
     case activation_result::skipped:
       return intrusive::task_result::skip;
     default:
@@ -404,12 +411,18 @@ resumable::resume_result scheduled_actor::resume(execution_unit* ctx,
   };
   mailbox_visitor f{this, handled_msgs, max_throughput};
   mailbox_element_ptr ptr;
-  // Timeout for calling `advance_streams`.
+  // Actors without streams consume ordinary messages in large batches. This
+  // amortizes fetching from the inbox, the DRR bookkeeping and clock reads over
+  // many messages. Stream managers need small rounds for emitting credit and
+  // batches in time. An urgent message that arrives during a batch ends the
+  // round early, so that the next round fetches it right away.
+  auto batch_size = home_system().scheduler().mailbox_batch_size();
   while (handled_msgs < max_throughput) {
     CAF_LOG_DEBUG("start new DRR round");
-    // TODO: maybe replace '3' with configurable / adaptive value?
+    auto quantum = stream_managers_.empty() ? batch_size : size_t{3};
+    urgent_pending_.store(false, std::memory_order_relaxed);
     // Dispatch on the different message categories in our mailbox.
-    if (!mailbox_.new_round(3, f).consumed_items) {
+    if (!mailbox_.new_round(quantum, f).consumed_items) {
       reset_timeouts_if_needed();
       if (mailbox().try_block())
         return resumable::awaiting_message;
@@ -419,9 +432,11 @@ resumable::resume_result scheduled_actor::resume(execution_unit* ctx,
       return resumable::done;
     }
     // Advance streams, i.e., try to generating credit or to emit batches.
-    auto now = clock().now();
-    if (now >= tout)
-      tout = advance_streams(now);
+    if (!stream_managers_.empty()) {
+      auto now = clock().now();
+      if (now >= tout)
+        tout = advance_streams(now);
+    }
   }
   CAF_LOG_DEBUG("max throughput reached");
   reset_timeouts_if_needed();
@@ -648,6 +663,9 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
       return f(in.content()) != none;
     };
     auto select_invoke_fun = [&]() -> fun_t { return ordinary_invoke; };
+    // Any response renders the pending request timeout obsolete.
+    if (x.mid.is_response())
+      response_arrived(x.mid);
     // Short-circuit awaited responses.
     if (!awaited_responses_.empty()) {
       auto invoke = select_invoke_fun();
@@ -18,6 +18,7 @@
 
 #include "caf/scheduler/abstract_coordinator.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -247,6 +248,9 @@ void abstract_coordinator::start() {
 void abstract_coordinator::init(actor_system_config& cfg) {
   namespace sr = defaults::scheduler;
   max_throughput_ = get_or(cfg, "scheduler.max-throughput", sr::max_throughput);
+  mailbox_batch_size_ = std::max(get_or(cfg, "scheduler.mailbox-batch-size",
+                                        sr::mailbox_batch_size),
+                                 size_t{1});
   num_workers_ = get_or(cfg, "scheduler.max-threads", sr::max_threads);
 }
 
@@ -267,7 +271,11 @@ void abstract_coordinator::stop_actors() {
 }
 
 abstract_coordinator::abstract_coordinator(actor_system& sys)
-  : next_worker_(0), max_throughput_(0), num_workers_(0), system_(sys) {
+  : next_worker_(0),
+    max_throughput_(0),
+    mailbox_batch_size_(defaults::scheduler::mailbox_batch_size),
+    num_workers_(0),
+    system_(sys) {
   // nop
 }
 
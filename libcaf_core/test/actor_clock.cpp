@@ -55,7 +55,7 @@ behavior testee(stateful_actor<testee_state, raw_event_based_actor>* self,
       auto n = t->now() + 10s;
       self->state.timeout_id += 1;
       auto mid = make_message_id(self->state.timeout_id).response_id();
-      t->set_request_timeout(n, self, mid);
+      t->set_request_timeout(n, self, mid, nullptr);
     },
     [](const timeout_msg&) {
       // nop
@@ -220,6 +220,23 @@ CAF_TEST(mixed_receive_and_request_timeouts) {
   expect((error), from(aut).to(aut).with(sec::request_timeout));
 }
 
+CAF_TEST(answered_request_timeout) {
+  // Schedule a request timeout with a token for lazy cancellation.
+  auto n = t.now() + 10s;
+  auto mid = make_message_id(42).response_id();
+  auto token = make_counted<detail::request_timeout_token>();
+  t.set_request_timeout(n, actor_cast<abstract_actor*>(aut), mid, token);
+  CAF_CHECK_EQUAL(t.schedule().size(), 1u);
+  CAF_CHECK_EQUAL(t.actor_lookup().size(), 1u);
+  // Mark the request as answered and advance time.
+  token->mark_answered();
+  t.advance_time(10s);
+  CAF_CHECK_EQUAL(t.schedule().size(), 0u);
+  CAF_CHECK_EQUAL(t.actor_lookup().size(), 0u);
+  // The clock must have dropped the timeout.
+  disallow((error), from(aut).to(aut).with(sec::request_timeout));
+}
+
 CAF_TEST(delay_actor_message) {
   // Schedule a message for now + 10s.
   auto n = t.now() + 10s;
@@ -0,0 +1,128 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.chase_lev_deque
+
+#include "caf/detail/chase_lev_deque.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+using int_deque = detail::chase_lev_deque<int>;
+
+struct fixture {
+  fixture() : uut(4) {
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] = static_cast<int>(i);
+  }
+
+  std::array<int, 1000> values;
+
+  int_deque uut;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(chase_lev_deque_tests, fixture)
+
+CAF_TEST(construction) {
+  CAF_CHECK_EQUAL(uut.empty(), true);
+  CAF_CHECK_EQUAL(uut.size(), 0u);
+  CAF_CHECK_EQUAL(uut.capacity(), 4u);
+  CAF_CHECK(uut.take() == nullptr);
+  CAF_CHECK(uut.steal() == nullptr);
+}
+
+CAF_TEST(the owner takes elements in LIFO order) {
+  for (int i = 0; i < 3; ++i)
+    uut.push(&values[i]);
+  CAF_CHECK_EQUAL(uut.size(), 3u);
+  CAF_CHECK_EQUAL(*uut.take(), 2);
+  CAF_CHECK_EQUAL(*uut.take(), 1);
+  CAF_CHECK_EQUAL(*uut.take(), 0);
+  CAF_CHECK(uut.take() == nullptr);
+  CAF_CHECK_EQUAL(uut.empty(), true);
+}
+
+CAF_TEST(thieves steal elements in FIFO order) {
+  for (int i = 0; i < 3; ++i)
+    uut.push(&values[i]);
+  CAF_CHECK_EQUAL(*uut.steal(), 0);
+  CAF_CHECK_EQUAL(*uut.steal(), 1);
+  CAF_CHECK_EQUAL(*uut.take(), 2);
+  CAF_CHECK(uut.steal() == nullptr);
+  CAF_CHECK_EQUAL(uut.empty(), true);
+}
+
+CAF_TEST(the deque grows on demand) {
+  for (int i = 0; i < 100; ++i)
+    uut.push(&values[i]);
+  CAF_CHECK_EQUAL(uut.size(), 100u);
+  CAF_CHECK_EQUAL(uut.capacity(), 128u);
+  CAF_CHECK_EQUAL(*uut.steal(), 0);
+  for (int i = 99; i > 0; --i)
+    CAF_CHECK_EQUAL(*uut.take(), i);
+  CAF_CHECK_EQUAL(uut.empty(), true);
+}
+
+CAF_TEST(concurrent steals return each element exactly once) {
+  std::atomic<bool> done{false};
+  std::vector<std::vector<int*>> stolen(3);
+  std::vector<std::thread> thieves;
+  for (size_t i = 0; i < stolen.size(); ++i)
+    thieves.emplace_back([&, i] {
+      for (;;) {
+        if (auto ptr = uut.steal())
+          stolen[i].push_back(ptr);
+        else if (done)
+          return;
+      }
+    });
+  std::vector<int*> taken;
+  for (auto& x : values) {
+    uut.push(&x);
+    if (x % 3 == 0)
+      if (auto ptr = uut.take())
+        taken.push_back(ptr);
+  }
+  while (auto ptr = uut.take())
+    taken.push_back(ptr);
+  done = true;
+  for (auto& t : thieves)
+    t.join();
+  std::vector<int> result;
+  for (auto ptr : taken)
+    result.push_back(*ptr);
+  for (auto& xs : stolen)
+    for (auto ptr : xs)
+      result.push_back(*ptr);
+  std::sort(result.begin(), result.end());
+  CAF_REQUIRE_EQUAL(result.size(), values.size());
+  for (size_t i = 0; i < result.size(); ++i)
+    CAF_CHECK_EQUAL(result[i], values[i]);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
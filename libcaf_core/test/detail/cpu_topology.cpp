@@ -0,0 +1,84 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.cpu_topology
+
+#include "caf/detail/cpu_topology.hpp"
+
+#include "caf/test/dsl.hpp"
+
+using namespace caf;
+
+using detail::cpu_topology;
+
+using id_list = std::vector<size_t>;
+
+namespace {
+
+// Two NUMA nodes with two core complexes of two CPUs each. CPU IDs interleave
+// between the nodes, as on many dual-socket machines.
+cpu_topology dual_socket() {
+  using info = cpu_topology::cpu_info;
+  return cpu_topology{{
+    info{0, 0, 0},
+    info{1, 1, 1},
+    info{2, 0, 0},
+    info{3, 1, 1},
+    info{4, 0, 4},
+    info{5, 1, 5},
+    info{6, 0, 4},
+    info{7, 1, 5},
+  }};
+}
+
+} // namespace
+
+CAF_TEST(parsing CPU lists) {
+  CAF_CHECK_EQUAL(cpu_topology::parse_cpu_list(""), id_list{});
+  CAF_CHECK_EQUAL(cpu_topology::parse_cpu_list("3"), id_list({3}));
+  CAF_CHECK_EQUAL(cpu_topology::parse_cpu_list("0-3"), id_list({0, 1, 2, 3}));
+  CAF_CHECK_EQUAL(cpu_topology::parse_cpu_list("0-1,4,6-7\n"),
+                  id_list({0, 1, 4, 6, 7}));
+  CAF_CHECK_EQUAL(cpu_topology::parse_cpu_list("3-1"), id_list{});
+  CAF_CHECK_EQUAL(cpu_topology::parse_cpu_list("1,x"), id_list{});
+}
+
+CAF_TEST(workers fill up core complexes and nodes one by one) {
+  auto topology = dual_socket();
+  id_list cpus;
+  for (size_t worker = 0; worker < 10; ++worker)
+    cpus.push_back(topology.cpu_of(worker).id);
+  CAF_CHECK_EQUAL(cpus, id_list({0, 2, 4, 6, 1, 3, 5, 7, 0, 2}));
+}
+
+CAF_TEST(victims are grouped by locality) {
+  auto groups = dual_socket().make_victim_groups(8);
+  CAF_REQUIRE_EQUAL(groups.size(), 8u);
+  // Worker 0 runs on CPU 0, worker 5 runs on CPU 3.
+  CAF_CHECK_EQUAL(groups[0][cpu_topology::same_cache], id_list({1}));
+  CAF_CHECK_EQUAL(groups[0][cpu_topology::same_node], id_list({2, 3}));
+  CAF_CHECK_EQUAL(groups[0][cpu_topology::remote], id_list({4, 5, 6, 7}));
+  CAF_CHECK_EQUAL(groups[5][cpu_topology::same_cache], id_list({4}));
+  CAF_CHECK_EQUAL(groups[5][cpu_topology::same_node], id_list({6, 7}));
+  CAF_CHECK_EQUAL(groups[5][cpu_topology::remote], id_list({0, 1, 2, 3}));
+}
+
+CAF_TEST(discovery always finds at least one CPU) {
+  auto topology = cpu_topology::discover();
+  CAF_CHECK(!topology.cpus().empty());
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.eventcount
+
+#include "caf/detail/eventcount.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+struct fixture {
+  detail::eventcount uut;
+  std::atomic<int> value{0};
+
+  // Blocks until `value` reaches `x`.
+  void await_value(int x) {
+    for (;;) {
+      if (value.load() >= x)
+        return;
+      auto key = uut.prepare_wait();
+      if (value.load() >= x) {
+        uut.cancel_wait();
+        return;
+      }
+      uut.wait(key);
+    }
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(eventcount_tests, fixture)
+
+CAF_TEST(cancel_wait withdraws a waiter) {
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+  uut.prepare_wait();
+  CAF_CHECK_EQUAL(uut.waiters(), 1u);
+  uut.cancel_wait();
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST(wait returns immediately after a notification) {
+  auto key = uut.prepare_wait();
+  uut.notify_one();
+  uut.wait(key);
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST(wait_until gives up once the timeout passes) {
+  auto key = uut.prepare_wait();
+  auto t0 = std::chrono::steady_clock::now();
+  CAF_CHECK(!uut.wait_until(key, t0 + std::chrono::milliseconds(10)));
+  CAF_CHECK_GREATER_OR_EQUAL(std::chrono::steady_clock::now() - t0,
+                             std::chrono::milliseconds(10));
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST(wait_until returns true after a notification) {
+  auto key = uut.prepare_wait();
+  uut.notify_one();
+  auto timeout = std::chrono::steady_clock::now() + std::chrono::hours(1);
+  CAF_CHECK(uut.wait_until(key, timeout));
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST(notify_one wakes up a parked thread) {
+  std::thread waiter{[this] { await_value(1); }};
+  value = 1;
+  uut.notify_one();
+  waiter.join();
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST(notify_all wakes up all parked threads) {
+  std::vector<std::thread> waiters;
+  for (int i = 0; i < 4; ++i)
+    waiters.emplace_back([this] { await_value(1); });
+  value = 1;
+  uut.notify_all();
+  for (auto& t : waiters)
+    t.join();
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST(notifications never get lost) {
+  constexpr int rounds = 10000;
+  std::atomic<int> acks{0};
+  std::thread waiter{[&] {
+    for (int i = 1; i <= rounds; ++i) {
+      await_value(i);
+      ++acks;
+    }
+  }};
+  for (int i = 1; i <= rounds; ++i) {
+    value = i;
+    uut.notify_one();
+    while (acks.load() < i)
+      std::this_thread::yield();
+  }
+  waiter.join();
+  CAF_CHECK_EQUAL(acks.load(), rounds);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
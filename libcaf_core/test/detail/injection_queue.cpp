@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.injection_queue
+
+#include "caf/detail/injection_queue.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+using int_queue = detail::injection_queue<int>;
+
+struct fixture {
+  fixture() : uut(8) {
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] = static_cast<int>(i);
+  }
+
+  std::vector<int> drain() {
+    std::vector<int> result;
+    while (auto ptr = uut.pop())
+      result.push_back(*ptr);
+    return result;
+  }
+
+  std::array<int, 300> values;
+
+  int_queue uut;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(injection_queue_tests, fixture)
+
+CAF_TEST(construction) {
+  CAF_CHECK_EQUAL(uut.empty(), true);
+  CAF_CHECK_EQUAL(uut.capacity(), 8u);
+  CAF_CHECK(uut.pop() == nullptr);
+}
+
+CAF_TEST(elements leave the queue in FIFO order) {
+  for (int i = 0; i < 5; ++i)
+    uut.push(&values[i]);
+  CAF_CHECK_EQUAL(uut.empty(), false);
+  CAF_CHECK_EQUAL(drain(), std::vector<int>({0, 1, 2, 3, 4}));
+  CAF_CHECK_EQUAL(uut.empty(), true);
+}
+
+CAF_TEST(try_push fails on a full ring buffer) {
+  for (int i = 0; i < 8; ++i)
+    CAF_CHECK(uut.try_push(&values[i]));
+  CAF_CHECK(!uut.try_push(&values[8]));
+  CAF_CHECK_EQUAL(*uut.pop(), 0);
+  CAF_CHECK(uut.try_push(&values[8]));
+  CAF_CHECK_EQUAL(drain(), std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+CAF_TEST(push spills into the overflow list on a full ring buffer) {
+  for (int i = 0; i < 10; ++i)
+    uut.push(&values[i]);
+  CAF_CHECK_EQUAL(drain(),
+                  std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  CAF_CHECK_EQUAL(uut.empty(), true);
+}
+
+CAF_TEST(concurrent access) {
+  auto producer = [&](size_t first, size_t last) {
+    for (auto i = first; i != last; ++i)
+      uut.push(&values[i]);
+  };
+  std::vector<std::thread> producers;
+  producers.emplace_back(producer, 0, 100);
+  producers.emplace_back(producer, 100, 200);
+  producers.emplace_back(producer, 200, 300);
+  std::vector<int> result;
+  while (result.size() < values.size())
+    if (auto ptr = uut.pop())
+      result.push_back(*ptr);
+  for (auto& t : producers)
+    t.join();
+  std::sort(result.begin(), result.end());
+  CAF_CHECK_EQUAL(result.front(), 0);
+  CAF_CHECK_EQUAL(result.back(), 299);
+  CAF_CHECK(std::adjacent_find(result.begin(), result.end()) == result.end());
+  CAF_CHECK_EQUAL(uut.empty(), true);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,168 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.log_arg_encoder
+
+#include "caf/detail/log_arg_encoder.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "caf/detail/binary_log.hpp"
+#include "caf/logger.hpp"
+
+using namespace caf;
+
+namespace {
+
+template <class... Ts>
+std::string encode(const Ts&... xs) {
+  detail::log_arg_encoder encoder;
+  (encoder << ... << xs);
+  return encoder.get().bytes;
+}
+
+template <class... Ts>
+std::string build_line(const Ts&... xs) {
+  logger::line_builder builder;
+  (builder << ... << xs);
+  return builder.get();
+}
+
+#define CHECK_RENDERING(...)                                                   \
+  CAF_CHECK_EQUAL(detail::render_log_args(encode(__VA_ARGS__)),                \
+                  build_line(__VA_ARGS__))
+
+logger::event make_event(unsigned line, std::string msg, timestamp ts) {
+  return {CAF_LOG_LEVEL_WARNING,
+          line,
+          "unit_test",
+          "void ns::foo::bar()",
+          "bar",
+          "foo.cpp",
+          detail::encoded_log_args{encode(std::move(msg))},
+          std::this_thread::get_id(),
+          42,
+          ts};
+}
+
+} // namespace
+
+CAF_TEST(encoded arguments render like the line builder) {
+  std::vector<int> xs{1, 2, 3};
+  int i = -7;
+  CHECK_RENDERING("hello", "world");
+  CHECK_RENDERING("value:", 42, -42, uint8_t{255}, -(int64_t{1} << 40));
+  CHECK_RENDERING(3.5, 2.25f, true, false, 'x');
+  CHECK_RENDERING(std::string{"foo "}, string_view{"bar"}, "", "baz");
+  CHECK_RENDERING(CAF_ARG(i), CAF_ARG(xs), CAF_ARG2("flag", true));
+  CHECK_RENDERING(xs, "items:", CAF_ARG2("name", "value"));
+  CHECK_RENDERING(std::numeric_limits<int64_t>::min(),
+                  std::numeric_limits<uint64_t>::max());
+}
+
+CAF_TEST(rendering stops at malformed input) {
+  auto bytes = encode("hello", 42);
+  bytes.pop_back();
+  CAF_CHECK_EQUAL(detail::render_log_args(bytes), "hello");
+}
+
+CAF_TEST(binary log files store events with their sites) {
+  auto t0 = make_timestamp();
+  std::stringstream buf;
+  detail::binary_log_writer writer;
+  writer.write_header(buf, t0);
+  writer.write(buf, make_event(10, "first", t0 + std::chrono::seconds(1)));
+  writer.write(buf, make_event(10, "second", t0 + std::chrono::seconds(2)));
+  writer.write(buf, make_event(20, "third", t0 + std::chrono::seconds(3)));
+  detail::binary_log_reader reader{buf};
+  CAF_REQUIRE(reader.read_header());
+  CAF_CHECK_EQUAL(reader.t0(), t0);
+  detail::binary_log_reader::event x;
+  std::vector<std::string> messages;
+  std::vector<unsigned> lines;
+  while (reader.next(x)) {
+    CAF_CHECK_EQUAL(x.origin->component, "unit_test");
+    CAF_CHECK_EQUAL(x.origin->pretty_fun, "void ns::foo::bar()");
+    CAF_CHECK_EQUAL(x.origin->simple_fun, "bar");
+    CAF_CHECK_EQUAL(x.origin->file_name, "foo.cpp");
+    CAF_CHECK_EQUAL(x.origin->level, unsigned{CAF_LOG_LEVEL_WARNING});
+    CAF_CHECK_EQUAL(x.aid, 42u);
+    messages.emplace_back(x.message);
+    lines.emplace_back(x.origin->line);
+  }
+  CAF_CHECK(!reader.malformed());
+  CAF_CHECK_EQUAL(messages,
+                  std::vector<std::string>({"first", "second", "third"}));
+  CAF_CHECK_EQUAL(lines, std::vector<unsigned>({10, 10, 20}));
+}
+
+CAF_TEST(binary log readers skip headers of appended runs) {
+  auto t0 = make_timestamp();
+  auto t1 = t0 + std::chrono::hours(1);
+  std::stringstream buf;
+  detail::binary_log_writer first_run;
+  first_run.write_header(buf, t0);
+  first_run.write(buf, make_event(10, "first", t0));
+  detail::binary_log_writer second_run;
+  second_run.write_header(buf, t1);
+  second_run.write(buf, make_event(20, "second", t1));
+  detail::binary_log_reader reader{buf};
+  CAF_REQUIRE(reader.read_header());
+  detail::binary_log_reader::event x;
+  CAF_REQUIRE(reader.next(x));
+  CAF_CHECK_EQUAL(x.message, "first");
+  CAF_CHECK_EQUAL(x.origin->line, 10u);
+  CAF_REQUIRE(reader.next(x));
+  CAF_CHECK_EQUAL(reader.t0(), t1);
+  CAF_CHECK_EQUAL(x.message, "second");
+  CAF_CHECK_EQUAL(x.origin->line, 20u);
+  CAF_CHECK_EQUAL(x.tstamp, t1);
+  CAF_CHECK(!reader.next(x));
+  CAF_CHECK(!reader.malformed());
+}
+
+CAF_TEST(binary log readers reject other files) {
+  std::stringstream buf{"2020-01-01 hello world"};
+  detail::binary_log_reader reader{buf};
+  CAF_CHECK(!reader.read_header());
+  CAF_CHECK(reader.malformed());
+}
+
+CAF_TEST(binary log readers reject strings beyond the end of the file) {
+  std::stringstream buf;
+  detail::binary_log_writer writer;
+  writer.write_header(buf, make_timestamp());
+  // A site definition with ID 0, level 0, line 0 and a component name that
+  // claims to have 2^60 bytes.
+  buf << "S" << '\0' << '\0' << '\0';
+  for (int i = 0; i < 8; ++i)
+    buf.put(static_cast<char>(0x80));
+  buf.put(static_cast<char>(0x10));
+  buf << "unit_test";
+  detail::binary_log_reader reader{buf};
+  CAF_REQUIRE(reader.read_header());
+  detail::binary_log_reader::event x;
+  CAF_CHECK(!reader.next(x));
+  CAF_CHECK(reader.malformed());
+}
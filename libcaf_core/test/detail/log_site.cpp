@@ -0,0 +1,85 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.log_site
+
+#include "caf/detail/log_site.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <string>
+#include <vector>
+
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+#include "caf/logger.hpp"
+
+using namespace caf;
+
+namespace {
+
+constexpr auto caf_id = detail::log_component_id("caf");
+
+constexpr auto flow_id = detail::log_component_id("caf_flow");
+
+// Sites register themselves globally on first use and thus must outlive all
+// loggers, just like the static sites in CAF_LOG_IMPL.
+detail::log_site debug_site{CAF_LOG_LEVEL_DEBUG, caf_id};
+
+detail::log_site trace_site{CAF_LOG_LEVEL_TRACE, caf_id};
+
+detail::log_site flow_site{CAF_LOG_LEVEL_DEBUG, flow_id};
+
+struct fixture {
+  fixture() {
+    cfg.set("scheduler.policy", "testing");
+    cfg.set("logger.file-name", "");
+    cfg.set("logger.file-verbosity", "debug");
+    cfg.set("logger.component-blacklist", std::vector<std::string>{"caf_flow"});
+  }
+
+  actor_system_config cfg;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(log_site_tests, fixture)
+
+CAF_TEST(component names map to IDs at compile time) {
+  static_assert(caf_id != flow_id);
+  static_assert(caf_id == detail::log_component_id(CAF_LOG_COMPONENT));
+  std::string name = "caf";
+  CAF_CHECK_EQUAL(detail::log_component_id(name), caf_id);
+}
+
+CAF_TEST(log sites follow the filters of all active loggers) {
+  CAF_CHECK(!debug_site.enabled());
+  CAF_CHECK(!trace_site.enabled());
+  CAF_CHECK(!flow_site.enabled());
+  {
+    actor_system sys{cfg};
+    CAF_CHECK(debug_site.enabled());
+    CAF_CHECK(!trace_site.enabled());
+    CAF_CHECK(!flow_site.enabled());
+    CAF_CHECK(sys.logger().accepts(CAF_LOG_LEVEL_DEBUG, "caf"));
+    CAF_CHECK(!sys.logger().accepts(CAF_LOG_LEVEL_DEBUG, "caf_flow"));
+  }
+  CAF_CHECK(!debug_site.enabled());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,130 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.message_pool
+
+#include "caf/detail/message_pool.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "caf/mailbox_element.hpp"
+
+using namespace caf;
+
+using detail::message_pool;
+
+namespace {
+
+constexpr size_t block_size = 100;
+
+struct fixture {
+  fixture() {
+    message_pool::enable(true);
+  }
+
+  ~fixture() {
+    message_pool::enable(true);
+  }
+
+  std::vector<void*> allocate_n(size_t n) {
+    std::vector<void*> result;
+    for (size_t i = 0; i < n; ++i)
+      result.push_back(message_pool::allocate(block_size));
+    return result;
+  }
+
+  void deallocate_all(std::vector<void*>& blocks) {
+    for (auto ptr : blocks)
+      message_pool::deallocate(ptr, block_size);
+    blocks.clear();
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(message_pool_tests, fixture)
+
+CAF_TEST(threads reuse their own blocks) {
+  auto blocks = allocate_n(10);
+  deallocate_all(blocks);
+  CAF_CHECK_GREATER_OR_EQUAL(message_pool::cached_blocks(block_size), 10u);
+  auto heap_allocs = message_pool::heap_allocations(block_size);
+  blocks = allocate_n(10);
+  CAF_CHECK_EQUAL(message_pool::heap_allocations(block_size), heap_allocs);
+  deallocate_all(blocks);
+}
+
+CAF_TEST(blocks return to the allocating thread via the depot) {
+  // Make sure the depot has no blocks that we could pick up by accident.
+  auto n = 8 * message_pool::batch_size;
+  std::vector<void*> blocks;
+  std::thread t1{[&] { blocks = allocate_n(n); }};
+  t1.join();
+  // Freeing all blocks on another thread moves surplus blocks to the depot
+  // while running and the remaining blocks when the thread terminates.
+  std::thread t2{[&] { deallocate_all(blocks); }};
+  t2.join();
+  auto heap_allocs = message_pool::heap_allocations(block_size);
+  std::thread t3{[&] {
+    blocks = allocate_n(n);
+    deallocate_all(blocks);
+  }};
+  t3.join();
+  CAF_CHECK_EQUAL(message_pool::heap_allocations(block_size), heap_allocs);
+}
+
+CAF_TEST(blocks remain compatible when toggling the pool) {
+  message_pool::enable(false);
+  auto blocks = allocate_n(3);
+  message_pool::enable(true);
+  auto cached = message_pool::cached_blocks(block_size);
+  deallocate_all(blocks);
+  CAF_CHECK_EQUAL(message_pool::cached_blocks(block_size), cached + 3);
+  blocks = allocate_n(3);
+  message_pool::enable(false);
+  deallocate_all(blocks);
+}
+
+CAF_TEST(only the first configuration applies) {
+  // Other tests in this process may have configured the pool already.
+  message_pool::configure(true);
+  CAF_CHECK(message_pool::enabled());
+  CAF_CHECK(!message_pool::configure(false));
+  CAF_CHECK(message_pool::enabled());
+}
+
+CAF_TEST(large objects bypass the pool) {
+  auto size = message_pool::max_block_size + 1;
+  auto ptr = message_pool::allocate(size);
+  message_pool::deallocate(ptr, size);
+  CAF_CHECK_EQUAL(message_pool::cached_blocks(size), 0u);
+}
+
+CAF_TEST(mailbox elements use the pool) {
+  auto elem = make_mailbox_element(nullptr, make_message_id(), {},
+                                   int32_t{1}, int32_t{2});
+  auto size = sizeof(mailbox_element_vals<int32_t, int32_t>);
+  auto cached = message_pool::cached_blocks(size);
+  elem.reset();
+  CAF_CHECK_EQUAL(message_pool::cached_blocks(size), cached + 1);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
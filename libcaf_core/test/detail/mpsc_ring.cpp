@@ -0,0 +1,170 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.mpsc_ring
+
+#include "caf/detail/mpsc_ring.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+using int_ring = detail::mpsc_ring<int>;
+
+std::vector<int> consumer(int_ring& buf, size_t num) {
+  std::vector<int> result;
+  while (result.size() < num) {
+    buf.wait_nonempty();
+    buf.consume([&](int x) { result.emplace_back(x); });
+  }
+  return result;
+}
+
+void producer(int_ring& buf, int first, int last) {
+  for (auto i = first; i != last; ++i)
+    buf.push(std::move(i));
+}
+
+struct fixture {
+  fixture() : buf(64) {
+    // nop
+  }
+
+  std::vector<int> fetch_all() {
+    std::vector<int> result;
+    buf.consume([&](int x) { result.emplace_back(x); });
+    return result;
+  }
+
+  int_ring buf;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(mpsc_ring_tests, fixture)
+
+CAF_TEST(construction) {
+  CAF_CHECK_EQUAL(buf.empty(), true);
+  CAF_CHECK_EQUAL(buf.size(), 0u);
+  CAF_CHECK_EQUAL(buf.capacity(), 64u);
+  CAF_CHECK_EQUAL(int_ring{100}.capacity(), 128u);
+  CAF_CHECK_EQUAL(int_ring{0}.capacity(), 2u);
+}
+
+CAF_TEST(default-constructed rings allocate storage on resize) {
+  int_ring uninitialized;
+  CAF_CHECK_EQUAL(uninitialized.capacity(), 0u);
+  CAF_CHECK_EQUAL(uninitialized.size(), 0u);
+  uninitialized.resize(10);
+  CAF_CHECK_EQUAL(uninitialized.capacity(), 16u);
+  CAF_CHECK_EQUAL(uninitialized.empty(), true);
+  uninitialized.push(42);
+  CAF_CHECK_EQUAL(uninitialized.front(), 42);
+}
+
+CAF_TEST(push and pop) {
+  CAF_MESSAGE("add one element");
+  buf.push(42);
+  CAF_CHECK_EQUAL(buf.empty(), false);
+  CAF_CHECK_EQUAL(buf.size(), 1u);
+  CAF_CHECK_EQUAL(buf.front(), 42);
+  CAF_MESSAGE("remove element");
+  buf.pop_front();
+  CAF_CHECK_EQUAL(buf.empty(), true);
+  CAF_CHECK_EQUAL(buf.size(), 0u);
+  CAF_MESSAGE("fill buffer");
+  for (int i = 0; i < 64; ++i)
+    CAF_CHECK(buf.try_push(std::move(i)));
+  CAF_CHECK_EQUAL(buf.size(), 64u);
+  CAF_CHECK_EQUAL(buf.try_push(64), false);
+  CAF_CHECK_EQUAL(buf.front(), 0);
+}
+
+CAF_TEST(consume) {
+  CAF_MESSAGE("add five elements");
+  for (int i = 0; i < 5; ++i)
+    buf.push(std::move(i));
+  CAF_CHECK_EQUAL(buf.size(), 5u);
+  CAF_MESSAGE("consume at most two elements");
+  std::vector<int> xs;
+  auto n = buf.consume([&](int x) { xs.emplace_back(x); }, 2);
+  CAF_CHECK_EQUAL(n, 2u);
+  CAF_CHECK_EQUAL(xs, std::vector<int>({0, 1}));
+  CAF_MESSAGE("drain remaining elements");
+  CAF_CHECK_EQUAL(fetch_all(), std::vector<int>({2, 3, 4}));
+  CAF_CHECK_EQUAL(buf.empty(), true);
+  CAF_MESSAGE("add 60 elements (wraps around)");
+  std::vector<int> expected;
+  for (int i = 0; i < 60; ++i) {
+    expected.push_back(i);
+    buf.push(std::move(i));
+  }
+  CAF_CHECK_EQUAL(buf.size(), 60u);
+  CAF_CHECK_EQUAL(fetch_all(), expected);
+  CAF_CHECK_EQUAL(buf.empty(), true);
+}
+
+CAF_TEST(resizing keeps all elements) {
+  for (int i = 0; i < 5; ++i)
+    buf.push(std::move(i));
+  buf.resize(4);
+  CAF_CHECK_EQUAL(buf.capacity(), 8u);
+  CAF_CHECK_EQUAL(fetch_all(), std::vector<int>({0, 1, 2, 3, 4}));
+  buf.resize(256);
+  CAF_CHECK_EQUAL(buf.capacity(), 256u);
+  CAF_CHECK_EQUAL(buf.empty(), true);
+}
+
+CAF_TEST(the ring destroys remaining elements) {
+  auto x = std::make_shared<int>(42);
+  {
+    detail::mpsc_ring<std::shared_ptr<int>> ring{4};
+    ring.push(std::shared_ptr<int>{x});
+    ring.push(std::shared_ptr<int>{x});
+    CAF_CHECK_EQUAL(x.use_count(), 3);
+  }
+  CAF_CHECK_EQUAL(x.use_count(), 1);
+}
+
+CAF_TEST(concurrent access) {
+  int_ring small_buf{4};
+  std::vector<std::thread> producers;
+  producers.emplace_back(producer, std::ref(small_buf), 0, 1000);
+  producers.emplace_back(producer, std::ref(small_buf), 1000, 2000);
+  producers.emplace_back(producer, std::ref(small_buf), 2000, 3000);
+  auto vec = consumer(small_buf, 3000);
+  CAF_MESSAGE("elements of each producer arrive in order");
+  for (int i = 0; i < 3; ++i) {
+    std::vector<int> sub;
+    std::copy_if(vec.begin(), vec.end(), std::back_inserter(sub),
+                 [i](int x) { return x / 1000 == i; });
+    CAF_CHECK_EQUAL(sub.size(), 1000u);
+    CAF_CHECK(std::is_sorted(sub.begin(), sub.end()));
+  }
+  for (auto& t : producers)
+    t.join();
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,168 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.timing_wheel
+
+#include "caf/detail/timing_wheel.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+struct node : detail::timing_wheel_node {
+  int value = 0;
+};
+
+struct fixture {
+  fixture() : uut(100) {
+    for (size_t i = 0; i < nodes.size(); ++i)
+      nodes[i].value = static_cast<int>(i);
+  }
+
+  std::vector<int> advance(uint64_t now) {
+    std::vector<int> result;
+    uut.advance(now, [&](detail::timing_wheel_node* x) {
+      result.push_back(static_cast<node*>(x)->value);
+    });
+    return result;
+  }
+
+  std::array<node, 1000> nodes;
+
+  detail::timing_wheel uut;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(timing_wheel_tests, fixture)
+
+CAF_TEST(construction) {
+  CAF_CHECK_EQUAL(uut.now(), 100u);
+  CAF_CHECK_EQUAL(uut.empty(), true);
+  CAF_CHECK_EQUAL(uut.next_expiration(), none);
+  CAF_CHECK_EQUAL(advance(1000), std::vector<int>{});
+  CAF_CHECK_EQUAL(uut.now(), 1000u);
+}
+
+CAF_TEST(nodes expire once the wheel reaches their tick) {
+  uut.insert(&nodes[0], 150);
+  uut.insert(&nodes[1], 101);
+  uut.insert(&nodes[2], 5000);
+  CAF_CHECK_EQUAL(uut.size(), 3u);
+  CAF_CHECK_EQUAL(advance(100), std::vector<int>{});
+  CAF_CHECK_EQUAL(advance(101), std::vector<int>{1});
+  CAF_CHECK_EQUAL(advance(149), std::vector<int>{});
+  CAF_CHECK_EQUAL(advance(150), std::vector<int>{0});
+  CAF_CHECK_EQUAL(advance(4999), std::vector<int>{});
+  CAF_CHECK_EQUAL(advance(5000), std::vector<int>{2});
+  CAF_CHECK_EQUAL(uut.empty(), true);
+  CAF_CHECK(!detail::timing_wheel::linked(&nodes[2]));
+}
+
+CAF_TEST(nodes in the past expire on the next advance) {
+  uut.insert(&nodes[0], 10);
+  uut.insert(&nodes[1], 100);
+  CAF_CHECK_EQUAL(uut.next_expiration(), uint64_t{100});
+  CAF_CHECK_EQUAL(advance(100), std::vector<int>({0, 1}));
+}
+
+CAF_TEST(nodes with the same tick expire in insertion order) {
+  for (int i = 0; i < 5; ++i)
+    uut.insert(&nodes[i], 10000);
+  CAF_CHECK_EQUAL(advance(20000), std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+CAF_TEST(erased nodes never expire) {
+  uut.insert(&nodes[0], 200);
+  uut.insert(&nodes[1], 200);
+  uut.insert(&nodes[2], 300000);
+  uut.erase(&nodes[0]);
+  uut.erase(&nodes[2]);
+  CAF_CHECK_EQUAL(uut.size(), 1u);
+  CAF_CHECK_EQUAL(advance(1000000), std::vector<int>{1});
+}
+
+CAF_TEST(next_expiration never lies past the earliest node) {
+  uut.insert(&nodes[0], 100 + 64 * 64 + 7);
+  auto t = uut.next_expiration();
+  CAF_REQUIRE(t != none);
+  CAF_CHECK_LESS_OR_EQUAL(*t, 100u + 64 * 64 + 7);
+  while (!uut.empty()) {
+    t = uut.next_expiration();
+    CAF_REQUIRE(t != none);
+    CAF_CHECK_GREATER(*t, uut.now());
+    auto fired = advance(*t);
+    if (!fired.empty())
+      CAF_CHECK_EQUAL(*t, 100u + 64 * 64 + 7);
+  }
+}
+
+CAF_TEST(nodes beyond the range of the wheel wait on the highest level) {
+  auto far = 100 + detail::timing_wheel::max_ticks * 3;
+  uut.insert(&nodes[0], far);
+  CAF_CHECK_EQUAL(advance(far - 1), std::vector<int>{});
+  CAF_CHECK_EQUAL(advance(far), std::vector<int>{0});
+}
+
+CAF_TEST(the wheel expires random nodes in order of their ticks) {
+  std::minstd_rand rng{42};
+  std::uniform_int_distribution<uint64_t> dist{0, 1u << 20};
+  std::vector<std::pair<uint64_t, int>> expected;
+  for (auto& x : nodes) {
+    auto tick = 100 + dist(rng);
+    uut.insert(&x, tick);
+    expected.emplace_back(tick, x.value);
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](auto& x, auto& y) { return x.first < y.first; });
+  std::vector<std::pair<uint64_t, int>> fired;
+  uint64_t now = 100;
+  while (!uut.empty()) {
+    now += 997;
+    uut.advance(now, [&](detail::timing_wheel_node* x) {
+      CAF_CHECK_LESS_OR_EQUAL(x->wheel_tick, now);
+      CAF_CHECK_GREATER(x->wheel_tick, now - 997);
+      fired.emplace_back(x->wheel_tick, static_cast<node*>(x)->value);
+    });
+  }
+  std::stable_sort(fired.begin(), fired.end(),
+                   [](auto& x, auto& y) { return x.first < y.first; });
+  CAF_CHECK(fired == expected);
+}
+
+CAF_TEST(clear removes all nodes) {
+  uut.insert(&nodes[0], 50);
+  uut.insert(&nodes[1], 500);
+  uut.insert(&nodes[2], 500000);
+  std::vector<int> removed;
+  uut.clear([&](detail::timing_wheel_node* x) {
+    removed.push_back(static_cast<node*>(x)->value);
+  });
+  std::sort(removed.begin(), removed.end());
+  CAF_CHECK_EQUAL(removed, std::vector<int>({0, 1, 2}));
+  CAF_CHECK_EQUAL(uut.empty(), true);
+  CAF_CHECK_EQUAL(uut.next_expiration(), none);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "caf/all.hpp"
@@ -110,7 +111,7 @@ CAF_TEST(move_tuple) {
   CAF_CHECK_EQUAL((fetch<string, string>(*m1)), strings("hello", "world"));
   auto msg = m1->move_content_to_message();
   CAF_CHECK_EQUAL((fetch<string, string>(msg)), strings("hello", "world"));
-  CAF_CHECK_EQUAL((fetch<string, string>(*m1)), strings("", ""));
+  CAF_CHECK_EQUAL((fetch<string, string>(*m1)), strings("hello", "world"));
 }
 
 CAF_TEST(copy_tuple) {
@@ -123,6 +124,32 @@ CAF_TEST(copy_tuple) {
   CAF_CHECK_EQUAL((fetch<string, string>(*m1)), strings("hello", "world"));
 }
 
+CAF_TEST(promoted_tuple) {
+  auto m1 = make_mailbox_element(nullptr, make_message_id(),
+                                 no_stages, "hello", "world");
+  auto msg1 = m1->copy_content_to_message();
+  auto msg2 = m1->copy_content_to_message();
+  auto msg3 = m1->move_content_to_message();
+  CAF_CHECK_EQUAL(msg1.cvals().get(), msg2.cvals().get());
+  CAF_CHECK_EQUAL(msg1.cvals().get(), msg3.cvals().get());
+  CAF_CHECK(&std::as_const(*m1).content() == &std::as_const(msg1).content());
+}
+
+CAF_TEST(reused_tuple) {
+  using impl = mailbox_element_vals<int, string>;
+  impl m1{strong_actor_ptr{}, make_message_id(),
+          mailbox_element::forwarding_stack{}, 1, string{"one"}};
+  auto msg1 = m1.move_content_to_message();
+  m1.reset_promotion();
+  m1.get_mutable_as<int>(0) = 2;
+  m1.get_mutable_as<string>(1) = "two";
+  using result = tuple<int, string>;
+  CAF_CHECK_EQUAL((fetch<int, string>(m1.content())), result(2, "two"));
+  auto msg2 = m1.move_content_to_message();
+  CAF_CHECK_EQUAL((fetch<int, string>(msg1)), result(1, "one"));
+  CAF_CHECK_EQUAL((fetch<int, string>(msg2)), result(2, "two"));
+}
+
 CAF_TEST(high_priority) {
   auto m1 = make_mailbox_element(nullptr,
                                  make_message_id(message_priority::high),
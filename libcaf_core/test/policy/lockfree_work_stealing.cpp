@@ -0,0 +1,148 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE policy.lockfree_work_stealing
+
+#include "caf/policy/lockfree_work_stealing.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include "caf/all.hpp"
+#include "caf/scheduler/coordinator.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct config : actor_system_config {
+  config() {
+    set("scheduler.policy", "lockfree-stealing");
+    set("scheduler.max-threads", 4);
+    set("work-stealing.initial-deque-capacity", 2);
+    set("work-stealing.injection-queue-capacity", 2);
+  }
+};
+
+struct fixture {
+  config cfg;
+  actor_system sys;
+  scoped_actor self;
+
+  fixture() : sys(cfg), self(sys) {
+    // nop
+  }
+};
+
+behavior adder() {
+  return {
+    [](int32_t x, int32_t y) { return x + y; },
+  };
+}
+
+// Counts how often workers resumed it.
+struct counting_job : ref_counted, resumable {
+  std::atomic<size_t> count{0};
+
+  subtype_t subtype() const override {
+    return function_object;
+  }
+
+  resume_result resume(execution_unit*, size_t) override {
+    ++count;
+    return done;
+  }
+
+  void intrusive_ptr_add_ref_impl() override {
+    ref();
+  }
+
+  void intrusive_ptr_release_impl() override {
+    deref();
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(lockfree_work_stealing_tests, fixture)
+
+CAF_TEST(actors run on lock-free work-stealing workers) {
+  std::vector<actor> workers;
+  for (int i = 0; i < 100; ++i)
+    workers.emplace_back(sys.spawn(adder));
+  int32_t sum = 0;
+  for (int32_t i = 0; i < 100; ++i)
+    self->request(workers[i], infinite, i, i)
+      .receive([&](int32_t x) { sum += x; },
+               [&](error& err) { CAF_FAIL("unexpected error: " << err); });
+  CAF_CHECK_EQUAL(sum, 9900);
+  for (auto& worker : workers)
+    self->send_exit(worker, exit_reason::user_shutdown);
+}
+
+CAF_TEST(fan-out requests from an actor) {
+  auto client = sys.spawn([](event_based_actor* client) -> behavior {
+    return {
+      [=](int32_t n) {
+        auto rp = client->make_response_promise<int32_t>();
+        auto sum = std::make_shared<int32_t>(0);
+        auto pending = std::make_shared<int32_t>(n);
+        for (int32_t i = 0; i < n; ++i) {
+          auto worker = client->spawn(adder);
+          client->request(worker, infinite, i, 1).then([=](int32_t x) mutable {
+            *sum += x;
+            if (--*pending == 0)
+              rp.deliver(*sum);
+          });
+        }
+        return rp;
+      },
+    };
+  });
+  self->request(client, infinite, int32_t{1000})
+    .receive([&](int32_t x) { CAF_CHECK_EQUAL(x, 500500); },
+             [&](error& err) { CAF_FAIL("unexpected error: " << err); });
+}
+
+CAF_TEST(threads may enqueue through the context of another worker) {
+  using coordinator_type
+    = scheduler::coordinator<policy::lockfree_work_stealing>;
+  auto sched = dynamic_cast<coordinator_type*>(&sys.scheduler());
+  CAF_REQUIRE(sched != nullptr);
+  auto ctx = sched->worker_by_id(0);
+  auto job = make_counted<counting_job>();
+  constexpr size_t num_threads = 4;
+  constexpr size_t jobs_per_thread = 10000;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i)
+    threads.emplace_back([&] {
+      for (size_t j = 0; j < jobs_per_thread; ++j) {
+        // The worker releases the job after resuming it.
+        job->ref();
+        ctx->exec_later(job.get());
+      }
+    });
+  for (auto& thread : threads)
+    thread.join();
+  auto total = num_threads * jobs_per_thread;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (job->count < total && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  CAF_CHECK_EQUAL(job->count.load(), total);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
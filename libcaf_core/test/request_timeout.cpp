@@ -295,4 +295,26 @@ CAF_TEST(multiplexed_timeout) {
   }
 }
 
+CAF_TEST(many_answered_requests) {
+  constexpr size_t num_requests = 1000;
+  size_t responses = 0;
+  size_t errors = 0;
+  auto server = sys.spawn<lazy_init>(pong);
+  sys.spawn([=, &responses, &errors](event_based_actor* self) {
+    for (size_t i = 0; i < num_requests; ++i)
+      self->request(server, milliseconds(100), ping_atom_v)
+        .then([&](pong_atom) { ++responses; }, [&](const error&) { ++errors; });
+    // Keep the client alive. Otherwise, terminating would drop all timeouts.
+    return behavior{[](int) {
+      // nop
+    }};
+  });
+  sched.run();
+  CAF_CHECK_EQUAL(responses, num_requests);
+  CAF_MESSAGE("timeouts of answered requests never reach the client");
+  CAF_CHECK_EQUAL(sched.trigger_timeouts(), num_requests);
+  CAF_CHECK(!sched.has_job());
+  CAF_CHECK_EQUAL(errors, 0u);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,85 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE scheduled_actor
+
+#include "caf/scheduled_actor.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <vector>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+// Allows the test to resume actors with an arbitrary throughput.
+class worker : public execution_unit {
+public:
+  explicit worker(scheduler::test_coordinator& sched)
+    : execution_unit(&sched.system()), sched_(sched) {
+    // nop
+  }
+
+  void exec_later(resumable* ptr) override {
+    sched_.jobs.push_back(ptr);
+  }
+
+private:
+  scheduler::test_coordinator& sched_;
+};
+
+behavior testee(event_based_actor* self, std::vector<int>* log) {
+  return {
+    [=](int x) {
+      log->emplace_back(x);
+      // The actor is running, i.e., the urgent message arrives in the middle
+      // of a batch.
+      if (x == 0)
+        self->send<message_priority::high>(self, -1);
+    },
+  };
+}
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(scheduled_actor_tests, test_coordinator_fixture<>)
+
+CAF_TEST(urgent messages do not wait for batches of normal messages) {
+  std::vector<int> log;
+  auto aut = sys.spawn(testee, &log);
+  run();
+  for (int i = 0; i < 100; ++i)
+    self->send(aut, i);
+  CAF_REQUIRE_EQUAL(sched.jobs.size(), 1u);
+  auto job = sched.jobs.front();
+  sched.jobs.pop_front();
+  // Allow the actor to drain its mailbox in a single resume.
+  worker ctx{sched};
+  CAF_CHECK(job->resume(&ctx, 1000) == resumable::awaiting_message);
+  intrusive_ptr_release(job);
+  CAF_REQUIRE_EQUAL(log.size(), 101u);
+  CAF_CHECK_EQUAL(log[0], 0);
+  CAF_CHECK_EQUAL(log[1], -1);
+  CAF_CHECK_EQUAL(log[2], 1);
+  CAF_CHECK_EQUAL(log.back(), 99);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
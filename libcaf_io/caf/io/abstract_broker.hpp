@@ -155,12 +155,29 @@ public:
   /// Returns the write buffer for a given connection.
   byte_buffer& wr_buf(connection_handle hdl);
 
+  /// Returns how many bytes wait for transmission on a given connection.
+  size_t pending_bytes(connection_handle hdl);
+
   /// Writes `data` into the buffer for a given connection.
   void write(connection_handle hdl, size_t bs, const void* buf);
 
+  /// Enqueues `buf` for a given connection. Large buffers are sent without
+  /// copying their content.
+  void write(connection_handle hdl, byte_buffer&& buf);
+
   /// Sends the content of the buffer for a given connection.
   void flush(connection_handle hdl);
 
+  /// Returns an empty buffer from the buffer pool of the multiplexer. Passing
+  /// the buffer to `write(connection_handle, byte_buffer&&)` recycles it
+  /// automatically after sending its content.
+  byte_buffer acquire_buffer();
+
+  /// Returns `buf` to the buffer pool of the multiplexer. Brokers may keep the
+  /// buffer of a `new_data_msg` by moving it out of the message without
+  /// copying and then hand it back via this function when done.
+  void release_buffer(byte_buffer&& buf);
+
   /// Enables or disables write notifications for a given datagram socket.
   void ack_writes(datagram_handle hdl, bool enable);
 
@@ -432,6 +449,7 @@ private:
   doorman_map doormen_;
   datagram_servant_map datagram_servants_;
   byte_buffer dummy_wr_buf_;
+  network::multiplexer* backend_;
 };
 
 } // namespace caf::io
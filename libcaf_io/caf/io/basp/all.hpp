@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "caf/io/basp/compression.hpp"
 #include "caf/io/basp/connection_state.hpp"
 #include "caf/io/basp/endpoint_context.hpp"
 #include "caf/io/basp/header.hpp"
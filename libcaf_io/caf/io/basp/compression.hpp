@@ -0,0 +1,43 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include "caf/byte.hpp"
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/span.hpp"
+
+namespace caf::io::basp {
+
+/// @addtogroup BASP
+
+/// Appends `payload` in compressed form to `out`. The compressed form starts
+/// with the size of `payload` as 32-bit integer in network byte order,
+/// followed by a single block in the LZ4 block format.
+/// @returns `false` without modifying `out` if compressing `payload` does not
+///          save any space.
+CAF_IO_EXPORT bool compress(byte_buffer& out, span<const byte> payload);
+
+/// Appends the original payload for the compressed bytes in `input` to `out`.
+/// @returns `false` without modifying `out` if `input` is malformed.
+CAF_IO_EXPORT bool decompress(byte_buffer& out, span<const byte> input);
+
+/// @}
+
+} // namespace caf::io::basp
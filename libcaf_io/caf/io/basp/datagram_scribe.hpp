@@ -0,0 +1,141 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/io/basp/header.hpp"
+#include "caf/io/datagram_handle.hpp"
+#include "caf/io/network/reliable_channel.hpp"
+#include "caf/io/scribe.hpp"
+
+namespace caf::io::basp {
+
+/// Runs BASP over a datagram endpoint by wrapping a `reliable_channel` into
+/// the `scribe` interface. Each BASP message becomes one frame of the channel.
+/// Messages of the same source actor share a stream and thus arrive in order,
+/// while a lost packet only delays messages of senders that map to the same
+/// stream. Control messages (handshakes, monitoring, heartbeats, etc.) use
+/// stream 0.
+///
+/// The scribe performs no I/O on its own. It writes datagrams to the
+/// `datagram_servant` of its parent and expects the parent to pass received
+/// datagrams to `channel()` as well as to call `handle_timeout()` whenever it
+/// receives a `(tick_atom, connection_handle)` message for this scribe.
+class CAF_IO_EXPORT datagram_scribe : public scribe {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Number of streams for BASP messages, including the control stream.
+  static constexpr uint16_t num_streams
+    = network::reliable_channel::max_streams;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a scribe for the endpoint `dgram_hdl` of `parent`. The scribe
+  /// drops outgoing datagrams with probability `loss_rate` for testing.
+  datagram_scribe(abstract_broker* parent, datagram_handle dgram_hdl,
+                  uint32_t session, double loss_rate = 0.0);
+
+  ~datagram_scribe() override;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the datagram endpoint of this scribe.
+  datagram_handle dgram_hdl() const noexcept {
+    return dgram_hdl_;
+  }
+
+  /// Returns the reliability layer of this scribe.
+  network::reliable_channel& channel() noexcept {
+    return channel_;
+  }
+
+  /// Returns the connection handle for the datagram endpoint `x`. Valid
+  /// handles have a non-negative ID and -1 denotes an invalid handle, hence
+  /// these handles never collide with connection handles of TCP scribes.
+  static connection_handle conn_hdl_from(datagram_handle x) noexcept {
+    return connection_handle::from_int(-2 - x.id());
+  }
+
+  // -- event handling ---------------------------------------------------------
+
+  /// Passes all pending datagrams to the parent and makes sure that the
+  /// parent receives a timeout message when the channel needs attention.
+  /// Detaches the scribe once a closing channel has nothing left to send.
+  void transmit();
+
+  /// Handles an expired timer of the channel.
+  void handle_timeout();
+
+  // -- implementation of scribe -----------------------------------------------
+
+  void configure_read(receive_policy::config config) override;
+
+  void ack_writes(bool enable) override;
+
+  byte_buffer& wr_buf() override;
+
+  size_t pending_bytes() override;
+
+  byte_buffer& rd_buf() override;
+
+  void graceful_shutdown() override;
+
+  void flush() override;
+
+  std::string addr() const override;
+
+  uint16_t port() const override;
+
+  void add_to_loop() override;
+
+  void remove_from_loop() override;
+
+private:
+  /// Selects the stream for the BASP message with header `hdr`.
+  static uint16_t stream_for(const header& hdr) noexcept;
+
+  datagram_handle dgram_hdl_;
+
+  network::reliable_channel channel_;
+
+  byte_buffer wr_buf_;
+
+  byte_buffer rd_buf_;
+
+  std::string addr_;
+
+  uint16_t port_;
+
+  /// Stores when the parent receives the next timeout message.
+  network::reliable_channel::time_point timer_;
+
+  std::minstd_rand rng_;
+
+  std::bernoulli_distribution drop_;
+};
+
+using datagram_scribe_ptr = intrusive_ptr<datagram_scribe>;
+
+} // namespace caf::io::basp
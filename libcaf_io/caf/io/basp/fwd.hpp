@@ -22,6 +22,7 @@ namespace caf::io::basp {
 
 struct header;
 
+class datagram_scribe;
 class worker;
 class worker_hub;
 class message_queue;
@@ -21,12 +21,14 @@
 #include <cstdint>
 #include <string>
 
+#include "caf/byte_buffer.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/error.hpp"
 #include "caf/io/basp/message_type.hpp"
 #include "caf/meta/omittable.hpp"
 #include "caf/meta/type_name.hpp"
 #include "caf/node_id.hpp"
+#include "caf/span.hpp"
 
 namespace caf::io::basp {
 
@@ -62,6 +64,14 @@ struct header {
   /// Identifies a receiver by name rather than ID.
   static const uint8_t named_receiver_flag = 0x01;
 
+  /// Marks a compressed payload. In handshakes, signals that the sender
+  /// has compression enabled.
+  static const uint8_t compressed_flag = 0x02;
+
+  /// Marks a routed message that refers to its source and destination node
+  /// by handles previously assigned via `intern_node`.
+  static const uint8_t interned_flag = 0x04;
+
   /// Identifies the config server.
   static const uint64_t config_server_id = 1;
 
@@ -110,6 +120,44 @@ CAF_IO_EXPORT bool valid(const header& hdr);
 constexpr size_t header_size
   = sizeof(actor_id) * 2 + sizeof(uint32_t) * 2 + sizeof(uint64_t);
 
+/// Maximum payload size of a single message that BASP packs into a
+/// `batched_message`. Larger messages gain nothing from batching.
+constexpr size_t max_batched_payload = 1024;
+
+/// Maximum payload size of a `batched_message`. BASP writes pending batches
+/// early once they reach this size.
+constexpr size_t max_batch_size = 64 * 1024;
+
+/// Maximum number of node IDs that BASP interns per connection and direction.
+constexpr size_t max_interned_nodes = 1024;
+
+/// Appends `x` to `buf` in varbyte encoding, i.e., with seven bits per byte.
+CAF_IO_EXPORT void write_varbyte(byte_buffer& buf, uint64_t x);
+
+/// Reads a varbyte-encoded integer from the front of `bytes` into `x` and
+/// drops the consumed bytes from `bytes`. Returns `false` if `bytes` does not
+/// start with a valid varbyte-encoded integer.
+CAF_IO_EXPORT bool read_varbyte(span<const byte>& bytes, uint64_t& x);
+
+/// Appends the compact sub-header for the direct message `hdr` to `buf`. A
+/// sub-header stores the flags plus the upper four bits of the message ID in
+/// one byte, followed by the request ID, the source and destination actor
+/// IDs, and the payload size in varbyte encoding.
+/// @pre `hdr.flags < 0x10`
+/// @relates header
+CAF_IO_EXPORT void write_sub_header(byte_buffer& buf, const header& hdr);
+
+/// Reads a sub-header from the front of `bytes` into `hdr` and drops the
+/// consumed bytes from `bytes`. Returns `false` if `bytes` does not start with
+/// a valid sub-header or contains less than `hdr.payload_len` bytes after it.
+/// @relates header
+CAF_IO_EXPORT bool read_sub_header(span<const byte>& bytes, header& hdr);
+
+/// Checks whether `bytes` consists of exactly `n` sub-headers, each followed
+/// by its payload.
+/// @relates header
+CAF_IO_EXPORT bool valid_batch(span<const byte> bytes, uint64_t n);
+
 /// @}
 
 } // namespace caf::io::basp
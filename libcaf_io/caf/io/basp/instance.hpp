@@ -19,6 +19,8 @@
 #pragma once
 
 #include <limits>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "caf/actor_system_config.hpp"
 #include "caf/byte_buffer.hpp"
@@ -97,6 +99,12 @@ public:
     /// Flushes the underlying write buffer of `hdl`.
     virtual void flush(connection_handle hdl) = 0;
 
+    /// Returns how many bytes wait for transmission on `hdl`.
+    virtual size_t pending_bytes(connection_handle hdl) = 0;
+
+    /// Called whenever `hdl` enters or leaves the congested state.
+    virtual void congestion_changed(connection_handle hdl, bool congested) = 0;
+
     /// Returns a handle to the callee actor.
     virtual strong_actor_ptr this_actor() = 0;
 
@@ -146,6 +154,39 @@ public:
   size_t remove_published_actor(const actor_addr& whom, uint16_t port,
                                 removed_published_actor* cb = nullptr);
 
+  /// Starts coalescing direct messages to peers that accept
+  /// `batched_message` frames. Coalesced messages remain pending until the
+  /// next call to `flush_batches`.
+  void begin_batching();
+
+  /// Writes all pending batches and stops coalescing messages.
+  void flush_batches(execution_unit* ctx);
+
+  /// Writes the pending batch for `hdl`, if any. Must run before writing any
+  /// other data to `hdl` in order to preserve the message order.
+  void flush_batch(execution_unit* ctx, connection_handle hdl);
+
+  /// Drops all per-connection state for `hdl`, such as pending batches.
+  void erase_connection(connection_handle hdl);
+
+  /// Disables batching and node interning for `hdl`. Both rely on receiving
+  /// all messages in order, which transports with independent streams per
+  /// sender do not provide. Must run before the handshake.
+  void mark_unordered(connection_handle hdl);
+
+  /// Destroys one worker that the instance has added on demand if all workers
+  /// have been idle for at least `middleman.worker-idle-timeout`.
+  void shrink_workers(actor_clock::time_point now);
+
+  /// Returns whether `hdl` is congested, i.e., whether its pending bytes
+  /// reached the high watermark and did not fall to the low watermark since.
+  /// The instance drops messages with normal priority to congested peers.
+  bool congested(connection_handle hdl);
+
+  /// Updates the congestion state of `hdl` after the transport reported that
+  /// `remaining` bytes still wait for transmission.
+  void handle_data_transferred(connection_handle hdl, uint64_t remaining);
+
   /// Returns `true` if a path to destination existed, `false` otherwise.
   bool dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
                 const std::vector<strong_actor_ptr>& forwarding_stack,
@@ -225,15 +266,68 @@ public:
                           header& hdr, byte_buffer* payload);
 
 private:
+  /// Stores coalesced messages for a single connection.
+  struct batch {
+    /// Stores sub-headers, each followed by the payload of one message.
+    byte_buffer buf;
+
+    /// Number of messages in `buf`.
+    uint64_t size = 0;
+  };
+
   void forward(execution_unit* ctx, const node_id& dest_node, const header& hdr,
                byte_buffer& payload);
 
+  void forward(execution_unit* ctx, const node_id& source_node,
+               const node_id& dest_node, header hdr, span<const byte> payload);
+
+  void write_routed_message(execution_unit* ctx, connection_handle hdl,
+                            header& hdr, const node_id& source_node,
+                            const node_id& dest_node, payload_writer& writer);
+
+  bool intern(execution_unit* ctx, connection_handle hdl, const node_id& nid,
+              uint64_t& result);
+
+  bool read_route(execution_unit* ctx, connection_handle hdl, const header& hdr,
+                  const byte_buffer& payload, node_id& source_node,
+                  node_id& dest_node, span<const byte>& remainder);
+
+  void write_direct_message(execution_unit* ctx, connection_handle hdl,
+                            header& hdr, payload_writer& writer);
+
+  uint8_t handshake_flags() const;
+
+  void add_peer(connection_handle hdl, const header& handshake);
+
+  void handle_message(const node_id& last_hop, const node_id& source_node,
+                      header& hdr, span<const byte> payload);
+
+  worker* acquire_worker();
+
   routing_table tbl_;
   published_actor_map published_actors_;
   node_id this_node_;
   callee& callee_;
   message_queue queue_;
   detail::worker_hub<worker> hub_;
+  size_t min_workers_;
+  size_t max_workers_;
+  timespan worker_idle_timeout_;
+  bool batching_ = false;
+  std::unordered_set<connection_handle> batch_peers_;
+  std::unordered_map<connection_handle, batch> batches_;
+  size_t compression_threshold_;
+  size_t high_watermark_;
+  size_t low_watermark_;
+  std::unordered_set<connection_handle> congested_;
+  std::unordered_set<connection_handle> compression_peers_;
+  std::unordered_set<connection_handle> interning_peers_;
+  std::unordered_set<connection_handle> unordered_peers_;
+  std::unordered_map<connection_handle, std::unordered_map<node_id, uint64_t>>
+    interned_out_;
+  std::unordered_map<connection_handle, std::vector<node_id>> interned_in_;
+  byte_buffer scratch_;
+  byte_buffer compressed_;
 };
 
 /// @}
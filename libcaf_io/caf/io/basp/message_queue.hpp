@@ -18,11 +18,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 #include "caf/actor_control_block.hpp"
+#include "caf/config.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/fwd.hpp"
 #include "caf/mailbox_element.hpp"
@@ -31,6 +35,13 @@ namespace caf::io::basp {
 
 /// Enforces strict order of message delivery, i.e., deliver messages in the
 /// same order as if they were deserialized by a single thread.
+///
+/// The queue stores out-of-order messages in a ring buffer that is indexed by
+/// the message ID. Producers write their slot without synchronizing with each
+/// other. Afterwards, a producer tries to become the (single) drainer that
+/// ships all consecutive messages starting at `next_undelivered()`. Messages
+/// with IDs that are too far ahead for the ring spill into a mutex-protected
+/// overflow list.
 class CAF_IO_EXPORT message_queue {
 public:
   // -- member types -----------------------------------------------------------
@@ -44,7 +55,11 @@ public:
 
   // -- constructors, destructors, and assignment operators --------------------
 
-  message_queue();
+  explicit message_queue(size_t capacity = 1024);
+
+  message_queue(const message_queue&) = delete;
+
+  message_queue& operator=(const message_queue&) = delete;
 
   // -- mutators ---------------------------------------------------------------
 
@@ -52,27 +67,85 @@ public:
   void push(execution_unit* ctx, uint64_t id, strong_actor_ptr receiver,
             mailbox_element_ptr content);
 
+  /// Adds all messages in `xs` to the queue before trying to deliver any of
+  /// them. Clears `xs` afterwards.
+  void push(execution_unit* ctx, std::vector<actor_msg>& xs);
+
   /// Marks given ID as dropped, effectively skipping it without effect.
   void drop(execution_unit* ctx, uint64_t id);
 
   /// Returns the next ascending ID.
   uint64_t new_id();
 
-  // -- member variables -------------------------------------------------------
+  /// Reserves `n` consecutive IDs and returns the first one.
+  uint64_t new_ids(size_t n);
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the next available ascending ID.
+  uint64_t next_id() const noexcept {
+    return next_id_.load();
+  }
+
+  /// Returns the next ID that we can ship.
+  uint64_t next_undelivered() const noexcept {
+    return next_undelivered_.load();
+  }
+
+  /// Returns the capacity of the ring buffer.
+  size_t capacity() const noexcept {
+    return mask_ + 1;
+  }
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  struct slot {
+    std::atomic<bool> ready{false};
+    strong_actor_ptr receiver;
+    mailbox_element_ptr content;
+  };
+
+  // -- utility functions ------------------------------------------------------
+
+  /// Stores a message in its slot or in the overflow list without delivering
+  /// anything.
+  void store(uint64_t id, strong_actor_ptr receiver,
+             mailbox_element_ptr content);
+
+  /// Ships all consecutive messages unless another thread is already doing so.
+  void drain(execution_unit* ctx);
+
+  /// Moves all messages from the overflow list to the ring buffer that fit
+  /// into the ring starting at `first`.
+  void move_overflow(uint64_t first);
 
-  /// Protects all other properties.
-  std::mutex lock;
+  // -- member variables -------------------------------------------------------
 
   /// The next available ascending ID. The counter is large enough to overflow
   /// after roughly 600 years if we dispatch a message every microsecond.
-  uint64_t next_id;
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<uint64_t> next_id_;
+
+  /// The next ID that we can ship. Only the drainer modifies this counter.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<uint64_t> next_undelivered_;
+
+  /// Grants exclusive access to the front of the queue.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<bool> draining_;
+
+  /// Smallest ID in `overflow_` or the maximum value if `overflow_` is empty.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<uint64_t> overflow_min_;
+
+  /// Capacity of the ring minus one.
+  size_t mask_;
+
+  /// Stores messages that got ready before `next_undelivered_`.
+  std::unique_ptr<slot[]> slots_;
 
-  /// The next ID that we can ship.
-  uint64_t next_undelivered;
+  /// Guards `overflow_`.
+  std::mutex overflow_mtx_;
 
-  /// Keeps messages in sorted order in case a message other than
-  /// `next_undelivered` gets ready first.
-  std::vector<actor_msg> pending;
+  /// Keeps messages in sorted order that do not fit into the ring yet.
+  std::vector<actor_msg> overflow_;
 };
 
 } // namespace caf::io::basp
@@ -71,6 +71,20 @@ enum class message_type : uint8_t {
   ///
   /// ![](heartbeat.png)
   heartbeat = 0x06,
+
+  /// Transmits multiple direct messages to a directly connected node. The
+  /// payload consists of one compact sub-header per message, each followed by
+  /// the payload of a direct message. Nodes send this message only to peers
+  /// that announced at least `batching_version` in their handshake.
+  batched_message = 0x07,
+
+  /// Assigns the handle in the operation data field to the node ID in the
+  /// payload. Routed messages with the `interned_flag` refer to their source
+  /// and destination nodes by these handles. Each connection and direction
+  /// has its own table, handles count up from zero. Nodes send this message
+  /// only to peers that announced at least `interning_version` in their
+  /// handshake.
+  intern_node = 0x08,
 };
 
 /// @relates message_type
@@ -27,11 +27,13 @@
 #include "caf/detail/scope_guard.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
 #include "caf/execution_unit.hpp"
+#include "caf/io/basp/compression.hpp"
 #include "caf/io/basp/header.hpp"
 #include "caf/logger.hpp"
 #include "caf/message.hpp"
 #include "caf/message_id.hpp"
 #include "caf/node_id.hpp"
+#include "caf/span.hpp"
 
 namespace caf::io::basp {
 
@@ -48,10 +50,20 @@ public:
     std::vector<strong_actor_ptr> stages;
     message msg;
     auto mid = make_message_id(dref.hdr_.operation_data);
-    binary_deserializer source{ctx, dref.payload_};
     // Make sure to drop the message in case we return abnormally.
     auto guard
-      = detail::make_scope_guard([&] { dref.queue_->drop(ctx, dref.msg_id_); });
+      = detail::make_scope_guard([&] { dref.deliver(ctx, nullptr, nullptr); });
+    // Restore compressed payloads before deserializing anything.
+    span<const byte> payload{dref.payload_.data(), dref.payload_.size()};
+    byte_buffer decompressed;
+    if (dref.hdr_.has(basp::header::compressed_flag)) {
+      if (!decompress(decompressed, payload)) {
+        CAF_LOG_ERROR("cannot decompress payload of remote message");
+        return;
+      }
+      payload = span<const byte>{decompressed.data(), decompressed.size()};
+    }
+    binary_deserializer source{ctx, payload};
     // Registry setup.
     dref.proxies_->set_last_hop(&dref.last_hop_);
     // Get the local receiver.
@@ -70,15 +82,10 @@ public:
       CAF_LOG_INFO("drop asynchronous remote message: unknown destination");
       return;
     }
-    // Deserialize source and destination node for routed messages.
+    // The broker already resolved the route of routed messages, i.e., the
+    // payload starts after source and destination node.
     if (dref.hdr_.operation == basp::message_type::routed_message) {
-      node_id src_node;
-      node_id dst_node;
-      if (auto err = source(src_node, dst_node)) {
-        CAF_LOG_ERROR("cannot read source and destination of remote message");
-        return;
-      }
-      CAF_ASSERT(dst_node == sys.node());
+      const auto& src_node = dref.source_node_;
       if (dref.hdr_.source_actor != 0) {
         src = src_node == sys.node()
                 ? sys.registry().get(dref.hdr_.source_actor)
@@ -121,9 +128,9 @@ public:
     }
     // Ship the message.
     guard.disable();
-    dref.queue_->push(ctx, dref.msg_id_, std::move(dst),
-                      make_mailbox_element(std::move(src), mid,
-                                           std::move(stages), std::move(msg)));
+    dref.deliver(ctx, std::move(dst),
+                 make_mailbox_element(std::move(src), mid, std::move(stages),
+                                      std::move(msg)));
   }
 };
 
@@ -18,12 +18,12 @@
 
 #pragma once
 
-#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "caf/detail/io_export.hpp"
+#include "caf/detail/shared_spinlock.hpp"
 #include "caf/io/abstract_broker.hpp"
 #include "caf/node_id.hpp"
 
@@ -84,7 +84,7 @@ public:
   using node_id_set = std::unordered_set<node_id>;
 
   abstract_broker* parent_;
-  mutable std::mutex mtx_;
+  mutable detail::shared_spinlock mtx_;
   std::unordered_map<connection_handle, node_id> direct_by_hdl_;
   std::unordered_map<node_id, connection_handle> direct_by_nid_;
   std::unordered_map<node_id, node_id_set> indirect_;
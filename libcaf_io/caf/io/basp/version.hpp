@@ -25,7 +25,16 @@ namespace caf::io::basp {
 /// @addtogroup BASP
 
 /// The current BASP version. Note: BASP is not backwards compatible.
-constexpr uint64_t version = 3;
+constexpr uint64_t version = 5;
+
+/// The first BASP version that accepts `batched_message` frames. Nodes
+/// announce their version in the handshake and only send batches to peers
+/// that support them.
+constexpr uint64_t batching_version = 4;
+
+/// The first BASP version that accepts `intern_node` messages and routed
+/// messages with interned node IDs.
+constexpr uint64_t interning_version = 5;
 
 /// @}
 
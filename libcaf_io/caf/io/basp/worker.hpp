@@ -30,9 +30,12 @@
 #include "caf/fwd.hpp"
 #include "caf/io/basp/fwd.hpp"
 #include "caf/io/basp/header.hpp"
+#include "caf/io/basp/message_queue.hpp"
 #include "caf/io/basp/remote_message_handler.hpp"
+#include "caf/io/connection_handle.hpp"
 #include "caf/node_id.hpp"
 #include "caf/resumable.hpp"
+#include "caf/span.hpp"
 
 namespace caf::io::basp {
 
@@ -61,14 +64,40 @@ public:
 
   // -- management -------------------------------------------------------------
 
+  /// Schedules deserialization of a single `direct_message`.
   void launch(const node_id& last_hop, const basp::header& hdr,
-              const byte_buffer& payload);
+              span<const byte> payload);
+
+  /// Schedules deserialization of all messages in a `batched_message` that
+  /// arrived on `hdl`. The worker also splits and validates the sub-headers.
+  /// For malformed batches, the worker drops all messages of the batch and
+  /// sends `(close_atom, hdl)` to `broker` in order.
+  void launch(strong_actor_ptr broker, connection_handle hdl,
+              const node_id& last_hop, const basp::header& hdr,
+              span<const byte> payload);
+
+  /// Schedules deserialization of a single `routed_message` from
+  /// `source_node`. The caller resolves the route, i.e., `payload` starts
+  /// after source and destination node.
+  void launch(const node_id& last_hop, const node_id& source_node,
+              const basp::header& hdr, span<const byte> payload);
 
   // -- implementation of resumable --------------------------------------------
 
   resume_result resume(execution_unit* ctx, size_t) override;
 
 private:
+  // -- utility functions ------------------------------------------------------
+
+  /// Splits the `batched_message` in `batch_` and handles each message.
+  void handle_batch(execution_unit* ctx);
+
+  /// Ships the message with ID `msg_id_` or skips the ID if `receiver` is
+  /// `nullptr`. While handling a batch, the worker collects all messages and
+  /// ships them at once.
+  void deliver(execution_unit* ctx, strong_actor_ptr receiver,
+               mailbox_element_ptr content);
+
   // -- constants and assertions -----------------------------------------------
 
   /// Stores how many bytes the "first half" of this object requires.
@@ -102,12 +131,32 @@ private:
   /// Identifies the node that sent us `hdr_` and `payload_`.
   node_id last_hop_;
 
-  /// The header for the next message. Either a direct_message or a
-  /// routed_message.
+  /// Identifies the node that created `hdr_` and `payload_`.
+  node_id source_node_;
+
+  /// The header for the next message. Either a direct_message, a
+  /// routed_message or a batched_message.
   header hdr_;
 
   /// Contains whatever this worker deserializes next.
   byte_buffer payload_;
+
+  /// Contains the payload of a batched_message.
+  byte_buffer batch_;
+
+  /// Receives `(close_atom, hdl_)` if `batch_` is malformed. The worker only
+  /// holds a reference while handling a batch.
+  strong_actor_ptr broker_;
+
+  /// Identifies the connection that received `batch_`.
+  connection_handle hdl_;
+
+  /// Collects deserialized messages of a batch. Allows the worker to drain
+  /// the message queue only once per batch.
+  std::vector<message_queue::actor_msg> delivered_;
+
+  /// Signals whether `deliver` appends to `delivered_`.
+  bool in_batch_ = false;
 };
 
 } // namespace caf::io::basp
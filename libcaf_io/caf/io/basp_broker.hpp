@@ -33,6 +33,7 @@
 #include "caf/detail/io_export.hpp"
 #include "caf/forwarding_actor_proxy.hpp"
 #include "caf/io/basp/all.hpp"
+#include "caf/io/basp/datagram_scribe.hpp"
 #include "caf/io/broker.hpp"
 #include "caf/io/typed_broker.hpp"
 #include "caf/proxy_registry.hpp"
@@ -51,6 +52,9 @@ public:
 
   using ctx_map = std::unordered_map<connection_handle, basp::endpoint_context>;
 
+  using udp_scribe_map
+    = std::unordered_map<connection_handle, basp::datagram_scribe_ptr>;
+
   using monitored_actor_map
     = std::unordered_map<actor_addr, std::unordered_set<node_id>>;
 
@@ -96,6 +100,10 @@ public:
 
   void flush(connection_handle hdl) override;
 
+  size_t pending_bytes(connection_handle hdl) override;
+
+  void congestion_changed(connection_handle hdl, bool congested) override;
+
   void handle_heartbeat() override;
 
   execution_unit* current_execution_unit() override;
@@ -116,6 +124,34 @@ public:
   /// Cleans up any state for `hdl`.
   void connection_cleanup(connection_handle hdl, sec code);
 
+  /// Closes all servants that accept peers on `port`, i.e., the TCP doorman,
+  /// its local counterpart and the UDP servant if present. Returns whether at
+  /// least one servant was closed.
+  bool close_port(uint16_t port);
+
+  /// Creates a scribe for the UDP peer at `hdl` and adds it to this broker.
+  basp::datagram_scribe& add_udp_scribe(datagram_handle hdl);
+
+  /// Passes a datagram to the scribe of its peer, creating a new scribe for
+  /// unknown peers that send a client handshake.
+  void handle_datagram(new_datagram_msg& msg);
+
+  /// Processes a single BASP message from the UDP peer at `hdl`.
+  void handle_frame(connection_handle hdl, byte_buffer& frame);
+
+  /// Cleans up any state for the UDP peer at `hdl` and closes its scribe
+  /// gracefully, i.e., the scribe keeps sending until the peer acknowledged
+  /// all pending messages.
+  void close_udp_scribe(connection_handle hdl, sec code);
+
+  /// Closes the scribe for the UDP peer at `hdl` without waiting for pending
+  /// messages, e.g., because its datagram servant is gone.
+  void drop_udp_scribe(connection_handle hdl, sec code);
+
+  /// Releases a detached scribe for the UDP peer at `hdl`, closing its
+  /// datagram servant if the servant serves only this peer.
+  void release_udp_scribe(connection_handle hdl);
+
   /// Sends a basp::down_message message to a remote node.
   void send_basp_down_message(const node_id& nid, actor_id aid, error err);
 
@@ -142,6 +178,14 @@ public:
   /// Keeps context information for all open connections.
   ctx_map ctx;
 
+  /// Keeps track of scribes for UDP peers. Scribes of peers on published
+  /// ports remain in this map after closing in order to drop late packets of
+  /// the closed session.
+  udp_scribe_map udp_scribes;
+
+  /// Configures the probability for dropping outgoing UDP datagrams.
+  double udp_loss_rate = 0.0;
+
   /// points to the current context for callbacks.
   basp::endpoint_context* this_context;
 
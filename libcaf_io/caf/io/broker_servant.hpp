@@ -113,6 +113,8 @@ protected:
   }
 
   SysMsgType& msg() {
+    // The broker may have moved the previous message out of `value_`.
+    value_.reset_promotion();
     return value_.template get_mutable_as<SysMsgType>(0);
   }
 
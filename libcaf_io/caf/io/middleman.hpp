@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <memory>
@@ -25,6 +26,7 @@
 #include <vector>
 
 #include "caf/actor_system.hpp"
+#include "caf/detail/fnv_hash.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/detail/unique_function.hpp"
 #include "caf/expected.hpp"
@@ -74,6 +76,24 @@ public:
                    system().message_types(tk), port, in, reuse);
   }
 
+  /// Tries to publish `whom` at UDP `port` and returns either an `error` or
+  /// the bound port. Peers connect via `remote_actor_udp`. BASP then runs over
+  /// a reliability layer that delivers the messages of each sender in order,
+  /// i.e., a lost datagram no longer delays messages of unrelated actors.
+  /// @param whom Actor that should be published at `port`.
+  /// @param port Unused UDP port.
+  /// @param in The IP address to listen to or `INADDR_ANY` if `in == nullptr`.
+  /// @param reuse Create socket using `SO_REUSEADDR`.
+  /// @returns The actual port the OS uses after `bind()`. If `port == 0`
+  ///          the OS chooses a random high-level port.
+  template <class Handle>
+  expected<uint16_t> publish_udp(Handle&& whom, uint16_t port,
+                                 const char* in = nullptr, bool reuse = false) {
+    detail::type_list<typename std::decay<Handle>::type> tk;
+    return publish_udp(actor_cast<strong_actor_ptr>(std::forward<Handle>(whom)),
+                       system().message_types(tk), port, in, reuse);
+  }
+
   /// Makes *all* local groups accessible via network
   /// on address `addr` and `port`.
   /// @returns The actual port the OS uses after `bind()`. If `port == 0`
@@ -105,6 +125,22 @@ public:
     return actor_cast<ActorHandle>(std::move(*x));
   }
 
+  /// Establish a new connection to the actor at `host` on given UDP `port`.
+  /// @param host Valid hostname or IP address.
+  /// @param port UDP port of an actor published via `publish_udp`.
+  /// @returns An `actor` to the proxy instance representing
+  ///          a remote actor or an `error`.
+  template <class ActorHandle = actor>
+  expected<ActorHandle> remote_actor_udp(std::string host, uint16_t port) {
+    detail::type_list<ActorHandle> tk;
+    auto x = remote_actor_udp(system().message_types(tk), std::move(host),
+                              port);
+    if (!x)
+      return x.error();
+    CAF_ASSERT(x && *x);
+    return actor_cast<ActorHandle>(std::move(*x));
+  }
+
   /// <group-name>@<host>:<port>
   expected<group> remote_group(const std::string& group_uri);
 
@@ -147,6 +183,24 @@ public:
   /// Returns the IO backend used by this middleman.
   virtual network::multiplexer& backend() = 0;
 
+  /// Returns the number of multiplexers, each running in its own thread.
+  size_t num_backends() const noexcept {
+    return 1 + aux_backends_.size();
+  }
+
+  /// Returns the multiplexer at position `index`. The multiplexer at index 0
+  /// is always `backend()`.
+  network::multiplexer& backend_at(size_t index);
+
+  /// Returns the multiplexer for a connection with given `hash`.
+  network::multiplexer& backend_for(size_t hash) {
+    return backend_at(hash % num_backends());
+  }
+
+  /// Returns `host` if it refers to one of the multiplexers of this
+  /// middleman, `nullptr` otherwise.
+  network::multiplexer* backend_of(execution_unit* host) noexcept;
+
   /// Returns the actor associated with `name` at `nid` or
   /// `invalid_actor` if `nid` is not connected or has no actor
   /// associated to this `name`.
@@ -185,6 +239,12 @@ public:
   /// Used to initialize the backend during construction.
   using backend_factory = std::function<backend_pointer()>;
 
+  /// Creates an additional multiplexer of the same type as `backend()` or
+  /// returns `nullptr` if the backend only supports a single instance. The
+  /// default implementation always returns `nullptr`. Of the built-in
+  /// backends, only the `default_multiplexer` supports multiple instances.
+  virtual backend_pointer make_backend();
+
   void start() override;
 
   void stop() override;
@@ -207,7 +267,7 @@ public:
     static constexpr bool spawnable = detail::spawnable<F, impl, Ts...>();
     static_assert(spawnable,
                   "cannot spawn function-based broker with given arguments");
-    actor_config cfg{&backend()};
+    actor_config cfg{&backend_for(next_backend_++)};
     detail::bool_token<spawnable> enabled;
     return system().spawn_functor<Os>(enabled, cfg, fun,
                                       std::forward<Ts>(xs)...);
@@ -248,6 +308,36 @@ public:
                                        std::forward<Ts>(xs)...);
   }
 
+  /// Spawns one broker per multiplexer, each accepting connections on `port`
+  /// with its own socket. The kernel distributes incoming connections among
+  /// all sockets via `SO_REUSEPORT`. Spawns a single broker if only one
+  /// multiplexer exists or if the platform does not support `SO_REUSEPORT`.
+  /// @warning Blocks the caller until the server sockets are initialized.
+  template <spawn_options Os = no_spawn_options,
+            class F = std::function<void(broker*)>, class... Ts>
+  expected<std::vector<typename infer_handle_from_fun<F>::type>>
+  spawn_sharded_server(F fun, uint16_t& port, Ts&&... xs) {
+    using impl = typename infer_handle_from_fun<F>::impl;
+    using handle = typename infer_handle_from_fun<F>::type;
+    auto doormen = new_sharded_doormen(port);
+    if (!doormen)
+      return std::move(doormen.error());
+    std::vector<handle> result;
+    result.reserve(doormen->size());
+    for (size_t i = 0; i < doormen->size(); ++i) {
+      auto ptr = std::move((*doormen)[i]);
+      detail::init_fun_factory<impl, F> fac;
+      auto fptr = fac.make(fun, xs...);
+      fptr->hook([=](local_actor* self) mutable {
+        static_cast<abstract_broker*>(self)->add_doorman(std::move(ptr));
+      });
+      actor_config cfg{&backend_at(i)};
+      cfg.init_fun.assign(fptr.release());
+      result.emplace_back(system().spawn_class<impl, Os>(cfg));
+    }
+    return result;
+  }
+
   /// Returns a middleman using the default network backend.
   static actor_system::module* make(actor_system&, detail::type_list<>);
 
@@ -277,13 +367,15 @@ private:
   template <spawn_options Os, class Impl, class F, class... Ts>
   expected<typename infer_handle_from_class<Impl>::type>
   spawn_client_impl(F fun, const std::string& host, uint16_t port, Ts&&... xs) {
-    auto eptr = backend().new_tcp_scribe(host, port);
+    auto& mpx = backend_for(
+      detail::fnv_hash_append(detail::fnv_hash(host), port));
+    auto eptr = mpx.new_tcp_scribe(host, port);
     if (!eptr)
       return eptr.error();
     auto ptr = std::move(*eptr);
     CAF_ASSERT(ptr != nullptr);
     detail::init_fun_factory<Impl, F> fac;
-    actor_config cfg{&backend()};
+    actor_config cfg{&mpx};
     auto fptr = fac.make(std::move(fun), ptr->hdl(), std::forward<Ts>(xs)...);
     fptr->hook([=](local_actor* self) mutable {
       static_cast<abstract_broker*>(self)->add_scribe(std::move(ptr));
@@ -295,7 +387,10 @@ private:
   template <spawn_options Os, class Impl, class F, class... Ts>
   expected<typename infer_handle_from_class<Impl>::type>
   spawn_server_impl(F fun, uint16_t& port, Ts&&... xs) {
-    auto eptr = backend().new_tcp_doorman(port);
+    // Picking the multiplexer by port would put all servers on ephemeral
+    // ports on the same multiplexer.
+    auto& mpx = backend_for(next_backend_++);
+    auto eptr = mpx.new_tcp_doorman(port);
     if (!eptr)
       return eptr.error();
     auto ptr = std::move(*eptr);
@@ -305,11 +400,13 @@ private:
     fptr->hook([=](local_actor* self) mutable {
       static_cast<abstract_broker*>(self)->add_doorman(std::move(ptr));
     });
-    actor_config cfg{&backend()};
+    actor_config cfg{&mpx};
     cfg.init_fun.assign(fptr.release());
     return system().spawn_class<Impl, Os>(cfg);
   }
 
+  expected<std::vector<doorman_ptr>> new_sharded_doormen(uint16_t& port);
+
   expected<strong_actor_ptr>
   remote_spawn_impl(const node_id& nid, std::string& name, message& args,
                     std::set<std::string> s, timespan timeout);
@@ -318,11 +415,18 @@ private:
   publish(const strong_actor_ptr& whom, std::set<std::string> sigs,
           uint16_t port, const char* cstr, bool ru);
 
+  expected<uint16_t>
+  publish_udp(const strong_actor_ptr& whom, std::set<std::string> sigs,
+              uint16_t port, const char* cstr, bool ru);
+
   expected<void> unpublish(const actor_addr& whom, uint16_t port);
 
   expected<strong_actor_ptr>
   remote_actor(std::set<std::string> ifs, std::string host, uint16_t port);
 
+  expected<strong_actor_ptr>
+  remote_actor_udp(std::set<std::string> ifs, std::string host, uint16_t port);
+
   static int exec_slave_mode(actor_system&, const actor_system_config&);
 
   // environment
@@ -331,6 +435,15 @@ private:
   network::multiplexer::supervisor_ptr backend_supervisor_;
   // runs the backend
   std::thread thread_;
+  // additional multiplexers if `middleman.multiplexer-threads` is > 1
+  std::vector<backend_pointer> aux_backends_;
+  // prevent additional multiplexers from shutting down
+  std::vector<network::multiplexer::supervisor_ptr> aux_supervisors_;
+  // run the additional multiplexers
+  std::vector<std::thread> aux_threads_;
+  // selects the multiplexer for the next broker without connection and for
+  // the next server
+  std::atomic<size_t> next_backend_;
   // keeps track of "singleton-like" brokers
   std::map<std::string, actor> named_brokers_;
   // actor offering asynchronous IO by managing this singleton instance
@@ -62,6 +62,20 @@ namespace caf::io {
 ///   (connect_atom, string hostname, uint16_t port)
 ///   -> (node_id nid, strong_actor_ptr remote_actor, set<string> ifs)
 ///
+///   // Same as `publish_atom`, but runs BASP over UDP with a reliability
+///   // layer that delivers the messages of each sender in order.
+///   // port: Unused UDP port or 0 for any.
+///   (publish_udp_atom, uint16_t port, strong_actor_ptr whom,
+///    set<string> ifs, string addr, bool reuse_addr)
+///   -> (uint16_t)
+///
+///   // Same as `connect_atom`, but contacts a node that published an actor
+///   // via `publish_udp_atom`.
+///   // hostname: IP address or DNS hostname.
+///   // port: UDP port.
+///   (contact_atom, string hostname, uint16_t port)
+///   -> (node_id nid, strong_actor_ptr remote_actor, set<string> ifs)
+///
 ///   // Closes `port` if it is mapped to `whom`.
 ///   // whom: A published actor.
 ///   // port: Used TCP port.
@@ -83,6 +97,13 @@ namespace caf::io {
 ///   (spawn_atom, node_id nid, string name, message args)
 ///   -> (strong_actor_ptr, set<string>)
 ///
+///   // Returns how many bytes wait for transmission on the connection to
+///   // `nid` and whether the connection is congested, i.e., whether the
+///   // middleman currently drops regular messages to `nid`.
+///   // nid: ID of a connected node.
+///   (get_atom, pending_atom, node_id nid)
+///   -> (uint64_t, bool)
+///
 /// }
 /// ~~~
 using middleman_actor = typed_actor<
@@ -94,6 +115,12 @@ using middleman_actor = typed_actor<
   replies_to<connect_atom, std::string,
              uint16_t>::with<node_id, strong_actor_ptr, std::set<std::string>>,
 
+  replies_to<publish_udp_atom, uint16_t, strong_actor_ptr,
+             std::set<std::string>, std::string, bool>::with<uint16_t>,
+
+  replies_to<contact_atom, std::string,
+             uint16_t>::with<node_id, strong_actor_ptr, std::set<std::string>>,
+
   reacts_to<unpublish_atom, actor_addr, uint16_t>,
 
   reacts_to<close_atom, uint16_t>,
@@ -101,7 +128,9 @@ using middleman_actor = typed_actor<
   replies_to<spawn_atom, node_id, std::string, message,
              std::set<std::string>>::with<strong_actor_ptr>,
 
-  replies_to<get_atom, node_id>::with<node_id, std::string, uint16_t>>;
+  replies_to<get_atom, node_id>::with<node_id, std::string, uint16_t>,
+
+  replies_to<get_atom, pending_atom, node_id>::with<uint64_t, bool>>;
 
 /// @relates middleman_actor
 CAF_IO_EXPORT middleman_actor make_middleman_actor(actor_system& sys, actor db);
@@ -62,11 +62,12 @@ public:
 
 protected:
   /// Tries to connect to given `host` and `port`. The default implementation
-  /// calls `system().middleman().backend().new_tcp_scribe(host, port)`.
+  /// calls `system().middleman().backend().new_tcp_scribe(host, port)`, unless
+  /// `host` is this machine and the peer listens on a local socket.
   virtual expected<scribe_ptr> connect(const std::string& host, uint16_t port);
 
   /// Tries to connect to given `host` and `port`. The default implementation
-  /// calls `system().middleman().backend().new_udp`.
+  /// calls `system().middleman().backend().new_remote_udp_endpoint`.
   virtual expected<datagram_servant_ptr>
   contact(const std::string& host, uint16_t port);
 
@@ -76,10 +77,16 @@ protected:
   open(uint16_t port, const char* addr, bool reuse);
 
   /// Tries to open a local port. The default implementation calls
-  /// `system().middleman().backend().new_tcp_doorman(port, addr, reuse)`.
+  /// `system().middleman().backend().new_local_udp_endpoint(port, addr,
+  /// reuse)`.
   virtual expected<datagram_servant_ptr>
   open_udp(uint16_t port, const char* addr, bool reuse);
 
+  /// Tries to open a local socket that shadows the TCP doorman at `port`. The
+  /// default implementation calls
+  /// `system().middleman().backend().new_local_doorman(path, port)`.
+  virtual expected<doorman_ptr> open_local(uint16_t port);
+
 private:
   put_res put(uint16_t port, strong_actor_ptr& whom, mpi_set& sigs,
               const char* in = nullptr, bool reuse_addr = false);
@@ -87,15 +94,25 @@ private:
   put_res put_udp(uint16_t port, strong_actor_ptr& whom, mpi_set& sigs,
                   const char* in = nullptr, bool reuse_addr = false);
 
+  /// Connects to `key` via UDP if `udp` is `true` or via TCP otherwise.
+  /// Requests to the same endpoint share the result of the first request.
+  get_res connect_to(endpoint key, bool udp);
+
+  /// Returns the path of the local socket for `port` or an empty string if
+  /// `middleman.local-socket-dir` is not set.
+  std::string local_socket_path(uint16_t port);
+
   optional<endpoint_data&> cached_tcp(const endpoint& ep);
   optional<endpoint_data&> cached_udp(const endpoint& ep);
 
-  optional<std::vector<response_promise>&> pending(const endpoint& ep);
+  optional<std::vector<response_promise>&> pending(const endpoint& ep,
+                                                    bool udp = false);
 
   actor broker_;
   std::map<endpoint, endpoint_data> cached_tcp_;
   std::map<endpoint, endpoint_data> cached_udp_;
   std::map<endpoint, std::vector<response_promise>> pending_;
+  std::map<endpoint, std::vector<response_promise>> pending_udp_;
 };
 
 } // namespace caf::io
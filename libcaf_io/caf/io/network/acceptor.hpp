@@ -62,12 +62,15 @@ protected:
   template <class Policy>
   void handle_event_impl(io::network::operation op, Policy& policy) {
     CAF_LOG_TRACE(CAF_ARG(fd()) << CAF_ARG(op));
+    state_.read_pending = false;
     if (mgr_ && op == operation::read) {
       native_socket sockfd = invalid_native_socket;
       if (policy.try_accept(sockfd, fd())) {
         if (sockfd != invalid_native_socket) {
           sock_ = sockfd;
           mgr_->new_connection();
+          // More connections may wait in the backlog.
+          state_.read_pending = mgr_ != nullptr;
         }
       }
     }
@@ -0,0 +1,76 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+
+namespace caf::io::network {
+
+/// Caches byte buffers for reuse by the I/O handlers and brokers of a
+/// multiplexer. Recycled buffers keep their capacity, which allows handlers to
+/// replace buffers they passed on to a broker without allocating memory. The
+/// pool drops buffers that grew beyond a maximum capacity to make sure that a
+/// single large message does not pin its memory in the pool.
+/// @warning Not thread safe. Only the thread running the multiplexer may
+///          access its pool.
+class CAF_IO_EXPORT byte_buffer_pool {
+public:
+  byte_buffer_pool(size_t max_size, size_t max_capacity);
+
+  byte_buffer_pool(const byte_buffer_pool&) = delete;
+
+  byte_buffer_pool& operator=(const byte_buffer_pool&) = delete;
+
+  /// Returns an empty buffer, reusing the memory of a recycled buffer if
+  /// possible.
+  byte_buffer get();
+
+  /// Returns an empty buffer with a capacity of at least `min_capacity`.
+  byte_buffer get(size_t min_capacity);
+
+  /// Stores `buf` for later reuse. Drops `buf` if the pool is full or if `buf`
+  /// has no memory attached to it or a capacity above `max_capacity()`.
+  void put(byte_buffer&& buf);
+
+  /// Returns the number of cached buffers.
+  size_t size() const noexcept {
+    return buffers_.size();
+  }
+
+  /// Returns the maximum number of cached buffers.
+  size_t max_size() const noexcept {
+    return max_size_;
+  }
+
+  /// Returns the maximum capacity of cached buffers.
+  size_t max_capacity() const noexcept {
+    return max_capacity_;
+  }
+
+private:
+  size_t max_size_;
+  size_t max_capacity_;
+  std::vector<byte_buffer> buffers_;
+};
+
+} // namespace caf::io::network
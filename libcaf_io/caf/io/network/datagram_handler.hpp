@@ -115,12 +115,14 @@ protected:
       case io::network::operation::read: {
         // Loop until an error occurs or we have nothing more to read
         // or until we have handled `mcr` reads.
+        state_.read_pending = false;
         for (size_t i = 0; i < mcr; ++i) {
           auto res = policy.read_datagram(num_bytes_, fd(), rd_buf_.data(),
                                           rd_buf_.size(), sender_);
           if (!handle_read_result(res))
             return;
         }
+        state_.read_pending = num_bytes_ > 0;
         break;
       }
       case io::network::operation::write: {
@@ -140,6 +142,7 @@ protected:
         }
         auto res = policy.write_datagram(wb, fd(), buf.data(), buf.size(), ep);
         handle_write_result(res, id, buf, wb);
+        state_.write_pending = res && wb > 0 && state_.writing;
         break;
       }
       case operation::propagate_error:
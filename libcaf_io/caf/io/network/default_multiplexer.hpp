@@ -19,6 +19,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
@@ -66,6 +67,8 @@ struct epoll_event;
 
 namespace caf::io::network {
 
+class io_uring_context;
+
 // Define type aliases based on backend type.
 #ifdef CAF_POLL_MULTIPLEXER
 
@@ -113,6 +116,38 @@ public:
     }
   };
 
+#ifdef CAF_EPOLL_MULTIPLEXER
+  /// Selects how the multiplexer waits for socket events.
+  enum class backend_mode {
+    /// Uses level-triggered `epoll` and updates the interest set of a socket
+    /// with one `epoll_ctl` call per change.
+    level_triggered,
+    /// Registers each socket once for all events in edge-triggered `epoll`
+    /// mode and filters events based on the current interest.
+    edge_triggered,
+    /// Uses one-shot poll requests on an io_uring instance, submitting all
+    /// interest changes together with waiting for the next events.
+    io_uring,
+  };
+
+  /// Stores per-socket state for edge-triggered `epoll` and io_uring.
+  struct fd_entry {
+    /// Points to the handler for this socket or is `nullptr` if the socket is
+    /// not registered.
+    event_handler* ptr = nullptr;
+
+    /// Stores the events of the pending poll request for io_uring or 0 if
+    /// there is no pending request.
+    int armed = 0;
+
+    /// Allows io_uring to detect completions of cancelled requests.
+    uint32_t generation = 0;
+
+    /// Stores whether this socket is in the list of ready sockets.
+    bool ready = false;
+  };
+#endif // CAF_EPOLL_MULTIPLEXER
+
   scribe_ptr new_scribe(native_socket fd) override;
 
   expected<scribe_ptr>
@@ -123,6 +158,11 @@ public:
   expected<doorman_ptr>
   new_tcp_doorman(uint16_t port, const char* in, bool reuse_addr) override;
 
+  expected<scribe_ptr> new_local_scribe(const std::string& path) override;
+
+  expected<doorman_ptr>
+  new_local_doorman(const std::string& path, uint16_t port) override;
+
   datagram_servant_ptr new_datagram_servant(native_socket fd) override;
 
   datagram_servant_ptr
@@ -226,6 +266,27 @@ private:
 
   void handle(const event& e);
 
+#ifdef CAF_EPOLL_MULTIPLEXER
+  /// Implements `poll_once_impl` for the io_uring backend.
+  bool poll_io_uring(bool block);
+
+  /// Returns the state for `fd`.
+  fd_entry& entry(native_socket fd);
+
+  /// Returns the user data for a poll request on `fd`.
+  static uint64_t user_data(native_socket fd, const fd_entry& x);
+
+  /// Submits a poll request for the current interest of `x.ptr`.
+  void arm(native_socket fd, fd_entry& x);
+
+  /// Makes sure the event loop calls the handler for `fd` again in its next
+  /// iteration, even if the OS reports no new event.
+  void add_ready(native_socket fd);
+
+  /// Calls `add_ready` if `ptr` stopped before draining the socket.
+  void add_if_pending(native_socket fd, event_handler* ptr);
+#endif // CAF_EPOLL_MULTIPLEXER
+
   void handle_socket_event(native_socket fd, int mask, event_handler* ptr);
 
   void close_pipe();
@@ -263,6 +324,27 @@ private:
 
   /// Maximum messages per resume run.
   size_t max_throughput_;
+
+#ifdef CAF_EPOLL_MULTIPLEXER
+  /// Configures how we wait for socket events.
+  backend_mode mode_;
+
+  /// Maps file descriptors to their state. Unused in level-triggered mode.
+  std::vector<fd_entry> fds_;
+
+  /// Sockets the edge-triggered backend handles in the next iteration without
+  /// waiting for a new event.
+  std::vector<native_socket> ready_;
+
+  /// Swapped with `ready_` while handling events to re-use allocated memory.
+  std::vector<native_socket> ready_cache_;
+
+  /// Stores events from io_uring completions until handling them.
+  std::vector<event> polled_;
+
+  /// Submission and completion queues for the io_uring backend.
+  std::unique_ptr<io_uring_context> uring_;
+#endif // CAF_EPOLL_MULTIPLEXER
 };
 
 inline connection_handle conn_hdl_from_socket(native_socket fd) {
@@ -277,8 +359,21 @@ CAF_IO_EXPORT expected<native_socket>
 new_tcp_connection(const std::string& host, uint16_t port,
                    optional<protocol::network> preferred = none);
 
+/// Creates a listening TCP socket. Setting `reuse_port` enables
+/// `SO_REUSEPORT`, which allows several sockets to accept connections on the
+/// same port with the kernel balancing incoming connections between them.
+CAF_IO_EXPORT expected<native_socket>
+new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr,
+                      bool reuse_port = false);
+
+/// Connects to the local (Unix domain) stream socket at `path`.
+CAF_IO_EXPORT expected<native_socket>
+new_local_connection(const std::string& path);
+
+/// Creates a listening local (Unix domain) stream socket at `path`, replacing
+/// stale socket files left behind by previous processes.
 CAF_IO_EXPORT expected<native_socket>
-new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr);
+new_local_acceptor_impl(const std::string& path);
 
 expected<std::pair<native_socket, ip_endpoint>>
 new_remote_udp_endpoint_impl(const std::string& host, uint16_t port,
@@ -45,6 +45,12 @@ public:
 
     /// Stores what receive policy is currently active.
     unsigned rd_flag : 2;
+
+    /// Stores whether the last read event stopped before draining the socket.
+    bool read_pending : 1;
+
+    /// Stores whether the last write event stopped before the socket blocked.
+    bool write_pending : 1;
   };
 
   event_handler(default_multiplexer& dm, native_socket sockfd);
@@ -84,6 +90,14 @@ public:
     eventbf_ = value;
   }
 
+  /// Returns whether the last call to `handle_event(op)` stopped before the
+  /// socket would block, e.g., after reaching the maximum number of
+  /// consecutive reads. Edge-triggered multiplexers call `handle_event` again
+  /// in this case, because the OS reports no new event for the remaining data.
+  bool pending(operation op) const {
+    return op == operation::read ? state_.read_pending : state_.write_pending;
+  }
+
   /// Checks whether `close_read_channel` has been called.
   bool read_channel_closed() const {
     return !state_.reading;
@@ -0,0 +1,152 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include "caf/config.hpp"
+
+#ifdef CAF_LINUX
+
+#  include <cstddef>
+#  include <cstdint>
+#  include <utility>
+#  include <vector>
+
+#  include "caf/detail/io_export.hpp"
+#  include "caf/io/network/native_socket.hpp"
+
+// Forward declaration of C types.
+extern "C" {
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+} // extern "C"
+
+namespace caf::io::network {
+
+/// Minimal wrapper around the submission and completion rings of an io_uring
+/// instance. Talks to the kernel via raw system calls, i.e., does not depend
+/// on liburing.
+class CAF_IO_EXPORT io_uring_context {
+public:
+  io_uring_context();
+
+  io_uring_context(const io_uring_context&) = delete;
+
+  io_uring_context& operator=(const io_uring_context&) = delete;
+
+  ~io_uring_context();
+
+  /// Creates the rings with space for `entries` submissions.
+  /// @returns `false` if the kernel does not support io_uring or denies access
+  ///          to it, `true` otherwise.
+  bool init(unsigned entries);
+
+  /// Queues a request for waiting on the events in `mask` for `fd`. The
+  /// request completes only once, i.e., callers re-arm it after each event.
+  void poll_add(native_socket fd, uint32_t mask, uint64_t user_data);
+
+  /// Queues a request for cancelling the poll request that was queued with
+  /// `user_data`. The cancellation itself completes with `ignored_user_data`.
+  void poll_remove(uint64_t user_data);
+
+  /// Submits all queued requests to the kernel and optionally blocks until at
+  /// least one completion is available. Consumes all available completions by
+  /// calling `f(user_data, result)` for each of them.
+  /// @returns the number of consumed completions.
+  template <class F>
+  size_t submit_and_consume(bool block, F f) {
+    size_t result = backlog_.size();
+    // Deliver completions that we consumed while queueing requests first.
+    if (result > 0) {
+      block = false;
+      for (size_t i = 0; i < backlog_.size(); ++i)
+        f(backlog_[i].first, backlog_[i].second);
+      backlog_.clear();
+    }
+    submit(block);
+    uint64_t user_data;
+    int32_t res;
+    do {
+      while (next_completion(user_data, res)) {
+        ++result;
+        if (user_data != ignored_user_data)
+          f(user_data, res);
+      }
+      // Fetch completions that did not fit into the completion ring.
+    } while (overflowed() && submit(false));
+    return result;
+  }
+
+  /// Marks completions that carry no information for the caller.
+  static constexpr uint64_t ignored_user_data = ~uint64_t{0};
+
+private:
+  io_uring_sqe* next_sqe();
+
+  /// Passes all queued requests to the kernel.
+  /// @returns `false` if the kernel refused the requests because the
+  ///          completion ring is full, `true` otherwise.
+  bool submit(bool block);
+
+  /// Checks whether the kernel holds completions that did not fit into the
+  /// completion ring. Entering the ring moves them to the completion ring.
+  bool overflowed() const noexcept;
+
+  /// Moves all available completions to the backlog.
+  /// @returns the number of consumed completions.
+  size_t reap();
+
+  bool next_completion(uint64_t& user_data, int32_t& res);
+
+  int fd_;
+
+  // Memory regions shared with the kernel.
+  void* sq_ring_ptr_;
+  size_t sq_ring_size_;
+  void* cq_ring_ptr_;
+  size_t cq_ring_size_;
+  io_uring_sqe* sqes_;
+  size_t sqes_size_;
+
+  // Pointers into the submission ring.
+  unsigned* sq_head_;
+  unsigned* sq_tail_;
+  unsigned* sq_array_;
+  unsigned* sq_flags_;
+  unsigned sq_mask_;
+  unsigned sq_entries_;
+
+  // Pointers into the completion ring.
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  io_uring_cqe* cqes_;
+  unsigned cq_mask_;
+
+  // Number of queued submissions that we did not pass to the kernel yet.
+  unsigned pending_;
+
+  // Completions that we consumed while waiting for room in the submission
+  // ring. The next call to `submit_and_consume` delivers them.
+  std::vector<std::pair<uint64_t, int32_t>> backlog_;
+};
+
+} // namespace caf::io::network
+
+#endif // CAF_LINUX
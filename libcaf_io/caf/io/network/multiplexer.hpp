@@ -29,6 +29,7 @@
 #include "caf/io/accept_handle.hpp"
 #include "caf/io/connection_handle.hpp"
 #include "caf/io/fwd.hpp"
+#include "caf/io/network/byte_buffer_pool.hpp"
 #include "caf/io/network/ip_endpoint.hpp"
 #include "caf/io/network/native_socket.hpp"
 #include "caf/io/network/protocol.hpp"
@@ -66,6 +67,19 @@ public:
                   bool reuse_addr = false)
     = 0;
 
+  /// Tries to connect to the local stream socket at `path` and returns a
+  /// `scribe` instance on success. Local sockets bypass the TCP/IP stack for
+  /// peers running on the same host.
+  /// @threadsafe
+  virtual expected<scribe_ptr> new_local_scribe(const std::string& path);
+
+  /// Tries to create a doorman accepting connections on the local stream
+  /// socket at `path`. The doorman reports `port` as its port in order to
+  /// allow brokers to treat it as an alias for the TCP doorman at `port`.
+  /// @warning Do not call from outside the multiplexer's event loop.
+  virtual expected<doorman_ptr>
+  new_local_doorman(const std::string& path, uint16_t port);
+
   /// Creates a new `datagram_servant` from a native socket handle.
   /// @threadsafe
   virtual datagram_servant_ptr new_datagram_servant(native_socket fd) = 0;
@@ -162,10 +176,19 @@ public:
     tid_ = std::move(tid);
   }
 
+  /// Returns the pool of recycled buffers for this multiplexer.
+  /// @warning Must not be accessed outside the thread running the multiplexer.
+  byte_buffer_pool& buffer_pool() noexcept {
+    return buffer_pool_;
+  }
+
 protected:
   /// Identifies the thread this multiplexer
   /// is running in. Must be set by the subclass.
   std::thread::id tid_;
+
+  /// Caches buffers for reuse by brokers and I/O handlers.
+  byte_buffer_pool buffer_pool_;
 };
 
 using multiplexer_ptr = std::unique_ptr<multiplexer>;
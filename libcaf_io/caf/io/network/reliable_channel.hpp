@@ -0,0 +1,390 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/span.hpp"
+
+namespace caf::io::network {
+
+/// Implements reliable, ordered delivery of frames over an unreliable datagram
+/// transport. The channel performs no I/O on its own: users feed received
+/// datagrams into `handle_datagram`, collect outgoing datagrams via `transmit`
+/// and call `transmit` again once `next_timeout` expired.
+///
+/// Each frame belongs to a stream. Frames of the same stream arrive in the
+/// order they were sent, but a lost packet only blocks its own stream. Stream
+/// 0 carries control traffic: frames on other streams remain buffered until
+/// the peer's first control frame arrived, because that frame establishes
+/// the session on the upper layer (e.g., the BASP handshake). Receivers only
+/// buffer frames within a window of `receive_window` frames per stream and
+/// drop later packets without acknowledging them. Senders hold back frames
+/// that the peer would drop.
+///
+/// Every transmission of a chunk uses a new packet number. Packet numbers and
+/// frame sequence numbers have 64 bits on the wire and thus never wrap around
+/// in practice. Receivers
+/// acknowledge packet numbers with selective ACK ranges and senders detect
+/// losses either by packet reordering (three later packets acknowledged) or
+/// by time. A NewReno-style congestion window limits the bytes in flight and
+/// pacing spreads sending over the round-trip time.
+class CAF_IO_EXPORT reliable_channel {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using clock_type = std::chrono::steady_clock;
+
+  using time_point = clock_type::time_point;
+
+  using duration = clock_type::duration;
+
+  /// Receives complete frames with their stream ID.
+  using frame_consumer = std::function<void(uint16_t, byte_buffer&)>;
+
+  /// Receives outgoing datagrams.
+  using datagram_consumer = std::function<void(byte_buffer&)>;
+
+  // -- constants --------------------------------------------------------------
+
+  /// Maximum size of a single datagram, chosen to fit into common MTUs.
+  static constexpr size_t max_datagram_size = 1400;
+
+  /// Size of the type, session and packet number fields.
+  static constexpr size_t packet_header_size = 13;
+
+  /// Size of the stream, sequence number and fragment fields.
+  static constexpr size_t chunk_header_size = 14;
+
+  /// Maximum number of frame bytes in a single datagram.
+  static constexpr size_t max_chunk_size
+    = max_datagram_size - packet_header_size - chunk_header_size;
+
+  /// Maximum number of streams, including the control stream.
+  static constexpr uint16_t max_streams = 16;
+
+  /// Maximum size of a single frame.
+  static constexpr size_t max_frame_size = 16 * 1024 * 1024;
+
+  /// Maximum number of fragments of a single frame.
+  static constexpr size_t max_frags
+    = (max_frame_size + max_chunk_size - 1) / max_chunk_size;
+
+  /// Number of frames per stream a receiver buffers ahead of the next
+  /// expected frame.
+  static constexpr uint32_t receive_window = 64;
+
+  /// Maximum number of ranges in a single ACK.
+  static constexpr size_t max_ack_ranges = 32;
+
+  /// Number of consecutive probe timeouts before the channel gives up.
+  static constexpr size_t max_probe_timeouts = 10;
+
+  /// Number of later packets that need to arrive before declaring a packet
+  /// lost.
+  static constexpr uint32_t reordering_threshold = 3;
+
+  /// Round-trip time estimate until the channel has its first sample.
+  static constexpr duration initial_rtt = std::chrono::milliseconds(100);
+
+  /// Time receivers may wait before sending an ACK.
+  static constexpr duration max_ack_delay = std::chrono::milliseconds(5);
+
+  /// Initial and minimum congestion window in packets.
+  static constexpr size_t initial_window = 10;
+
+  static constexpr size_t min_window = 2;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a channel that identifies itself with `session` to the peer.
+  /// Receivers drop packets from sessions other than the first one they see.
+  explicit reliable_channel(uint32_t session);
+
+  /// Creates a channel that starts numbering packets and frames at `first`
+  /// instead of 0. Both peers must use the same value, since receivers expect
+  /// `first` as sequence number of the first frame on each stream.
+  reliable_channel(uint32_t session, uint64_t first);
+
+  reliable_channel(const reliable_channel&) = delete;
+
+  reliable_channel& operator=(const reliable_channel&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the congestion window in bytes.
+  size_t cwnd() const noexcept {
+    return cwnd_;
+  }
+
+  /// Returns the number of bytes sent but not yet acknowledged.
+  size_t bytes_in_flight() const noexcept {
+    return bytes_in_flight_;
+  }
+
+  /// Returns the number of frame bytes waiting for transmission.
+  size_t queued_bytes() const noexcept {
+    return queued_bytes_;
+  }
+
+  /// Returns the smoothed round-trip time.
+  duration srtt() const noexcept {
+    return srtt_;
+  }
+
+  /// Returns how many packets the channel declared lost so far.
+  uint64_t lost_packets() const noexcept {
+    return lost_packets_;
+  }
+
+  /// Returns whether the peer stopped responding.
+  bool failed() const noexcept {
+    return failed_;
+  }
+
+  /// Returns whether the peer closed the channel.
+  bool closed() const noexcept {
+    return peer_closed_;
+  }
+
+  /// Returns whether `close` was called.
+  bool closing() const noexcept {
+    return closing_;
+  }
+
+  /// Returns whether the channel told the peer that it closed, i.e., whether
+  /// the channel has nothing left to send.
+  bool close_sent() const noexcept {
+    return close_sent_;
+  }
+
+  /// Returns whether all sent frames were acknowledged.
+  bool idle() const noexcept {
+    return sent_.empty() && queue_.empty() && retransmit_.empty();
+  }
+
+  /// Checks whether `data` looks like a packet of this protocol.
+  static bool is_packet(const void* data, size_t size) noexcept;
+
+  /// Checks whether `data` is a packet of the peer, i.e., whether its session
+  /// matches the session of the first packet this channel received.
+  bool accepts(const void* data, size_t size) const noexcept;
+
+  /// Returns the first frame on stream 0 if `data` is a data packet that
+  /// carries this frame in a single chunk, otherwise an empty span. Allows
+  /// users to inspect the first control frame of a new peer before
+  /// allocating a channel for it. Assumes that the peer starts numbering its
+  /// frames at 0.
+  static span<const byte> initial_frame(const void* data, size_t size) noexcept;
+
+  // -- sending ----------------------------------------------------------------
+
+  /// Queues `size` bytes at `data` as a single frame on `stream`. Returns
+  /// `false` if the frame exceeds `max_frame_size`, if `stream` exceeds
+  /// `max_streams` or if the channel is closing.
+  bool send(uint16_t stream, const void* data, size_t size);
+
+  /// Closes the channel. The channel keeps transmitting until the peer
+  /// acknowledged all queued frames and then tells the peer that it closed.
+  void close();
+
+  // -- event handling ---------------------------------------------------------
+
+  /// Processes a datagram from the peer and passes all frames that became
+  /// deliverable to `f`. Returns `false` for malformed datagrams.
+  bool handle_datagram(time_point now, const void* data, size_t size,
+                       const frame_consumer& f);
+
+  /// Handles expired timers and passes all datagrams that may go out at
+  /// `now` to `f`.
+  void transmit(time_point now, const datagram_consumer& f);
+
+  /// Returns when the channel needs another call to `transmit` or
+  /// `time_point::max()` if it waits for the peer.
+  time_point next_timeout() const noexcept;
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  enum packet_type : uint8_t {
+    data_packet,
+    ack_packet,
+    close_packet,
+  };
+
+  struct chunk {
+    uint16_t stream;
+    uint64_t seq;
+    uint16_t frag;
+    uint16_t frags;
+    byte_buffer data;
+  };
+
+  struct sent_packet {
+    chunk content;
+    time_point time;
+    size_t size;
+  };
+
+  struct partial_frame {
+    uint16_t frags = 0;
+    std::map<uint16_t, byte_buffer> chunks;
+  };
+
+  struct inbound_stream {
+    uint64_t next_seq;
+    std::map<uint64_t, partial_frame> pending;
+  };
+
+  // -- sending ----------------------------------------------------------------
+
+  void write_ack(const datagram_consumer& f);
+
+  void write_close(const datagram_consumer& f);
+
+  void write_chunk(time_point now, chunk& x, const datagram_consumer& f);
+
+  bool can_send(time_point now, const chunk& x) const noexcept;
+
+  bool in_window(const chunk& x) const noexcept;
+
+  const chunk* next_chunk() const noexcept;
+
+  duration pacing_interval(size_t packet_size) const noexcept;
+
+  duration probe_timeout() const noexcept;
+
+  // -- receiving --------------------------------------------------------------
+
+  bool handle_data(time_point now, const byte* first, const byte* last,
+                   uint64_t pkt, const frame_consumer& f);
+
+  bool handle_ack(time_point now, const byte* first, const byte* last);
+
+  void drain(uint16_t stream_id, inbound_stream& x, const frame_consumer& f);
+
+  bool record_packet(uint64_t pkt);
+
+  // -- loss detection and congestion control ----------------------------------
+
+  void detect_losses(time_point now);
+
+  void on_loss(const sent_packet& x, time_point now);
+
+  void on_acked(const sent_packet& x);
+
+  void update_rtt(duration sample);
+
+  // -- member variables -------------------------------------------------------
+
+  /// Identifies this side of the channel.
+  uint32_t session_;
+
+  /// Identifies the peer after receiving its first packet.
+  uint32_t peer_session_ = 0;
+
+  bool has_peer_session_ = false;
+
+  /// Stores whether `close` was called and whether the peer saw it.
+  bool closing_ = false;
+
+  bool close_sent_ = false;
+
+  bool peer_closed_ = false;
+
+  bool failed_ = false;
+
+  /// Allows the next packet to bypass congestion control after a timeout.
+  bool probe_ = false;
+
+  /// Stores the first packet number and the first sequence number per stream.
+  uint64_t first_;
+
+  // -- sender state -----------------------------------------------------------
+
+  uint64_t next_pkt_;
+
+  std::unordered_map<uint16_t, uint64_t> next_seq_;
+
+  /// Counts the unacknowledged chunks of each frame per stream.
+  std::unordered_map<uint16_t, std::map<uint64_t, size_t>> unacked_;
+
+  std::deque<chunk> queue_;
+
+  std::deque<chunk> retransmit_;
+
+  size_t queued_bytes_ = 0;
+
+  std::map<uint64_t, sent_packet> sent_;
+
+  size_t bytes_in_flight_ = 0;
+
+  bool has_largest_acked_ = false;
+
+  uint64_t largest_acked_ = 0;
+
+  size_t cwnd_;
+
+  size_t ssthresh_;
+
+  time_point recovery_start_;
+
+  time_point last_send_;
+
+  time_point next_send_time_;
+
+  time_point loss_time_ = time_point::max();
+
+  bool has_rtt_sample_ = false;
+
+  duration srtt_ = initial_rtt;
+
+  duration rttvar_ = initial_rtt / 2;
+
+  size_t probe_timeouts_ = 0;
+
+  uint64_t lost_packets_ = 0;
+
+  // -- receiver state ---------------------------------------------------------
+
+  /// Received packet numbers as disjoint, descending ranges.
+  std::vector<std::pair<uint64_t, uint64_t>> received_;
+
+  size_t unacked_packets_ = 0;
+
+  time_point ack_deadline_ = time_point::max();
+
+  std::unordered_map<uint16_t, inbound_stream> streams_;
+
+  /// Stores whether stream 0 delivered its first frame.
+  bool control_established_ = false;
+};
+
+} // namespace caf::io::network
@@ -20,6 +20,7 @@
 
 #include <vector>
 
+#include "caf/byte.hpp"
 #include "caf/byte_buffer.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/io/fwd.hpp"
@@ -29,6 +30,7 @@
 #include "caf/io/receive_policy.hpp"
 #include "caf/logger.hpp"
 #include "caf/ref_counted.hpp"
+#include "caf/span.hpp"
 
 namespace caf::io::network {
 
@@ -39,6 +41,13 @@ public:
   /// A smart pointer to a stream manager.
   using manager_ptr = intrusive_ptr<stream_manager>;
 
+  /// Buffers with at least this many bytes become a segment of their own when
+  /// passed to `write(byte_buffer&&)` instead of getting copied.
+  static constexpr size_t zero_copy_threshold = 1024;
+
+  /// Maximum number of segments per gather write.
+  static constexpr size_t max_write_segments = 64;
+
   stream(default_multiplexer& backend_ref, native_socket sockfd);
 
   /// Starts reading data from the socket, forwarding incoming data to `mgr`.
@@ -56,6 +65,12 @@ public:
   /// @warning Not thread safe.
   void write(const void* buf, size_t num_bytes);
 
+  /// Enqueues `buf` for writing. Takes ownership of large buffers and sends
+  /// them as separate segment, i.e., without copying their content. The
+  /// memory of `buf` goes to the buffer pool of the multiplexer afterwards.
+  /// @warning Not thread safe.
+  void write(byte_buffer&& buf);
+
   /// Returns the write buffer of this stream.
   /// @warning Must not be modified outside the IO multiplexers event loop
   ///          once the stream has been started.
@@ -84,6 +99,10 @@ public:
   /// write buffer.
   void force_empty_write(const manager_ptr& mgr);
 
+  /// Returns the number of bytes in all send buffers that still wait for
+  /// transmission.
+  size_t pending_bytes() const;
+
 protected:
   template <class Policy>
   void handle_event_impl(io::network::operation op, Policy& policy) {
@@ -98,6 +117,7 @@ protected:
           return read_threshold_ - collected_;
         };
         size_t reads = 0;
+        state_.read_pending = false;
         while (reads < max_consecutive_reads_
                || policy.must_read_more(fd(), threshold())) {
           auto res = policy.read_some(rb, fd(), rd_buf_.data() + collected_,
@@ -106,13 +126,15 @@ protected:
             return;
           ++reads;
         }
+        state_.read_pending = true;
         break;
       }
       case io::network::operation::write: {
         size_t wb; // Written bytes.
-        auto res = policy.write_some(wb, fd(), wr_buf_.data() + written_,
-                                     wr_buf_.size() - written_);
+        auto res = write_some(policy, wb, 0);
         handle_write_result(res, wb);
+        state_.write_pending = res == rw_state::success && wb > 0
+                               && state_.writing;
         break;
       }
       case operation::propagate_error:
@@ -122,8 +144,40 @@ protected:
   }
 
 private:
+  // Sends all pending segments with a single system call if the policy
+  // supports gather writes.
+  template <class Policy>
+  auto write_some(Policy& policy, size_t& wb, int)
+    -> decltype(policy.writev_some(wb, fd(), nullptr, size_t{0})) {
+    if (wr_bufs_.size() - wr_pos_ < 2)
+      return write_some(policy, wb, 0l);
+    span<const byte> bufs[max_write_segments];
+    size_t num_bufs = 0;
+    auto offset = written_;
+    for (auto i = wr_pos_;
+         i < wr_bufs_.size() && num_bufs < max_write_segments; ++i) {
+      auto& buf = wr_bufs_[i];
+      bufs[num_bufs++] = span<const byte>{buf.data() + offset,
+                                          buf.size() - offset};
+      offset = 0;
+    }
+    return policy.writev_some(wb, fd(), bufs, num_bufs);
+  }
+
+  template <class Policy>
+  rw_state write_some(Policy& policy, size_t& wb, long) {
+    // Happens after `force_empty_write`.
+    if (wr_pos_ == wr_bufs_.size())
+      return policy.write_some(wb, fd(), nullptr, 0);
+    auto& buf = wr_bufs_[wr_pos_];
+    return policy.write_some(wb, fd(), buf.data() + written_,
+                             buf.size() - written_);
+  }
+
   void prepare_next_read();
 
+  void resize_rd_buf(size_t new_size);
+
   void prepare_next_write();
 
   bool handle_read_result(rw_state read_result, size_t rb);
@@ -145,10 +199,14 @@ private:
   size_t max_;
   byte_buffer rd_buf_;
 
-  // State for writing.
+  // State for writing. The stream sends the segments in `wr_bufs_`, starting
+  // at offset `written_` of segment `wr_pos_`, while collecting new data in
+  // `wr_offline_bufs_` and `wr_offline_buf_`.
   manager_ptr writer_;
   size_t written_;
-  byte_buffer wr_buf_;
+  size_t wr_pos_;
+  std::vector<byte_buffer> wr_bufs_;
+  std::vector<byte_buffer> wr_offline_bufs_;
   byte_buffer wr_offline_buf_;
 };
 
@@ -281,6 +281,11 @@ public:
     inline_runnable_callback_ = std::move(f);
   }
 
+  /// Sets the maximum number of messages a runnable may handle per run.
+  inline void max_throughput(size_t num) {
+    max_throughput_ = num;
+  }
+
 protected:
   void exec_later(resumable* ptr) override;
 
@@ -369,6 +374,9 @@ private:
   // Configures a one-shot handler for the next inlined runnable.
   std::function<void()> inline_runnable_callback_;
 
+  // Configures how many messages a runnable may handle per run.
+  size_t max_throughput_;
+
   int64_t servant_ids_;
 };
 
@@ -51,6 +51,14 @@ public:
   /// Returns the current output buffer.
   virtual byte_buffer& wr_buf() = 0;
 
+  /// Enqueues `buf` for writing. The default implementation appends `buf` to
+  /// `wr_buf()`, while implementations may also send `buf` without copying.
+  virtual void write(byte_buffer&& buf);
+
+  /// Returns the number of bytes that wait for transmission. The default
+  /// implementation returns the size of `wr_buf()`.
+  virtual size_t pending_bytes();
+
   /// Returns the current input buffer.
   virtual byte_buffer& rd_buf() = 0;
 
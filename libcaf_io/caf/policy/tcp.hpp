@@ -18,9 +18,11 @@
 
 #pragma once
 
+#include "caf/byte.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/io/network/native_socket.hpp"
 #include "caf/io/network/rw_state.hpp"
+#include "caf/span.hpp"
 
 namespace caf::policy {
 
@@ -42,6 +44,14 @@ struct CAF_IO_EXPORT tcp {
   write_some(size_t& result, io::network::native_socket fd, const void* buf,
              size_t len);
 
+  /// Writes the content of up to `num_bufs` buffers from `bufs` to `fd` using
+  /// a single system call (gather write). Returns the same result as
+  /// `write_some`. The number of written bytes is stored in `result` (can
+  /// be 0).
+  static io::network::rw_state
+  writev_some(size_t& result, io::network::native_socket fd,
+              const span<const byte>* bufs, size_t num_bufs);
+
   /// Tries to accept a new connection from `fd`. On success,
   /// the new connection is stored in `result`. Returns true
   /// as long as
@@ -97,6 +97,11 @@ byte_buffer& abstract_broker::wr_buf(connection_handle hdl) {
   return x->wr_buf();
 }
 
+size_t abstract_broker::pending_bytes(connection_handle hdl) {
+  auto x = by_id(hdl);
+  return x ? x->pending_bytes() : 0;
+}
+
 void abstract_broker::write(connection_handle hdl, size_t bs, const void* buf) {
   auto& out = wr_buf(hdl);
   auto first = reinterpret_cast<const byte*>(buf);
@@ -104,12 +109,30 @@ void abstract_broker::write(connection_handle hdl, size_t bs, const void* buf) {
   out.insert(out.end(), first, last);
 }
 
+void abstract_broker::write(connection_handle hdl, byte_buffer&& buf) {
+  auto x = by_id(hdl);
+  if (!x) {
+    CAF_LOG_ERROR("tried to write to an unknown connection_handle:"
+                  << CAF_ARG(hdl));
+    return;
+  }
+  x->write(std::move(buf));
+}
+
 void abstract_broker::flush(connection_handle hdl) {
   auto x = by_id(hdl);
   if (x)
     x->flush();
 }
 
+byte_buffer abstract_broker::acquire_buffer() {
+  return backend().buffer_pool().get();
+}
+
+void abstract_broker::release_buffer(byte_buffer&& buf) {
+  backend().buffer_pool().put(std::move(buf));
+}
+
 void abstract_broker::ack_writes(datagram_handle hdl, bool enable) {
   CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(enable));
   auto x = by_id(hdl);
@@ -374,11 +397,14 @@ void abstract_broker::init_broker() {
 }
 
 abstract_broker::abstract_broker(actor_config& cfg) : scheduled_actor(cfg) {
-  // nop
+  // Brokers stay on the multiplexer they were spawned on for their lifetime.
+  backend_ = system().middleman().backend_of(cfg.host);
+  if (backend_ == nullptr)
+    backend_ = &system().middleman().backend();
 }
 
 network::multiplexer& abstract_broker::backend() {
-  return system().middleman().backend();
+  return *backend_;
 }
 
 void abstract_broker::launch_servant(doorman_ptr& ptr) {
@@ -0,0 +1,213 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/compression.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace caf::io::basp {
+
+namespace {
+
+// The LZ4 block format encodes sequences of literals followed by a match. A
+// token byte stores the number of literals in its upper four bits and the
+// match length minus `min_match` in its lower four bits. Larger values spill
+// into additional bytes. Each match is a 16-bit little-endian offset into the
+// already decoded output.
+
+constexpr size_t prefix_size = sizeof(uint32_t);
+
+constexpr size_t min_match = 4;
+
+constexpr size_t max_offset = 65535;
+
+// The last five bytes of the input are always literals.
+constexpr size_t last_literals = 5;
+
+// The last match must start at least 12 bytes before the end of the input.
+constexpr size_t match_find_limit = 12;
+
+constexpr uint32_t hash_log = 12;
+
+uint32_t read32(const uint8_t* ptr) {
+  uint32_t result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+uint32_t hash(uint32_t x) {
+  return (x * 2654435761u) >> (32 - hash_log);
+}
+
+void write_length(byte_buffer& out, size_t len) {
+  len -= 15;
+  while (len >= 255) {
+    out.emplace_back(byte{255});
+    len -= 255;
+  }
+  out.emplace_back(static_cast<byte>(len));
+}
+
+// Writes a sequence of literals, followed by a match unless `match_len == 0`.
+void write_sequence(byte_buffer& out, const uint8_t* literals, size_t num_literals,
+                    size_t offset, size_t match_len) {
+  auto token_pos = out.size();
+  out.emplace_back(byte{0});
+  uint8_t token = num_literals >= 15 ? 0xf0
+                                     : static_cast<uint8_t>(num_literals << 4);
+  if (num_literals >= 15)
+    write_length(out, num_literals);
+  auto first = reinterpret_cast<const byte*>(literals);
+  out.insert(out.end(), first, first + num_literals);
+  if (match_len > 0) {
+    out.emplace_back(static_cast<byte>(offset & 0xff));
+    out.emplace_back(static_cast<byte>(offset >> 8));
+    auto len = match_len - min_match;
+    token |= len >= 15 ? 0x0f : static_cast<uint8_t>(len);
+    if (len >= 15)
+      write_length(out, len);
+  }
+  out[token_pos] = static_cast<byte>(token);
+}
+
+void compress_block(byte_buffer& out, const uint8_t* first, size_t size) {
+  size_t anchor = 0;
+  if (size > match_find_limit) {
+    uint32_t table[size_t{1} << hash_log] = {};
+    auto match_limit = size - match_find_limit;
+    auto end_of_matches = size - last_literals;
+    size_t pos = 1;
+    while (pos <= match_limit) {
+      auto seq = read32(first + pos);
+      auto& entry = table[hash(seq)];
+      size_t candidate = entry;
+      entry = static_cast<uint32_t>(pos);
+      if (pos - candidate <= max_offset && read32(first + candidate) == seq) {
+        auto len = min_match;
+        while (pos + len < end_of_matches
+               && first[candidate + len] == first[pos + len])
+          ++len;
+        write_sequence(out, first + anchor, pos - anchor, pos - candidate, len);
+        pos += len;
+        anchor = pos;
+      } else {
+        // Skip faster through data that does not compress well.
+        pos += 1 + ((pos - anchor) >> 6);
+      }
+    }
+  }
+  write_sequence(out, first + anchor, size - anchor, 0, 0);
+}
+
+bool read_length(const uint8_t* first, size_t size, size_t& pos, size_t& len) {
+  uint8_t x;
+  do {
+    if (pos == size)
+      return false;
+    x = first[pos++];
+    len += x;
+  } while (x == 255);
+  return true;
+}
+
+bool decompress_block(byte* out, const uint8_t* first, size_t size,
+                      size_t original_size) {
+  size_t pos = 0;
+  size_t written = 0;
+  while (pos < size) {
+    auto token = first[pos++];
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !read_length(first, size, pos, num_literals))
+      return false;
+    if (num_literals > size - pos || num_literals > original_size - written)
+      return false;
+    auto literals = reinterpret_cast<const byte*>(first + pos);
+    memcpy(out + written, literals, num_literals);
+    pos += num_literals;
+    written += num_literals;
+    // The last sequence consists of literals only.
+    if (pos == size)
+      break;
+    if (size - pos < 2)
+      return false;
+    size_t offset = first[pos] | (size_t{first[pos + 1]} << 8);
+    pos += 2;
+    if (offset == 0 || offset > written)
+      return false;
+    size_t match_len = token & 0x0f;
+    if (match_len == 15 && !read_length(first, size, pos, match_len))
+      return false;
+    match_len += min_match;
+    if (match_len > original_size - written)
+      return false;
+    // Matches may overlap with their own output, e.g., for repeated bytes.
+    auto dst = out + written;
+    auto src = dst - offset;
+    if (offset >= match_len)
+      memcpy(dst, src, match_len);
+    else
+      for (size_t i = 0; i < match_len; ++i)
+        dst[i] = src[i];
+    written += match_len;
+  }
+  return written == original_size;
+}
+
+} // namespace
+
+bool compress(byte_buffer& out, span<const byte> payload) {
+  if (payload.size() > std::numeric_limits<uint32_t>::max())
+    return false;
+  auto original_out_size = out.size();
+  auto size = static_cast<uint32_t>(payload.size());
+  for (int shift = 24; shift >= 0; shift -= 8)
+    out.emplace_back(static_cast<byte>((size >> shift) & 0xff));
+  compress_block(out, reinterpret_cast<const uint8_t*>(payload.data()),
+                 payload.size());
+  if (out.size() - original_out_size >= payload.size()) {
+    out.resize(original_out_size);
+    return false;
+  }
+  return true;
+}
+
+bool decompress(byte_buffer& out, span<const byte> input) {
+  if (input.size() < prefix_size)
+    return false;
+  size_t original_size = 0;
+  for (size_t i = 0; i < prefix_size; ++i)
+    original_size = (original_size << 8) | static_cast<uint8_t>(input[i]);
+  // Each byte of a block expands to at most 255 bytes of output. Checking this
+  // bound first protects us from allocating memory for bogus sizes.
+  auto block_size = input.size() - prefix_size;
+  if (original_size > block_size * 255)
+    return false;
+  auto original_out_size = out.size();
+  out.resize(original_out_size + original_size);
+  auto first = reinterpret_cast<const uint8_t*>(input.data()) + prefix_size;
+  if (!decompress_block(out.data() + original_out_size, first, block_size,
+                        original_size)) {
+    out.resize(original_out_size);
+    return false;
+  }
+  return true;
+}
+
+} // namespace caf::io::basp
@@ -0,0 +1,184 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/datagram_scribe.hpp"
+
+#include "caf/actor_clock.hpp"
+#include "caf/binary_deserializer.hpp"
+#include "caf/io/abstract_broker.hpp"
+#include "caf/io/basp/message_type.hpp"
+#include "caf/logger.hpp"
+#include "caf/mailbox_element.hpp"
+
+namespace caf::io::basp {
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+datagram_scribe::datagram_scribe(abstract_broker* parent,
+                                 datagram_handle dgram_hdl, uint32_t session,
+                                 double loss_rate)
+  : scribe(conn_hdl_from(dgram_hdl)),
+    dgram_hdl_(dgram_hdl),
+    channel_(session),
+    addr_(parent->remote_addr(dgram_hdl)),
+    port_(parent->remote_port(dgram_hdl)),
+    timer_(network::reliable_channel::time_point::max()),
+    rng_(session),
+    drop_(loss_rate) {
+  // nop
+}
+
+datagram_scribe::~datagram_scribe() {
+  // nop
+}
+
+// -- event handling -----------------------------------------------------------
+
+void datagram_scribe::transmit() {
+  auto self = parent();
+  // The datagram servant might be gone already if the parent closed it.
+  if (self == nullptr || !self->valid(dgram_hdl_)) {
+    if (self != nullptr && channel_.closing())
+      detach(self->context(), false);
+    return;
+  }
+  auto& clock = self->clock();
+  auto sent = false;
+  channel_.transmit(clock.now(), [&](byte_buffer& buf) {
+    if (drop_.p() > 0 && drop_(rng_)) {
+      CAF_LOG_DEBUG("drop outgoing datagram:" << CAF_ARG2("size", buf.size()));
+      return;
+    }
+    self->enqueue_datagram(dgram_hdl_, std::move(buf));
+    sent = true;
+  });
+  if (sent)
+    self->flush(dgram_hdl_);
+  if (channel_.closing() && (channel_.close_sent() || channel_.failed())) {
+    detach(self->context(), false);
+    return;
+  }
+  auto t = channel_.next_timeout();
+  if (t < timer_) {
+    timer_ = t;
+    clock.schedule_message(t, strong_actor_ptr{self->ctrl()},
+                           make_mailbox_element(nullptr, make_message_id(), {},
+                                                tick_atom_v, hdl()));
+  }
+}
+
+void datagram_scribe::handle_timeout() {
+  if (auto self = parent(); self != nullptr && self->clock().now() >= timer_)
+    timer_ = network::reliable_channel::time_point::max();
+  transmit();
+}
+
+// -- implementation of scribe -------------------------------------------------
+
+void datagram_scribe::configure_read(receive_policy::config) {
+  // nop, the channel always delivers entire BASP messages
+}
+
+void datagram_scribe::ack_writes(bool) {
+  // nop, the parent checks pending bytes after each received datagram
+}
+
+byte_buffer& datagram_scribe::wr_buf() {
+  return wr_buf_;
+}
+
+size_t datagram_scribe::pending_bytes() {
+  return wr_buf_.size() + channel_.queued_bytes() + channel_.bytes_in_flight();
+}
+
+byte_buffer& datagram_scribe::rd_buf() {
+  return rd_buf_;
+}
+
+void datagram_scribe::graceful_shutdown() {
+  CAF_LOG_TRACE("");
+  if (detached())
+    return;
+  // A second shutdown request, e.g., from abstract_broker::close_all when the
+  // parent terminates, gives up on the pending frames and detaches at once.
+  if (channel_.closing()) {
+    if (auto self = parent())
+      detach(self->context(), false);
+    return;
+  }
+  // The scribe stays attached until the peer acknowledged all queued frames.
+  channel_.close();
+  transmit();
+}
+
+void datagram_scribe::flush() {
+  CAF_LOG_TRACE(CAF_ARG2("wr_buf.size", wr_buf_.size()));
+  // Split the output buffer into BASP messages.
+  size_t pos = 0;
+  while (wr_buf_.size() - pos >= header_size) {
+    header hdr;
+    binary_deserializer source{nullptr, wr_buf_.data() + pos, header_size};
+    if (auto err = source(hdr)) {
+      CAF_LOG_ERROR("unable to read BASP header:" << CAF_ARG(err));
+      break;
+    }
+    auto size = header_size + hdr.payload_len;
+    if (wr_buf_.size() - pos < size)
+      break;
+    if (!channel_.send(stream_for(hdr), wr_buf_.data() + pos, size))
+      CAF_LOG_ERROR("BASP message exceeds maximum frame size:"
+                    << CAF_ARG(size));
+    pos += size;
+  }
+  wr_buf_.erase(wr_buf_.begin(), wr_buf_.begin() + pos);
+  transmit();
+}
+
+std::string datagram_scribe::addr() const {
+  return addr_;
+}
+
+uint16_t datagram_scribe::port() const {
+  return port_;
+}
+
+void datagram_scribe::add_to_loop() {
+  // nop, the datagram servant of the parent receives all datagrams
+}
+
+void datagram_scribe::remove_from_loop() {
+  // nop
+}
+
+// -- utility functions --------------------------------------------------------
+
+uint16_t datagram_scribe::stream_for(const header& hdr) noexcept {
+  switch (hdr.operation) {
+    case message_type::direct_message:
+    case message_type::routed_message:
+    case message_type::down_message:
+      // A down message must not overtake prior messages of its source actor.
+      if (hdr.source_actor != invalid_actor_id)
+        return static_cast<uint16_t>(1 + hdr.source_actor % (num_streams - 1));
+      return 0;
+    default:
+      return 0;
+  }
+}
+
+} // namespace caf::io::basp
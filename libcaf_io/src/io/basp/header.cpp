@@ -20,10 +20,16 @@
 
 #include <sstream>
 
+#include "caf/message_id.hpp"
+
 namespace caf::io::basp {
 
 const uint8_t header::named_receiver_flag;
 
+const uint8_t header::compressed_flag;
+
+const uint8_t header::interned_flag;
+
 std::string to_bin(uint8_t x) {
   std::string res;
   for (auto offset = 7; offset > -1; --offset)
@@ -84,6 +90,17 @@ bool heartbeat_valid(const header& hdr) {
          && zero(hdr.operation_data);
 }
 
+bool batched_message_valid(const header& hdr) {
+  return zero(hdr.source_actor) && zero(hdr.dest_actor)
+         && !zero(hdr.payload_len) && !zero(hdr.operation_data)
+         && hdr.operation_data <= hdr.payload_len;
+}
+
+bool intern_node_valid(const header& hdr) {
+  return zero(hdr.source_actor) && zero(hdr.dest_actor)
+         && !zero(hdr.payload_len);
+}
+
 } // namespace
 
 bool valid(const header& hdr) {
@@ -104,7 +121,80 @@ bool valid(const header& hdr) {
       return down_message_valid(hdr);
     case message_type::heartbeat:
       return heartbeat_valid(hdr);
+    case message_type::batched_message:
+      return batched_message_valid(hdr);
+    case message_type::intern_node:
+      return intern_node_valid(hdr);
+  }
+}
+
+void write_varbyte(byte_buffer& buf, uint64_t x) {
+  while (x > 0x7f) {
+    buf.emplace_back(static_cast<byte>((static_cast<uint8_t>(x) & 0x7f) | 0x80));
+    x >>= 7;
+  }
+  buf.emplace_back(static_cast<byte>(x));
+}
+
+bool read_varbyte(span<const byte>& bytes, uint64_t& x) {
+  x = 0;
+  size_t pos = 0;
+  for (uint32_t shift = 0; shift < 64; shift += 7) {
+    if (pos == bytes.size())
+      return false;
+    auto low7 = static_cast<uint8_t>(bytes[pos++]);
+    x |= static_cast<uint64_t>(low7 & 0x7f) << shift;
+    if ((low7 & 0x80) == 0) {
+      bytes = bytes.subspan(pos, bytes.size() - pos);
+      return true;
+    }
+  }
+  return false;
+}
+
+void write_sub_header(byte_buffer& buf, const header& hdr) {
+  CAF_ASSERT(hdr.flags < 0x10);
+  auto mid_bits = static_cast<uint8_t>(hdr.operation_data >> 56) & 0xf0;
+  buf.emplace_back(static_cast<byte>(mid_bits | hdr.flags));
+  write_varbyte(buf, hdr.operation_data & message_id::request_id_mask);
+  write_varbyte(buf, hdr.source_actor);
+  write_varbyte(buf, hdr.dest_actor);
+  write_varbyte(buf, hdr.payload_len);
+}
+
+bool read_sub_header(span<const byte>& bytes, header& hdr) {
+  if (bytes.empty())
+    return false;
+  auto first = static_cast<uint8_t>(bytes[0]);
+  auto remainder = bytes.subspan(1, bytes.size() - 1);
+  uint64_t request_id = 0;
+  uint64_t payload_len = 0;
+  if (!read_varbyte(remainder, request_id)
+      || !read_varbyte(remainder, hdr.source_actor)
+      || !read_varbyte(remainder, hdr.dest_actor)
+      || !read_varbyte(remainder, payload_len))
+    return false;
+  if (request_id > message_id::request_id_mask
+      || payload_len > remainder.size())
+    return false;
+  hdr.operation = message_type::direct_message;
+  hdr.flags = first & 0x0f;
+  hdr.payload_len = static_cast<uint32_t>(payload_len);
+  hdr.operation_data = (static_cast<uint64_t>(first & 0xf0) << 56) | request_id;
+  if (!direct_message_valid(hdr))
+    return false;
+  bytes = remainder;
+  return true;
+}
+
+bool valid_batch(span<const byte> bytes, uint64_t n) {
+  header hdr;
+  for (uint64_t i = 0; i < n; ++i) {
+    if (!read_sub_header(bytes, hdr))
+      return false;
+    bytes = bytes.subspan(hdr.payload_len, bytes.size() - hdr.payload_len);
   }
+  return bytes.empty();
 }
 
 } // namespace caf::io::basp
@@ -18,10 +18,13 @@
 
 #include "caf/io/basp/instance.hpp"
 
+#include <algorithm>
+
 #include "caf/actor_system_config.hpp"
 #include "caf/binary_deserializer.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/defaults.hpp"
+#include "caf/io/basp/compression.hpp"
 #include "caf/io/basp/remote_message_handler.hpp"
 #include "caf/io/basp/version.hpp"
 #include "caf/io/basp/worker.hpp"
@@ -41,10 +44,26 @@ instance::callee::~callee() {
 instance::instance(abstract_broker* parent, callee& lstnr)
   : tbl_(parent), this_node_(parent->system().node()), callee_(lstnr) {
   CAF_ASSERT(this_node_ != none);
-  auto workers
+  min_workers_
     = get_or(config(), "middleman.workers", defaults::middleman::workers);
-  for (size_t i = 0; i < workers; ++i)
+  // Setting workers to 0 forces the broker to deserialize all messages.
+  max_workers_ = min_workers_ == 0
+                   ? 0
+                   : std::max(min_workers_,
+                              get_or(config(), "middleman.max-workers",
+                                     defaults::middleman::max_workers));
+  worker_idle_timeout_
+    = get_or(config(), "middleman.worker-idle-timeout",
+             defaults::middleman::worker_idle_timeout);
+  for (size_t i = 0; i < min_workers_; ++i)
     hub_.add_new_worker(queue_, proxies());
+  compression_threshold_ = get_or(config(), "middleman.compression-threshold",
+                                  defaults::middleman::compression_threshold);
+  high_watermark_ = get_or(config(), "middleman.high-watermark",
+                           defaults::middleman::high_watermark);
+  low_watermark_ = std::min(high_watermark_,
+                            get_or(config(), "middleman.low-watermark",
+                                   defaults::middleman::low_watermark));
 }
 
 connection_state instance::handle(execution_unit* ctx, new_data_msg& dm,
@@ -54,6 +73,7 @@ connection_state instance::handle(execution_unit* ctx, new_data_msg& dm,
   auto err = [&](connection_state code) {
     if (auto nid = tbl_.erase_direct(dm.handle))
       callee_.purge_state(nid);
+    erase_connection(dm.handle);
     return code;
   };
   byte_buffer* payload = nullptr;
@@ -156,6 +176,237 @@ size_t instance::remove_published_actor(const actor_addr& whom, uint16_t port,
   return result;
 }
 
+void instance::begin_batching() {
+  batching_ = true;
+}
+
+void instance::flush_batches(execution_unit* ctx) {
+  CAF_LOG_TRACE("");
+  batching_ = false;
+  for (auto& kvp : batches_)
+    flush_batch(ctx, kvp.first);
+}
+
+void instance::flush_batch(execution_unit* ctx, connection_handle hdl) {
+  auto i = batches_.find(hdl);
+  if (i == batches_.end() || i->second.size == 0)
+    return;
+  auto& pending = i->second;
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG2("size", pending.size));
+  auto num_messages = pending.size;
+  // Reset the size first, because `get_buffer` calls this function again.
+  pending.size = 0;
+  auto& out = callee_.get_buffer(hdl);
+  if (num_messages == 1) {
+    // A batch of one saves nothing. Send an ordinary direct_message instead.
+    header hdr;
+    span<const byte> bytes{pending.buf.data(), pending.buf.size()};
+    if (read_sub_header(bytes, hdr)) {
+      write(ctx, out, hdr);
+      out.insert(out.end(), bytes.begin(), bytes.end());
+    } else {
+      CAF_LOG_ERROR("unable to read pending sub-header");
+    }
+  } else {
+    header hdr{message_type::batched_message,
+               0,
+               static_cast<uint32_t>(pending.buf.size()),
+               num_messages,
+               invalid_actor_id,
+               invalid_actor_id};
+    write(ctx, out, hdr);
+    out.insert(out.end(), pending.buf.begin(), pending.buf.end());
+  }
+  pending.buf.clear();
+  callee_.flush(hdl);
+}
+
+void instance::erase_connection(connection_handle hdl) {
+  batch_peers_.erase(hdl);
+  batches_.erase(hdl);
+  compression_peers_.erase(hdl);
+  interning_peers_.erase(hdl);
+  interned_out_.erase(hdl);
+  interned_in_.erase(hdl);
+  congested_.erase(hdl);
+  unordered_peers_.erase(hdl);
+}
+
+void instance::mark_unordered(connection_handle hdl) {
+  unordered_peers_.emplace(hdl);
+}
+
+bool instance::congested(connection_handle hdl) {
+  if (high_watermark_ == 0)
+    return false;
+  auto pending = callee_.pending_bytes(hdl);
+  if (congested_.count(hdl) > 0) {
+    handle_data_transferred(hdl, pending);
+    return congested_.count(hdl) > 0;
+  }
+  if (pending < high_watermark_)
+    return false;
+  CAF_LOG_WARNING("connection reached its high watermark:"
+                  << CAF_ARG(hdl) << CAF_ARG(pending));
+  congested_.emplace(hdl);
+  callee_.congestion_changed(hdl, true);
+  return true;
+}
+
+void instance::handle_data_transferred(connection_handle hdl,
+                                       uint64_t remaining) {
+  if (remaining > low_watermark_)
+    return;
+  if (congested_.erase(hdl) > 0) {
+    CAF_LOG_INFO("connection fell to its low watermark:"
+                 << CAF_ARG(hdl) << CAF_ARG(remaining));
+    callee_.congestion_changed(hdl, false);
+  }
+}
+
+void instance::shrink_workers(actor_clock::time_point now) {
+  // Only shrink after all workers stayed idle for a while. Otherwise, bursty
+  // load would make us destroy and add workers over and over again.
+  if (hub_.shrink(min_workers_, now, worker_idle_timeout_))
+    CAF_LOG_DEBUG("removed BASP worker:" << CAF_ARG2("size", hub_.size()));
+}
+
+void instance::write_direct_message(execution_unit* ctx,
+                                    connection_handle hdl, header& hdr,
+                                    payload_writer& writer) {
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(hdr));
+  scratch_.clear();
+  binary_serializer sink{ctx, scratch_};
+  if (auto err = writer(sink))
+    CAF_LOG_ERROR(CAF_ARG(err));
+  auto payload = &scratch_;
+  if (scratch_.size() >= compression_threshold_
+      && compression_peers_.count(hdl) > 0) {
+    compressed_.clear();
+    if (compress(compressed_, scratch_)) {
+      hdr.flags |= header::compressed_flag;
+      payload = &compressed_;
+    }
+  }
+  hdr.payload_len = static_cast<uint32_t>(payload->size());
+  if (!batching_ || hdr.flags >= 0x10 || payload->size() > max_batched_payload
+      || batch_peers_.count(hdl) == 0) {
+    // Calling get_buffer also writes all pending messages for `hdl` first.
+    auto& out = callee_.get_buffer(hdl);
+    write(ctx, out, hdr);
+    out.insert(out.end(), payload->begin(), payload->end());
+    callee_.flush(hdl);
+    return;
+  }
+  auto& pending = batches_[hdl];
+  write_sub_header(pending.buf, hdr);
+  pending.buf.insert(pending.buf.end(), payload->begin(), payload->end());
+  ++pending.size;
+  if (pending.buf.size() >= max_batch_size)
+    flush_batch(ctx, hdl);
+}
+
+uint8_t instance::handshake_flags() const {
+  return compression_threshold_ > 0 ? header::compressed_flag : uint8_t{0};
+}
+
+void instance::add_peer(connection_handle hdl, const header& handshake) {
+  auto ordered = unordered_peers_.count(hdl) == 0;
+  if (ordered && handshake.operation_data >= batching_version)
+    batch_peers_.emplace(hdl);
+  if (compression_threshold_ > 0 && handshake.has(header::compressed_flag))
+    compression_peers_.emplace(hdl);
+  if (ordered && handshake.operation_data >= interning_version)
+    interning_peers_.emplace(hdl);
+}
+
+bool instance::intern(execution_unit* ctx, connection_handle hdl,
+                      const node_id& nid, uint64_t& result) {
+  auto& nodes = interned_out_[hdl];
+  if (auto i = nodes.find(nid); i != nodes.end()) {
+    result = i->second;
+    return true;
+  }
+  if (nodes.size() >= max_interned_nodes)
+    return false;
+  result = nodes.size();
+  nodes.emplace(nid, result);
+  CAF_LOG_DEBUG("intern node:" << CAF_ARG(hdl) << CAF_ARG(nid)
+                               << CAF_ARG(result));
+  auto writer = make_callback([&](binary_serializer& sink) { //
+    return sink(nid);
+  });
+  header hdr{message_type::intern_node,
+             0,
+             0,
+             result,
+             invalid_actor_id,
+             invalid_actor_id};
+  write(ctx, callee_.get_buffer(hdl), hdr, &writer);
+  return true;
+}
+
+void instance::write_routed_message(execution_unit* ctx, connection_handle hdl,
+                                    header& hdr, const node_id& source_node,
+                                    const node_id& dest_node,
+                                    payload_writer& writer) {
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(hdr));
+  uint64_t source_handle = 0;
+  uint64_t dest_handle = 0;
+  auto interned = interning_peers_.count(hdl) > 0
+                  && intern(ctx, hdl, source_node, source_handle)
+                  && intern(ctx, hdl, dest_node, dest_handle);
+  auto& out = callee_.get_buffer(hdl);
+  // Write the BASP header after the payload.
+  auto header_offset = out.size();
+  out.resize(header_offset + header_size);
+  if (interned) {
+    hdr.flags |= header::interned_flag;
+    write_varbyte(out, source_handle);
+    write_varbyte(out, dest_handle);
+  } else {
+    hdr.flags &= ~header::interned_flag;
+  }
+  binary_serializer sink{ctx, out};
+  if (!interned)
+    if (auto err = sink(source_node, dest_node))
+      CAF_LOG_ERROR(CAF_ARG(err));
+  if (auto err = writer(sink))
+    CAF_LOG_ERROR(CAF_ARG(err));
+  hdr.payload_len = static_cast<uint32_t>(out.size()
+                                          - (header_offset + header_size));
+  sink.seek(header_offset);
+  if (auto err = sink(hdr))
+    CAF_LOG_ERROR(CAF_ARG(err));
+  callee_.flush(hdl);
+}
+
+bool instance::read_route(execution_unit* ctx, connection_handle hdl,
+                          const header& hdr, const byte_buffer& payload,
+                          node_id& source_node, node_id& dest_node,
+                          span<const byte>& remainder) {
+  if (hdr.has(header::interned_flag)) {
+    span<const byte> bytes{payload.data(), payload.size()};
+    uint64_t source_handle = 0;
+    uint64_t dest_handle = 0;
+    if (!read_varbyte(bytes, source_handle) || !read_varbyte(bytes, dest_handle))
+      return false;
+    auto i = interned_in_.find(hdl);
+    if (i == interned_in_.end() || source_handle >= i->second.size()
+        || dest_handle >= i->second.size())
+      return false;
+    source_node = i->second[source_handle];
+    dest_node = i->second[dest_handle];
+    remainder = bytes;
+    return true;
+  }
+  binary_deserializer bd{ctx, payload};
+  if (auto err = bd(source_node, dest_node))
+    return false;
+  remainder = span<const byte>{bd.current(), bd.remaining()};
+  return true;
+}
+
 bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
                         const std::vector<strong_actor_ptr>& forwarding_stack,
                         const node_id& dest_node, uint64_t dest_actor,
@@ -166,6 +417,18 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
   auto path = lookup(dest_node);
   if (!path)
     return false;
+  // Bound the memory for slow peers by shedding regular messages. Responses
+  // and high-priority messages always pass.
+  if (!mid.is_urgent_message() && !mid.is_response() && congested(path->hdl)) {
+    CAF_LOG_DEBUG("drop message to congested peer:" << CAF_ARG(dest_node));
+    // The sync_request_bouncer always reports request_receiver_down. Hence,
+    // we answer the request ourselves to tell the sender to back off.
+    if (sender && mid.is_request())
+      sender->enqueue(nullptr, mid.response_id(),
+                      make_message(make_error(sec::unavailable_or_would_block)),
+                      ctx);
+    return true;
+  }
   auto& source_node = sender ? sender->node() : this_node_;
   if (dest_node == path->next_hop && source_node == this_node_) {
     header hdr{message_type::direct_message,
@@ -177,6 +440,11 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
     auto writer = make_callback([&](binary_serializer& sink) { //
       return sink(forwarding_stack, msg);
     });
+    if ((batching_ && batch_peers_.count(path->hdl) > 0)
+        || compression_peers_.count(path->hdl) > 0) {
+      write_direct_message(ctx, path->hdl, hdr, writer);
+      return true;
+    }
     write(ctx, callee_.get_buffer(path->hdl), hdr, &writer);
   } else {
     header hdr{message_type::routed_message,
@@ -186,9 +454,10 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
                sender ? sender->id() : invalid_actor_id,
                dest_actor};
     auto writer = make_callback([&](binary_serializer& sink) {
-      return sink(source_node, dest_node, forwarding_stack, msg);
+      return sink(forwarding_stack, msg);
     });
-    write(ctx, callee_.get_buffer(path->hdl), hdr, &writer);
+    write_routed_message(ctx, path->hdl, hdr, source_node, dest_node, writer);
+    return true;
   }
   flush(*path);
   return true;
@@ -235,7 +504,7 @@ void instance::write_server_handshake(execution_unit* ctx, byte_buffer& out_buf,
     return sink(this_node_, app_ids, aid, iface);
   });
   header hdr{message_type::server_handshake,
-             0,
+             handshake_flags(),
              0,
              version,
              invalid_actor_id,
@@ -248,9 +517,9 @@ void instance::write_client_handshake(execution_unit* ctx, byte_buffer& buf) {
     return sink(this_node_);
   });
   header hdr{message_type::client_handshake,
+             handshake_flags(),
              0,
-             0,
-             0,
+             version,
              invalid_actor_id,
              invalid_actor_id};
   write(ctx, buf, hdr, &writer);
@@ -337,6 +606,7 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       // Add direct route to this node and remove any indirect entry.
       CAF_LOG_DEBUG("new direct connection:" << CAF_ARG(source_node));
       tbl_.add_direct(hdl, source_node);
+      add_peer(hdl, hdr);
       auto was_indirect = tbl_.erase_indirect(source_node);
       // write handshake as client in response
       auto path = tbl_.lookup(source_node);
@@ -366,23 +636,24 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       // Add direct route to this node and remove any indirect entry.
       CAF_LOG_DEBUG("new direct connection:" << CAF_ARG(source_node));
       tbl_.add_direct(hdl, source_node);
+      add_peer(hdl, hdr);
       auto was_indirect = tbl_.erase_indirect(source_node);
       callee_.learned_new_node_directly(source_node, was_indirect);
       break;
     }
     case message_type::routed_message: {
       // Deserialize payload.
-      binary_deserializer bd{ctx, *payload};
       node_id source_node;
       node_id dest_node;
-      if (auto err = bd(source_node, dest_node)) {
+      span<const byte> remainder;
+      if (!read_route(ctx, hdl, hdr, *payload, source_node, dest_node,
+                      remainder)) {
         CAF_LOG_WARNING(
-          "unable to deserialize source and destination for routed message:"
-          << ctx->system().render(err));
+          "unable to read source and destination for routed message");
         return serializing_basp_payload_failed;
       }
       if (dest_node != this_node_) {
-        forward(ctx, dest_node, hdr, *payload);
+        forward(ctx, source_node, dest_node, hdr, remainder);
         return await_header;
       }
       auto last_hop = tbl_.lookup_direct(hdl);
@@ -390,45 +661,64 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
           && last_hop != source_node
           && tbl_.add_indirect(last_hop, source_node))
         callee_.learned_new_node_indirectly(source_node);
+      // Workers have no access to our tables. Hence, we pass the resolved
+      // source node along with the remainder of the payload.
+      handle_message(last_hop, source_node, hdr, remainder);
+      break;
     }
-    // fall through
     case message_type::direct_message: {
-      auto worker = hub_.pop();
       auto last_hop = tbl_.lookup_direct(hdl);
-      if (worker != nullptr) {
-        CAF_LOG_DEBUG("launch BASP worker for deserializing a"
-                      << hdr.operation);
-        worker->launch(last_hop, hdr, *payload);
-      } else {
-        CAF_LOG_DEBUG("out of BASP workers, continue deserializing a"
-                      << hdr.operation);
-        // If no worker is available then we have no other choice than to take
-        // the performance hit and deserialize in this thread.
-        struct handler : remote_message_handler<handler> {
-          handler(message_queue* queue, proxy_registry* proxies,
-                  actor_system* system, node_id last_hop, basp::header& hdr,
-                  byte_buffer& payload)
-            : queue_(queue),
-              proxies_(proxies),
-              system_(system),
-              last_hop_(std::move(last_hop)),
-              hdr_(hdr),
-              payload_(payload) {
-            msg_id_ = queue_->new_id();
-          }
-          message_queue* queue_;
-          proxy_registry* proxies_;
-          actor_system* system_;
-          node_id last_hop_;
-          basp::header& hdr_;
-          byte_buffer& payload_;
-          uint64_t msg_id_;
-        };
-        handler f{&queue_, &proxies(), &system(), last_hop, hdr, *payload};
-        f.handle_remote_message(callee_.current_execution_unit());
+      handle_message(last_hop, last_hop, hdr, *payload);
+      break;
+    }
+    case message_type::batched_message: {
+      auto last_hop = tbl_.lookup_direct(hdl);
+      // Splitting the batch does not require any state of the broker. Hence,
+      // we leave framing and validation of the sub-headers to the worker. The
+      // worker asks us to close the connection if the batch is malformed.
+      if (auto worker = acquire_worker()) {
+        CAF_LOG_DEBUG("launch BASP worker for a batch of"
+                      << hdr.operation_data << "messages");
+        worker->launch(callee_.this_actor(), hdl, last_hop, hdr, *payload);
+        break;
+      }
+      // Drop malformed batches entirely, just like the workers do.
+      span<const byte> bytes{payload->data(), payload->size()};
+      if (!valid_batch(bytes, hdr.operation_data)) {
+        CAF_LOG_WARNING("received malformed batched message");
+        return malformed_basp_message;
+      }
+      for (uint64_t i = 0; i < hdr.operation_data; ++i) {
+        header sub_hdr;
+        read_sub_header(bytes, sub_hdr);
+        handle_message(last_hop, last_hop, sub_hdr,
+                       bytes.subspan(0, sub_hdr.payload_len));
+        bytes = bytes.subspan(sub_hdr.payload_len,
+                              bytes.size() - sub_hdr.payload_len);
       }
       break;
     }
+    case message_type::intern_node: {
+      // Deserialize payload.
+      binary_deserializer bd{ctx, *payload};
+      node_id nid;
+      if (auto err = bd(nid)) {
+        CAF_LOG_WARNING("unable to deserialize payload of intern_node:"
+                        << ctx->system().render(err));
+        return serializing_basp_payload_failed;
+      }
+      auto& nodes = interned_in_[hdl];
+      if (hdr.operation_data != nodes.size()
+          || nodes.size() >= max_interned_nodes) {
+        CAF_LOG_WARNING("received unexpected handle for interned node:"
+                        << CAF_ARG(hdr.operation_data));
+        return malformed_basp_message;
+      }
+      CAF_LOG_DEBUG("intern node:" << CAF_ARG(hdl) << CAF_ARG(nid)
+                                   << CAF_ARG(hdr.operation_data));
+      nodes.emplace_back(std::move(nid));
+      break;
+    }
     case message_type::monitor_message: {
       // Deserialize payload.
       binary_deserializer bd{ctx, *payload};
@@ -483,6 +773,80 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
   return await_header;
 }
 
+void instance::handle_message(const node_id& last_hop,
+                              const node_id& source_node, header& hdr,
+                              span<const byte> payload) {
+  auto worker = acquire_worker();
+  if (worker != nullptr) {
+    CAF_LOG_DEBUG("launch BASP worker for deserializing a" << hdr.operation);
+    worker->launch(last_hop, source_node, hdr, payload);
+  } else {
+    CAF_LOG_DEBUG("out of BASP workers, continue deserializing a"
+                  << hdr.operation);
+    // If no worker is available then we have no other choice than to take
+    // the performance hit and deserialize in this thread.
+    struct handler : remote_message_handler<handler> {
+      handler(message_queue* queue, proxy_registry* proxies,
+              actor_system* system, node_id last_hop,
+              const node_id& source_node, basp::header& hdr,
+              span<const byte> payload)
+        : queue_(queue),
+          proxies_(proxies),
+          system_(system),
+          last_hop_(std::move(last_hop)),
+          source_node_(source_node),
+          hdr_(hdr),
+          payload_(payload) {
+        msg_id_ = queue_->new_id();
+      }
+      void deliver(execution_unit* ctx, strong_actor_ptr receiver,
+                   mailbox_element_ptr content) {
+        queue_->push(ctx, msg_id_, std::move(receiver), std::move(content));
+      }
+      message_queue* queue_;
+      proxy_registry* proxies_;
+      actor_system* system_;
+      node_id last_hop_;
+      const node_id& source_node_;
+      basp::header& hdr_;
+      span<const byte> payload_;
+      uint64_t msg_id_;
+    };
+    handler f{&queue_, &proxies(), &system(), last_hop, source_node, hdr,
+              payload};
+    f.handle_remote_message(callee_.current_execution_unit());
+  }
+}
+
+worker* instance::acquire_worker() {
+  if (auto result = hub_.pop())
+    return result;
+  // All workers are busy. Grow the pool instead of blocking the broker.
+  if (hub_.size() < max_workers_) {
+    CAF_LOG_DEBUG("add BASP worker:" << CAF_ARG2("size", hub_.size() + 1));
+    hub_.add_new_worker(queue_, proxies());
+    return hub_.pop();
+  }
+  return nullptr;
+}
+
+void instance::forward(execution_unit* ctx, const node_id& source_node,
+                       const node_id& dest_node, header hdr,
+                       span<const byte> payload) {
+  CAF_LOG_TRACE(CAF_ARG(source_node) << CAF_ARG(dest_node) << CAF_ARG(hdr));
+  auto path = lookup(dest_node);
+  if (path) {
+    // Node IDs may use a different representation on the next hop.
+    auto writer = make_callback([&](binary_serializer& sink) {
+      sink.apply(payload);
+      return error_code<sec>{};
+    });
+    write_routed_message(ctx, path->hdl, hdr, source_node, dest_node, writer);
+  } else {
+    CAF_LOG_WARNING("cannot forward message, no route to destination");
+  }
+}
+
 void instance::forward(execution_unit* ctx, const node_id& dest_node,
                        const header& hdr, byte_buffer& payload) {
   CAF_LOG_TRACE(CAF_ARG(dest_node) << CAF_ARG(hdr) << CAF_ARG(payload));
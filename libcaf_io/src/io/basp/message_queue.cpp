@@ -18,47 +18,41 @@
 
 #include "caf/io/basp/message_queue.hpp"
 
-#include <iterator>
+#include <algorithm>
+#include <limits>
 
 namespace caf::io::basp {
 
-message_queue::message_queue() : next_id(0), next_undelivered(0) {
-  // nop
+namespace {
+
+constexpr uint64_t no_overflow = std::numeric_limits<uint64_t>::max();
+
+} // namespace
+
+message_queue::message_queue(size_t capacity)
+  : next_id_(0),
+    next_undelivered_(0),
+    draining_(false),
+    overflow_min_(no_overflow) {
+  size_t n = 2;
+  while (n < capacity)
+    n <<= 1;
+  mask_ = n - 1;
+  slots_.reset(new slot[n]);
 }
 
 void message_queue::push(execution_unit* ctx, uint64_t id,
                          strong_actor_ptr receiver,
                          mailbox_element_ptr content) {
-  std::unique_lock<std::mutex> guard{lock};
-  CAF_ASSERT(id >= next_undelivered);
-  CAF_ASSERT(id < next_id);
-  auto first = pending.begin();
-  auto last = pending.end();
-  if (id == next_undelivered) {
-    // Dispatch current head.
-    if (receiver != nullptr)
-      receiver->enqueue(std::move(content), ctx);
-    auto next = id + 1;
-    // Check whether we can deliver more.
-    if (first == last || first->id != next) {
-      next_undelivered = next;
-      CAF_ASSERT(next_undelivered <= next_id);
-      return;
-    }
-    // Deliver everything until reaching a non-consecutive ID or the end.
-    auto i = first;
-    for (; i != last && i->id == next; ++i, ++next)
-      if (i->receiver != nullptr)
-        i->receiver->enqueue(std::move(i->content), ctx);
-    next_undelivered = next;
-    pending.erase(first, i);
-    CAF_ASSERT(next_undelivered <= next_id);
-    return;
-  }
-  // Get the insertion point.
-  auto pred = [&](const actor_msg& x) { return x.id >= id; };
-  pending.emplace(std::find_if(first, last, pred),
-                  actor_msg{id, std::move(receiver), std::move(content)});
+  store(id, std::move(receiver), std::move(content));
+  drain(ctx);
+}
+
+void message_queue::push(execution_unit* ctx, std::vector<actor_msg>& xs) {
+  for (auto& x : xs)
+    store(x.id, std::move(x.receiver), std::move(x.content));
+  xs.clear();
+  drain(ctx);
 }
 
 void message_queue::drop(execution_unit* ctx, uint64_t id) {
@@ -66,8 +60,81 @@ void message_queue::drop(execution_unit* ctx, uint64_t id) {
 }
 
 uint64_t message_queue::new_id() {
-  std::unique_lock<std::mutex> guard{lock};
-  return next_id++;
+  return next_id_.fetch_add(1);
+}
+
+uint64_t message_queue::new_ids(size_t n) {
+  CAF_ASSERT(n > 0);
+  return next_id_.fetch_add(n);
+}
+
+// -- utility functions --------------------------------------------------------
+
+void message_queue::store(uint64_t id, strong_actor_ptr receiver,
+                          mailbox_element_ptr content) {
+  // The drainer cannot pass `id` before we store it. Hence, `id` still fits
+  // into the ring after the drainer advanced `next_undelivered_`.
+  CAF_ASSERT(id >= next_undelivered_.load());
+  CAF_ASSERT(id < next_id_.load());
+  if (id - next_undelivered_.load() <= mask_) {
+    auto& x = slots_[id & mask_];
+    CAF_ASSERT(!x.ready.load());
+    x.receiver = std::move(receiver);
+    x.content = std::move(content);
+    x.ready.store(true);
+    return;
+  }
+  std::unique_lock<std::mutex> guard{overflow_mtx_};
+  auto pred = [&](const actor_msg& x) { return x.id >= id; };
+  overflow_.emplace(std::find_if(overflow_.begin(), overflow_.end(), pred),
+                    actor_msg{id, std::move(receiver), std::move(content)});
+  overflow_min_.store(overflow_.front().id);
+}
+
+void message_queue::drain(execution_unit* ctx) {
+  for (;;) {
+    if (draining_.exchange(true))
+      return;
+    auto id = next_undelivered_.load();
+    for (;;) {
+      auto& x = slots_[id & mask_];
+      if (!x.ready.load()) {
+        if (overflow_min_.load() != id)
+          break;
+        move_overflow(id);
+        continue;
+      }
+      auto receiver = std::move(x.receiver);
+      auto content = std::move(x.content);
+      // Release the slot before advancing `next_undelivered_`, because
+      // producers may fill it again immediately afterwards.
+      x.ready.store(false);
+      next_undelivered_.store(++id);
+      if (receiver != nullptr)
+        receiver->enqueue(std::move(content), ctx);
+    }
+    draining_.store(false);
+    // Another producer may have stored the next message after we checked its
+    // slot but before we gave up the exclusive access. In this case, the
+    // producer failed to become the drainer and we must try again.
+    if (!slots_[id & mask_].ready.load() && overflow_min_.load() != id)
+      return;
+  }
+}
+
+void message_queue::move_overflow(uint64_t first) {
+  std::unique_lock<std::mutex> guard{overflow_mtx_};
+  auto i = overflow_.begin();
+  auto e = overflow_.end();
+  for (; i != e && i->id - first <= mask_; ++i) {
+    auto& x = slots_[i->id & mask_];
+    CAF_ASSERT(!x.ready.load());
+    x.receiver = std::move(i->receiver);
+    x.content = std::move(i->content);
+    x.ready.store(true);
+  }
+  overflow_.erase(overflow_.begin(), i);
+  overflow_min_.store(overflow_.empty() ? no_overflow : overflow_.front().id);
 }
 
 } // namespace caf::io::basp
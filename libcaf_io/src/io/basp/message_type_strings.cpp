@@ -27,6 +27,10 @@ std::string to_string(message_type x) {
       return "down_message";
     case message_type::heartbeat:
       return "heartbeat";
+    case message_type::batched_message:
+      return "batched_message";
+    case message_type::intern_node:
+      return "intern_node";
   };
 }
 
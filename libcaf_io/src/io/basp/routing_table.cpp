@@ -19,9 +19,18 @@
 #include "caf/io/basp/routing_table.hpp"
 
 #include "caf/io/middleman.hpp"
+#include "caf/locks.hpp"
 
 namespace caf::io::basp {
 
+namespace {
+
+using exclusive_guard = unique_lock<detail::shared_spinlock>;
+
+using shared_guard = shared_lock<detail::shared_spinlock>;
+
+} // namespace
+
 routing_table::routing_table(abstract_broker* parent) : parent_(parent) {
   // nop
 }
@@ -31,31 +40,27 @@ routing_table::~routing_table() {
 }
 
 optional<routing_table::route> routing_table::lookup(const node_id& target) {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   // Check whether we have a direct path first.
   { // Lifetime scope of first iterator.
     auto i = direct_by_nid_.find(target);
     if (i != direct_by_nid_.end())
       return route{target, i->second};
   }
-  // Pick first available indirect route.
+  // Pick first available indirect route. No need to check for hops that
+  // became invalid, since erase_direct removes them.
   auto i = indirect_.find(target);
-  if (i != indirect_.end()) {
-    auto& hops = i->second;
-    while (!hops.empty()) {
-      auto& hop = *hops.begin();
-      auto j = direct_by_nid_.find(hop);
-      if (j != direct_by_nid_.end())
-        return route{hop, j->second};
-      // Erase hops that became invalid.
-      hops.erase(hops.begin());
-    }
+  if (i != indirect_.end() && !i->second.empty()) {
+    auto& hop = *i->second.begin();
+    auto j = direct_by_nid_.find(hop);
+    if (j != direct_by_nid_.end())
+      return route{hop, j->second};
   }
   return none;
 }
 
 node_id routing_table::lookup_direct(const connection_handle& hdl) const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = direct_by_hdl_.find(hdl);
   if (i != direct_by_hdl_.end())
     return i->second;
@@ -64,7 +69,7 @@ node_id routing_table::lookup_direct(const connection_handle& hdl) const {
 
 optional<connection_handle>
 routing_table::lookup_direct(const node_id& nid) const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = direct_by_nid_.find(nid);
   if (i != direct_by_nid_.end())
     return i->second;
@@ -72,7 +77,7 @@ routing_table::lookup_direct(const node_id& nid) const {
 }
 
 node_id routing_table::lookup_indirect(const node_id& nid) const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = indirect_.find(nid);
   if (i == indirect_.end())
     return {};
@@ -82,18 +87,26 @@ node_id routing_table::lookup_indirect(const node_id& nid) const {
 }
 
 node_id routing_table::erase_direct(const connection_handle& hdl) {
-  std::unique_lock<std::mutex> guard{mtx_};
+  exclusive_guard guard{mtx_};
   auto i = direct_by_hdl_.find(hdl);
   if (i == direct_by_hdl_.end())
     return {};
   direct_by_nid_.erase(i->second);
   node_id result = std::move(i->second);
   direct_by_hdl_.erase(i->first);
+  // Drop all indirect routes via the erased node to keep lookups read-only.
+  for (auto j = indirect_.begin(); j != indirect_.end();) {
+    j->second.erase(result);
+    if (j->second.empty())
+      j = indirect_.erase(j);
+    else
+      ++j;
+  }
   return result;
 }
 
 bool routing_table::erase_indirect(const node_id& dest) {
-  std::unique_lock<std::mutex> guard{mtx_};
+  exclusive_guard guard{mtx_};
   auto i = indirect_.find(dest);
   if (i == indirect_.end())
     return false;
@@ -103,7 +116,7 @@ bool routing_table::erase_indirect(const node_id& dest) {
 
 void routing_table::add_direct(const connection_handle& hdl,
                                const node_id& nid) {
-  std::unique_lock<std::mutex> guard{mtx_};
+  exclusive_guard guard{mtx_};
   auto hdl_added = direct_by_hdl_.emplace(hdl, nid).second;
   auto nid_added = direct_by_nid_.emplace(nid, hdl).second;
   CAF_ASSERT(hdl_added && nid_added);
@@ -112,7 +125,7 @@ void routing_table::add_direct(const connection_handle& hdl,
 }
 
 bool routing_table::add_indirect(const node_id& hop, const node_id& dest) {
-  std::unique_lock<std::mutex> guard{mtx_};
+  exclusive_guard guard{mtx_};
   // Never add indirect entries if we already have direct connection.
   if (direct_by_nid_.count(dest) != 0)
     return false;
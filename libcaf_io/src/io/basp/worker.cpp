@@ -19,9 +19,13 @@
 #include "caf/io/basp/worker.hpp"
 
 #include "caf/actor_system.hpp"
+#include "caf/io/basp/header.hpp"
 #include "caf/io/basp/message_queue.hpp"
+#include "caf/logger.hpp"
+#include "caf/mailbox_element.hpp"
 #include "caf/proxy_registry.hpp"
 #include "caf/scheduler/abstract_coordinator.hpp"
+#include "caf/span.hpp"
 
 namespace caf::io::basp {
 
@@ -39,14 +43,38 @@ worker::~worker() {
 // -- management ---------------------------------------------------------------
 
 void worker::launch(const node_id& last_hop, const basp::header& hdr,
-                    const byte_buffer& payload) {
-  CAF_ASSERT(hdr.dest_actor != 0);
+                    span<const byte> payload) {
+  CAF_ASSERT(hdr.operation == basp::message_type::direct_message);
+  launch(last_hop, last_hop, hdr, payload);
+}
+
+void worker::launch(strong_actor_ptr broker, connection_handle hdl,
+                    const node_id& last_hop, const basp::header& hdr,
+                    span<const byte> payload) {
+  CAF_ASSERT(hdr.operation == basp::message_type::batched_message);
+  broker_ = std::move(broker);
+  hdl_ = hdl;
+  launch(last_hop, last_hop, hdr, payload);
+}
+
+void worker::launch(const node_id& last_hop, const node_id& source_node,
+                    const basp::header& hdr, span<const byte> payload) {
+  CAF_ASSERT(hdr.operation == basp::message_type::batched_message
+             || hdr.dest_actor != 0);
   CAF_ASSERT(hdr.operation == basp::message_type::direct_message
-             || hdr.operation == basp::message_type::routed_message);
-  msg_id_ = queue_->new_id();
+             || hdr.operation == basp::message_type::routed_message
+             || hdr.operation == basp::message_type::batched_message);
   last_hop_ = last_hop;
+  source_node_ = source_node;
   memcpy(&hdr_, &hdr, sizeof(basp::header));
-  payload_.assign(payload.begin(), payload.end());
+  if (hdr.operation == basp::message_type::batched_message) {
+    // Reserve one ID per sub-message to keep the order of the batch.
+    msg_id_ = queue_->new_ids(hdr.operation_data);
+    batch_.assign(payload.begin(), payload.end());
+  } else {
+    msg_id_ = queue_->new_id();
+    payload_.assign(payload.begin(), payload.end());
+  }
   ref();
   system_->scheduler().enqueue(this);
 }
@@ -55,9 +83,56 @@ void worker::launch(const node_id& last_hop, const basp::header& hdr,
 
 resumable::resume_result worker::resume(execution_unit* ctx, size_t) {
   ctx->proxy_registry_ptr(proxies_);
-  handle_remote_message(ctx);
+  if (hdr_.operation == basp::message_type::batched_message)
+    handle_batch(ctx);
+  else
+    handle_remote_message(ctx);
   hub_->push(this);
   return resumable::awaiting_message;
 }
 
+// -- utility functions --------------------------------------------------------
+
+void worker::handle_batch(execution_unit* ctx) {
+  CAF_LOG_TRACE(CAF_ARG(hdr_));
+  auto first_id = msg_id_;
+  auto n = hdr_.operation_data;
+  auto broker = std::move(broker_);
+  span<const byte> bytes{batch_.data(), batch_.size()};
+  if (!valid_batch(bytes, n)) {
+    // Just like the broker does for malformed batches on its own thread, we
+    // drop the entire batch and close the connection. The broker receives
+    // our message after all messages that arrived before this batch.
+    CAF_LOG_WARNING("received malformed batched message");
+    delivered_.emplace_back(message_queue::actor_msg{
+      first_id, std::move(broker),
+      make_mailbox_element(nullptr, make_message_id(), {}, close_atom_v,
+                           hdl_)});
+    for (uint64_t i = 1; i < n; ++i)
+      delivered_.emplace_back(
+        message_queue::actor_msg{first_id + i, nullptr, nullptr});
+    queue_->push(ctx, delivered_);
+    return;
+  }
+  in_batch_ = true;
+  for (uint64_t i = 0; i < n; ++i) {
+    msg_id_ = first_id + i;
+    read_sub_header(bytes, hdr_);
+    payload_.assign(bytes.begin(), bytes.begin() + hdr_.payload_len);
+    bytes = bytes.subspan(hdr_.payload_len, bytes.size() - hdr_.payload_len);
+    handle_remote_message(ctx);
+  }
+  in_batch_ = false;
+  queue_->push(ctx, delivered_);
+}
+
+void worker::deliver(execution_unit* ctx, strong_actor_ptr receiver,
+                     mailbox_element_ptr content) {
+  if (in_batch_)
+    delivered_.emplace_back(message_queue::actor_msg{
+      msg_id_, std::move(receiver), std::move(content)});
+  else
+    queue_->push(ctx, msg_id_, std::move(receiver), std::move(content));
+}
+
 } // namespace caf::io::basp
@@ -20,10 +20,13 @@
 
 #include <chrono>
 #include <limits>
+#include <random>
+#include <vector>
 
 #include "caf/actor_registry.hpp"
 #include "caf/actor_system_config.hpp"
 #include "caf/after.hpp"
+#include "caf/binary_deserializer.hpp"
 #include "caf/defaults.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
 #include "caf/event_based_actor.hpp"
@@ -36,6 +39,7 @@
 #include "caf/make_counted.hpp"
 #include "caf/sec.hpp"
 #include "caf/send.hpp"
+#include "caf/span.hpp"
 
 namespace {
 
@@ -50,6 +54,23 @@ THREAD_LOCAL caf::node_id* t_last_hop = nullptr;
 
 #undef THREAD_LOCAL
 
+// Checks whether `frame` holds a well-formed BASP client handshake.
+bool is_client_handshake(caf::span<const caf::byte> frame) {
+  using namespace caf::io;
+  if (frame.size() < basp::header_size)
+    return false;
+  basp::header hdr;
+  caf::binary_deserializer source{nullptr, frame.data(), basp::header_size};
+  if (source(hdr) || !basp::valid(hdr)
+      || hdr.operation != basp::message_type::client_handshake
+      || frame.size() != basp::header_size + hdr.payload_len)
+    return false;
+  caf::node_id source_node;
+  caf::binary_deserializer payload{nullptr, frame.data() + basp::header_size,
+                                   hdr.payload_len};
+  return !payload(source_node) && source_node != caf::none;
+}
+
 } // namespace
 
 namespace caf::io {
@@ -72,6 +93,8 @@ basp_broker::~basp_broker() {
 // -- implementation of local_actor/broker -------------------------------------
 
 void basp_broker::on_exit() {
+  // Ship any messages we have coalesced before terminating.
+  instance.flush_batches(context());
   // Wait until all pending messages of workers have been shipped.
   // TODO: this blocks the calling thread. This is only safe because we know
   //       that the middleman calls this in its stop() function. However,
@@ -86,6 +109,7 @@ void basp_broker::on_exit() {
   node_observers.clear();
   // Release any obsolete state.
   ctx.clear();
+  udp_scribes.clear();
   // Make sure all spawn servers are down before clearing the container.
   for (auto& kvp : spawn_servers)
     anon_send_exit(kvp.second, exit_reason::kill);
@@ -126,6 +150,8 @@ behavior basp_broker::make_behavior() {
     CAF_LOG_DEBUG("enable heartbeat" << CAF_ARG(heartbeat_interval));
     send(this, tick_atom_v, heartbeat_interval);
   }
+  udp_loss_rate = get_or(config(), "middleman.udp-loss-rate",
+                         defaults::middleman::udp_loss_rate);
   return behavior{
     // received from underlying broker implementation
     [=](new_data_msg& msg) {
@@ -275,6 +301,11 @@ behavior basp_broker::make_behavior() {
     [=](delete_atom, connection_handle hdl) {
       connection_cleanup(hdl, sec::none);
     },
+    // received from BASP workers for malformed batches
+    [=](close_atom, connection_handle hdl) {
+      connection_cleanup(hdl, sec::malformed_basp_message);
+      close(hdl);
+    },
     // received from underlying broker implementation
     [=](const acceptor_closed_msg& msg) {
       CAF_LOG_TRACE("");
@@ -317,6 +348,59 @@ behavior basp_broker::make_behavior() {
       flush(hdl);
       configure_read(hdl, receive_policy::exactly(basp::header_size));
     },
+    // received from middleman actor
+    [=](publish_udp_atom, datagram_servant_ptr& ptr, uint16_t port,
+        const strong_actor_ptr& whom, std::set<std::string>& sigs) {
+      CAF_LOG_TRACE(CAF_ARG(ptr)
+                    << CAF_ARG(port) << CAF_ARG(whom) << CAF_ARG(sigs));
+      CAF_ASSERT(ptr != nullptr);
+      add_datagram_servant(std::move(ptr));
+      if (whom)
+        system().registry().put(whom->id(), whom);
+      instance.add_published_actor(port, whom, std::move(sigs));
+    },
+    // received from middleman actor (delegated)
+    [=](contact_atom, datagram_servant_ptr& ptr, uint16_t port) {
+      CAF_LOG_TRACE(CAF_ARG(ptr) << CAF_ARG(port));
+      CAF_ASSERT(ptr != nullptr);
+      auto rp = make_response_promise();
+      auto dgram_hdl = ptr->hdl();
+      add_datagram_servant(std::move(ptr));
+      auto hdl = add_udp_scribe(dgram_hdl).hdl();
+      auto& ctx = this->ctx[hdl];
+      ctx.hdl = hdl;
+      ctx.remote_port = port;
+      ctx.cstate = basp::await_header;
+      ctx.callback = rp;
+      instance.write_client_handshake(context(), get_buffer(hdl));
+      flush(hdl);
+    },
+    // received from underlying broker implementation
+    [=](new_datagram_msg& msg) {
+      handle_datagram(msg);
+    },
+    // received from underlying broker implementation
+    [=](const datagram_servant_closed_msg& msg) {
+      CAF_LOG_TRACE(CAF_ARG(msg.handles));
+      for (auto dgram_hdl : msg.handles)
+        drop_udp_scribe(basp::datagram_scribe::conn_hdl_from(dgram_hdl),
+                        sec::socket_disconnected);
+    },
+    // received from a datagram scribe whenever its channel needs attention
+    [=](tick_atom, connection_handle hdl) {
+      auto i = udp_scribes.find(hdl);
+      if (i == udp_scribes.end() || i->second->detached())
+        return;
+      auto ptr = i->second;
+      ptr->handle_timeout();
+      if (ptr->detached()) {
+        // A closing channel delivered all of its frames.
+        release_udp_scribe(hdl);
+      } else if (ptr->channel().failed()) {
+        CAF_LOG_INFO("UDP peer stopped responding:" << CAF_ARG(hdl));
+        close_udp_scribe(hdl, sec::socket_disconnected);
+      }
+    },
     // received from middleman actor (delegated)
     [=](connect_atom, scribe_ptr& ptr, uint16_t port) {
       CAF_LOG_TRACE(CAF_ARG(ptr) << CAF_ARG(port));
@@ -348,7 +432,7 @@ behavior basp_broker::make_behavior() {
     [=](unpublish_atom, const actor_addr& whom, uint16_t port) -> result<void> {
       CAF_LOG_TRACE(CAF_ARG(whom) << CAF_ARG(port));
       auto cb = make_callback([&](const strong_actor_ptr&, uint16_t x) {
-        close(hdl_by_port(x));
+        close_port(x);
         return error_code<sec>{};
       });
       if (instance.remove_published_actor(whom, port, &cb) == 0)
@@ -361,8 +445,7 @@ behavior basp_broker::make_behavior() {
       // It is well-defined behavior to not have an actor published here,
       // hence the result can be ignored safely.
       instance.remove_published_actor(port, nullptr);
-      auto res = close(hdl_by_port(port));
-      if (res)
+      if (close_port(port))
         return unit;
       return sec::cannot_close_invalid_port;
     },
@@ -377,6 +460,20 @@ behavior basp_broker::make_behavior() {
       }
       return std::make_tuple(x, std::move(addr), port);
     },
+    // received from the middleman actor (delegated)
+    [=](get_atom, pending_atom,
+        const node_id& x) -> std::tuple<uint64_t, bool> {
+      if (auto path = instance.tbl().lookup(x)) {
+        auto hdl = path->hdl;
+        return std::make_tuple(uint64_t{pending_bytes(hdl)},
+                               instance.congested(hdl));
+      }
+      return std::make_tuple(uint64_t{0}, false);
+    },
+    // received from underlying broker implementation
+    [=](const data_transferred_msg& msg) {
+      instance.handle_data_transferred(msg.handle, msg.remaining);
+    },
     [=](tick_atom, size_t interval) {
       instance.handle_heartbeat(context());
       delayed_send(this, std::chrono::milliseconds{interval}, tick_atom_v,
@@ -392,7 +489,15 @@ resumable::resume_result basp_broker::resume(execution_unit* ctx, size_t mt) {
   ctx->proxy_registry_ptr(&instance.proxies());
   auto guard
     = detail::make_scope_guard([=] { ctx->proxy_registry_ptr(nullptr); });
-  return super::resume(ctx, mt);
+  // Coalesce all direct messages we send while processing our mailbox. Once
+  // we are done, on_exit has already written pending batches.
+  instance.begin_batching();
+  auto result = super::resume(ctx, mt);
+  if (result != resumable::done) {
+    instance.flush_batches(ctx);
+    instance.shrink_workers(clock().now());
+  }
+  return result;
 }
 
 strong_actor_ptr basp_broker::make_proxy(node_id nid, actor_id aid) {
@@ -629,6 +734,7 @@ void basp_broker::connection_cleanup(connection_handle hdl, sec code) {
     emit_node_down_msg(nid, code);
     purge_state(nid);
   }
+  instance.erase_connection(hdl);
   // Remove the context for `hdl`, making sure clients receive an error in case
   // this connection was closed during handshake.
   auto i = ctx.find(hdl);
@@ -644,7 +750,170 @@ void basp_broker::connection_cleanup(connection_handle hdl, sec code) {
   }
 }
 
+bool basp_broker::close_port(uint16_t port) {
+  std::vector<accept_handle> hdls;
+  for (auto& kvp : get_map(accept_handle{}))
+    if (kvp.second->port() == port)
+      hdls.emplace_back(kvp.first);
+  for (auto hdl : hdls)
+    close(hdl);
+  // Datagram servants appear once per endpoint in the map. Only the servant's
+  // own handle refers to the local port.
+  std::vector<datagram_servant_ptr> servants;
+  for (auto& kvp : get_map(datagram_handle{}))
+    if (kvp.first == kvp.second->hdl() && kvp.second->local_port() == port)
+      servants.emplace_back(kvp.second);
+  for (auto& servant : servants) {
+    // All peers share the socket of the servant, i.e., we lose all of them.
+    for (auto dgram_hdl : servant->hdls())
+      drop_udp_scribe(basp::datagram_scribe::conn_hdl_from(dgram_hdl),
+                      sec::none);
+    close(servant->hdl());
+  }
+  return !hdls.empty() || !servants.empty();
+}
+
+basp::datagram_scribe& basp_broker::add_udp_scribe(datagram_handle hdl) {
+  CAF_LOG_TRACE(CAF_ARG(hdl));
+  // Random session IDs allow peers to tell a new session from late packets of
+  // a previous one on the same endpoint.
+  std::random_device rd;
+  auto ptr = make_counted<basp::datagram_scribe>(this, hdl, rd(),
+                                                 udp_loss_rate);
+  auto& ref = *ptr;
+  instance.mark_unordered(ref.hdl());
+  udp_scribes[ref.hdl()] = ptr;
+  add_scribe(std::move(ptr));
+  return ref;
+}
+
+void basp_broker::handle_datagram(new_datagram_msg& msg) {
+  CAF_LOG_TRACE(CAF_ARG(msg.handle));
+  auto data = msg.buf.data();
+  auto size = msg.buf.size();
+  auto hdl = basp::datagram_scribe::conn_hdl_from(msg.handle);
+  auto i = udp_scribes.find(hdl);
+  if (i != udp_scribes.end() && !i->second->channel().accepts(data, size)) {
+    // Only the closed session of a published port may make room for a new
+    // one. Otherwise, the datagram belongs to a stale or foreign session.
+    if (!i->second->detached()) {
+      CAF_LOG_DEBUG("drop datagram of unknown session:" << CAF_ARG(hdl));
+      return;
+    }
+    udp_scribes.erase(i);
+    i = udp_scribes.end();
+  }
+  if (i == udp_scribes.end()) {
+    // Only servants for published ports receive datagrams from new peers. We
+    // neither allocate state nor reply before receiving a client handshake.
+    // Otherwise, spoofed datagrams would turn us into a reflector.
+    using network::reliable_channel;
+    if (!is_client_handshake(reliable_channel::initial_frame(data, size))) {
+      CAF_LOG_DEBUG("drop datagram of unknown peer:" << CAF_ARG(hdl));
+      return;
+    }
+    CAF_LOG_DEBUG("new UDP peer:" << CAF_ARG(hdl));
+    add_udp_scribe(msg.handle);
+    set_context(hdl);
+    instance.write_server_handshake(context(), get_buffer(hdl),
+                                    local_port(msg.handle));
+    flush(hdl);
+    i = udp_scribes.find(hdl);
+  }
+  auto ptr = i->second;
+  if (ptr->detached()) {
+    CAF_LOG_DEBUG("drop datagram of closed session:" << CAF_ARG(hdl));
+    return;
+  }
+  auto& channel = ptr->channel();
+  auto consumer = [&](uint16_t, byte_buffer& frame) {
+    // Processing a frame may close the connection. Closing channels only wait
+    // for the peer to acknowledge their remaining frames.
+    if (!ptr->detached() && !channel.closing())
+      handle_frame(hdl, frame);
+  };
+  if (!channel.handle_datagram(clock().now(), data, size, consumer)) {
+    CAF_LOG_DEBUG("drop malformed datagram:" << CAF_ARG(hdl));
+    return;
+  }
+  if (ptr->detached())
+    return;
+  if (channel.closed() && !channel.closing()) {
+    CAF_LOG_DEBUG("UDP peer closed the connection:" << CAF_ARG(hdl));
+    close_udp_scribe(hdl, sec::none);
+    return;
+  }
+  // Send ACKs and any data the peer's ACKs allow us to send.
+  ptr->transmit();
+  if (ptr->detached()) {
+    release_udp_scribe(hdl);
+    return;
+  }
+  instance.handle_data_transferred(hdl, ptr->pending_bytes());
+}
+
+void basp_broker::handle_frame(connection_handle hdl, byte_buffer& frame) {
+  set_context(hdl);
+  auto& hdr = this_context->hdr;
+  auto next = basp::malformed_basp_message;
+  binary_deserializer source{context(), frame};
+  if (!source(hdr) && basp::valid(hdr)
+      && frame.size() == basp::header_size + hdr.payload_len) {
+    if (hdr.payload_len == 0) {
+      next = instance.handle(context(), hdl, hdr, nullptr);
+    } else {
+      frame.erase(frame.begin(), frame.begin() + basp::header_size);
+      next = instance.handle(context(), hdl, hdr, &frame);
+    }
+  }
+  if (requires_shutdown(next))
+    close_udp_scribe(hdl, to_sec(next));
+}
+
+void basp_broker::close_udp_scribe(connection_handle hdl, sec code) {
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(code));
+  auto i = udp_scribes.find(hdl);
+  if (i == udp_scribes.end() || i->second->detached()
+      || i->second->channel().closing())
+    return;
+  auto ptr = i->second;
+  connection_cleanup(hdl, code);
+  // The scribe detaches once the peer acknowledged all pending messages.
+  ptr->graceful_shutdown();
+  if (ptr->detached())
+    release_udp_scribe(hdl);
+}
+
+void basp_broker::drop_udp_scribe(connection_handle hdl, sec code) {
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(code));
+  close_udp_scribe(hdl, code);
+  auto i = udp_scribes.find(hdl);
+  if (i == udp_scribes.end())
+    return;
+  if (!i->second->detached())
+    i->second->detach(context(), false);
+  udp_scribes.erase(i);
+}
+
+void basp_broker::release_udp_scribe(connection_handle hdl) {
+  CAF_LOG_TRACE(CAF_ARG(hdl));
+  auto i = udp_scribes.find(hdl);
+  if (i == udp_scribes.end())
+    return;
+  // Servants that we have created for contacting a peer serve only this peer
+  // and receive datagrams under their own handle.
+  auto dgram_hdl = i->second->dgram_hdl();
+  auto& servants = get_map(dgram_hdl);
+  if (auto j = servants.find(dgram_hdl);
+      j != servants.end() && j->second->hdl() == dgram_hdl) {
+    udp_scribes.erase(i);
+    close(dgram_hdl);
+  }
+}
+
 byte_buffer& basp_broker::get_buffer(connection_handle hdl) {
+  // Keep the order of BASP messages by writing pending batches first.
+  instance.flush_batch(context(), hdl);
   return wr_buf(hdl);
 }
 
@@ -652,6 +921,16 @@ void basp_broker::flush(connection_handle hdl) {
   super::flush(hdl);
 }
 
+size_t basp_broker::pending_bytes(connection_handle hdl) {
+  return super::pending_bytes(hdl);
+}
+
+void basp_broker::congestion_changed(connection_handle hdl, bool congested) {
+  // Ask the transport to report progress while congested in order to leave
+  // this state as soon as possible.
+  ack_writes(hdl, congested);
+}
+
 void basp_broker::handle_heartbeat() {
   // nop
 }
@@ -20,10 +20,12 @@
 
 #include <cerrno>
 #include <cstring>
+#include <future>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <tuple>
+#include <type_traits>
 
 #include "caf/actor.hpp"
 #include "caf/actor_proxy.hpp"
@@ -75,6 +77,16 @@ public:
     return backend_;
   }
 
+  backend_pointer make_backend() override {
+    // Only the default multiplexer runs in a thread of its own. Test fixtures
+    // drive the primary test multiplexer manually and would never run
+    // additional instances.
+    if constexpr (std::is_same<T, network::default_multiplexer>::value)
+      return backend_pointer{new T(&system())};
+    else
+      return nullptr;
+  }
+
 private:
   T backend_;
 };
@@ -90,10 +102,60 @@ actor_system::module* middleman::make(actor_system& sys, detail::type_list<>) {
     return new mm_impl<network::default_multiplexer>(sys);
 }
 
-middleman::middleman(actor_system& sys) : system_(sys) {
+middleman::middleman(actor_system& sys) : system_(sys), next_backend_(0) {
   // nop
 }
 
+network::multiplexer& middleman::backend_at(size_t index) {
+  CAF_ASSERT(index < num_backends());
+  return index == 0 ? backend() : *aux_backends_[index - 1];
+}
+
+network::multiplexer* middleman::backend_of(execution_unit* host) noexcept {
+  if (host == nullptr)
+    return nullptr;
+  if (host == &backend())
+    return &backend();
+  for (auto& ptr : aux_backends_)
+    if (host == ptr.get())
+      return ptr.get();
+  return nullptr;
+}
+
+middleman::backend_pointer middleman::make_backend() {
+  return nullptr;
+}
+
+expected<std::vector<doorman_ptr>>
+middleman::new_sharded_doormen(uint16_t& port) {
+  CAF_LOG_TRACE(CAF_ARG(port));
+  std::vector<doorman_ptr> result;
+  if (num_backends() == 1) {
+    auto dm = backend().new_tcp_doorman(port);
+    if (!dm)
+      return std::move(dm.error());
+    port = (*dm)->port();
+    result.emplace_back(std::move(*dm));
+    return result;
+  }
+  // Only the default multiplexer supports multiple instances (see
+  // make_backend). Hence, all backends accept native sockets.
+  for (size_t i = 0; i < num_backends(); ++i) {
+    auto fd = network::new_tcp_acceptor_impl(port, nullptr, false, true);
+    if (!fd) {
+      if (result.empty())
+        return std::move(fd.error());
+      CAF_LOG_WARNING("cannot open additional acceptor, continue with"
+                      << result.size() << "shards:" << fd.error());
+      break;
+    }
+    result.emplace_back(backend_at(i).new_doorman(*fd));
+    // Binds all remaining sockets to the same port if the user passed 0.
+    port = result.back()->port();
+  }
+  return result;
+}
+
 expected<strong_actor_ptr>
 middleman::remote_spawn_impl(const node_id& nid, std::string& name,
                              message& args, std::set<std::string> s,
@@ -136,6 +198,20 @@ expected<uint16_t> middleman::publish(const strong_actor_ptr& whom,
   return f(publish_atom_v, port, std::move(whom), std::move(sigs), in, ru);
 }
 
+expected<uint16_t> middleman::publish_udp(const strong_actor_ptr& whom,
+                                          std::set<std::string> sigs,
+                                          uint16_t port, const char* cstr,
+                                          bool ru) {
+  CAF_LOG_TRACE(CAF_ARG(whom) << CAF_ARG(sigs) << CAF_ARG(port));
+  if (!whom)
+    return sec::cannot_publish_invalid_actor;
+  std::string in;
+  if (cstr != nullptr)
+    in = cstr;
+  auto f = make_function_view(actor_handle());
+  return f(publish_udp_atom_v, port, std::move(whom), std::move(sigs), in, ru);
+}
+
 expected<uint16_t> middleman::publish_local_groups(uint16_t port,
                                                    const char* in, bool reuse) {
   CAF_LOG_TRACE(CAF_ARG(port) << CAF_ARG(in));
@@ -179,6 +255,23 @@ expected<strong_actor_ptr> middleman::remote_actor(std::set<std::string> ifs,
   return ptr;
 }
 
+expected<strong_actor_ptr>
+middleman::remote_actor_udp(std::set<std::string> ifs, std::string host,
+                            uint16_t port) {
+  CAF_LOG_TRACE(CAF_ARG(ifs) << CAF_ARG(host) << CAF_ARG(port));
+  auto f = make_function_view(actor_handle());
+  auto res = f(contact_atom_v, std::move(host), port);
+  if (!res)
+    return std::move(res.error());
+  strong_actor_ptr ptr = std::move(std::get<1>(*res));
+  if (!ptr)
+    return make_error(sec::no_actor_published_at_port, port);
+  if (!system().assignable(std::get<2>(*res), ifs))
+    return make_error(sec::unexpected_actor_messaging_interface, std::move(ifs),
+                      std::move(std::get<2>(*res)));
+  return ptr;
+}
+
 expected<group> middleman::remote_group(const std::string& group_uri) {
   CAF_LOG_TRACE(CAF_ARG(group_uri));
   // format of group_identifier is group@host:port
@@ -294,6 +387,29 @@ void middleman::start() {
     std::unique_lock<std::mutex> guard{mtx};
     while (init_done == false)
       cv.wait(guard);
+    // Launch additional multiplexers.
+    auto num = get_or(config(), "middleman.multiplexer-threads",
+                      defaults::middleman::multiplexer_threads);
+    for (size_t i = 1; i < num; ++i) {
+      auto ptr = make_backend();
+      if (ptr == nullptr)
+        break;
+      aux_supervisors_.emplace_back(ptr->make_supervisor());
+      auto mpx = ptr.get();
+      aux_backends_.emplace_back(std::move(ptr));
+      std::promise<void> started;
+      auto started_future = started.get_future();
+      aux_threads_.emplace_back([this, mpx, &started] {
+        CAF_SET_LOGGER_SYS(&system());
+        detail::set_thread_name("caf.multiplexer");
+        system().thread_started();
+        mpx->thread_id(std::this_thread::get_id());
+        started.set_value();
+        mpx->run();
+        system().thread_terminates();
+      });
+      started_future.wait();
+    }
   }
   // Spawn utility actors.
   auto basp = named_broker<basp_broker>("BASP");
@@ -320,6 +436,10 @@ void middleman::stop() {
     backend_supervisor_.reset();
     if (thread_.joinable())
       thread_.join();
+    aux_supervisors_.clear();
+    for (auto& t : aux_threads_)
+      t.join();
+    aux_threads_.clear();
   } else {
     while (backend().try_run_once())
       ; // nop
@@ -18,6 +18,7 @@
 
 #include "caf/io/middleman_actor_impl.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 #include <tuple>
 #include <utility>
@@ -25,6 +26,7 @@
 #include "caf/actor.hpp"
 #include "caf/actor_proxy.hpp"
 #include "caf/actor_system_config.hpp"
+#include "caf/defaults.hpp"
 #include "caf/io/basp/header.hpp"
 #include "caf/io/basp_broker.hpp"
 #include "caf/io/network/default_multiplexer.hpp"
@@ -38,17 +40,32 @@
 
 namespace caf::io {
 
+namespace {
+
+// Checks whether `host` resolves to an address of this machine.
+bool is_local_host(const std::string& host) {
+  auto addr = network::interfaces::native_address(host);
+  if (!addr)
+    return false;
+  auto addrs = network::interfaces::list_addresses(addr->second);
+  return std::find(addrs.begin(), addrs.end(), addr->first) != addrs.end();
+}
+
+} // namespace
+
 middleman_actor_impl::middleman_actor_impl(actor_config& cfg,
                                            actor default_broker)
   : middleman_actor::base(cfg), broker_(std::move(default_broker)) {
   set_down_handler([=](down_msg& dm) {
-    auto i = cached_tcp_.begin();
-    auto e = cached_tcp_.end();
-    while (i != e) {
-      if (get<1>(i->second) == dm.source)
-        i = cached_tcp_.erase(i);
-      else
-        ++i;
+    for (auto cache : {&cached_tcp_, &cached_udp_}) {
+      auto i = cache->begin();
+      auto e = cache->end();
+      while (i != e) {
+        if (get<1>(i->second) == dm.source)
+          i = cache->erase(i);
+        else
+          ++i;
+      }
     }
   });
   set_exit_handler([=](exit_msg&) {
@@ -61,10 +78,13 @@ void middleman_actor_impl::on_exit() {
   CAF_LOG_TRACE("");
   broker_ = nullptr;
   cached_tcp_.clear();
-  for (auto& kvp : pending_)
-    for (auto& promise : kvp.second)
-      promise.deliver(make_error(sec::cannot_connect_to_node));
-  pending_.clear();
+  cached_udp_.clear();
+  for (auto pending : {&pending_, &pending_udp_}) {
+    for (auto& kvp : *pending)
+      for (auto& promise : kvp.second)
+        promise.deliver(make_error(sec::cannot_connect_to_node));
+    pending->clear();
+  }
 }
 
 const char* middleman_actor_impl::name() const {
@@ -87,56 +107,16 @@ auto middleman_actor_impl::make_behavior() -> behavior_type {
     },
     [=](connect_atom, std::string& hostname, uint16_t port) -> get_res {
       CAF_LOG_TRACE(CAF_ARG(hostname) << CAF_ARG(port));
-      auto rp = make_response_promise();
-      endpoint key{std::move(hostname), port};
-      // respond immediately if endpoint is cached
-      auto x = cached_tcp(key);
-      if (x) {
-        CAF_LOG_DEBUG("found cached entry" << CAF_ARG(*x));
-        rp.deliver(get<0>(*x), get<1>(*x), get<2>(*x));
-        return get_delegated{};
-      }
-      // attach this promise to a pending request if possible
-      auto rps = pending(key);
-      if (rps) {
-        CAF_LOG_DEBUG("attach to pending request");
-        rps->emplace_back(std::move(rp));
-        return get_delegated{};
-      }
-      // connect to endpoint and initiate handhsake etc.
-      auto r = connect(key.first, port);
-      if (!r) {
-        rp.deliver(std::move(r.error()));
-        return get_delegated{};
-      }
-      auto& ptr = *r;
-      std::vector<response_promise> tmp{std::move(rp)};
-      pending_.emplace(key, std::move(tmp));
-      request(broker_, infinite, connect_atom_v, std::move(ptr), port)
-        .then(
-          [=](node_id& nid, strong_actor_ptr& addr, mpi_set& sigs) {
-            auto i = pending_.find(key);
-            if (i == pending_.end())
-              return;
-            if (nid && addr) {
-              monitor(addr);
-              cached_tcp_.emplace(key, std::make_tuple(nid, addr, sigs));
-            }
-            auto res
-              = make_message(std::move(nid), std::move(addr), std::move(sigs));
-            for (auto& promise : i->second)
-              promise.deliver(res);
-            pending_.erase(i);
-          },
-          [=](error& err) {
-            auto i = pending_.find(key);
-            if (i == pending_.end())
-              return;
-            for (auto& promise : i->second)
-              promise.deliver(err);
-            pending_.erase(i);
-          });
-      return get_delegated{};
+      return connect_to(endpoint{std::move(hostname), port}, false);
+    },
+    [=](publish_udp_atom, uint16_t port, strong_actor_ptr& whom, mpi_set& sigs,
+        std::string& addr, bool reuse) -> put_res {
+      CAF_LOG_TRACE("");
+      return put_udp(port, whom, sigs, addr.c_str(), reuse);
+    },
+    [=](contact_atom, std::string& hostname, uint16_t port) -> get_res {
+      CAF_LOG_TRACE(CAF_ARG(hostname) << CAF_ARG(port));
+      return connect_to(endpoint{std::move(hostname), port}, true);
     },
     [=](unpublish_atom atm, actor_addr addr, uint16_t p) -> del_res {
       CAF_LOG_TRACE("");
@@ -178,6 +158,12 @@ auto middleman_actor_impl::make_behavior() -> behavior_type {
       delegate(broker_, atm, std::move(nid));
       return {};
     },
+    [=](get_atom atm, pending_atom pa,
+        node_id nid) -> delegated<uint64_t, bool> {
+      CAF_LOG_TRACE("");
+      delegate(broker_, atm, pa, std::move(nid));
+      return {};
+    },
   };
 }
 
@@ -195,6 +181,14 @@ middleman_actor_impl::put(uint16_t port, strong_actor_ptr& whom, mpi_set& sigs,
     return std::move(res.error());
   auto& ptr = *res;
   actual_port = ptr->port();
+  if (!local_socket_path(actual_port).empty()) {
+    // Peers on the same host can still use TCP, hence errors are not fatal.
+    if (auto local = open_local(actual_port))
+      anon_send(broker_, publish_atom_v, std::move(*local), actual_port, whom,
+                sigs);
+    else
+      CAF_LOG_WARNING("unable to open local socket:" << local.error());
+  }
   anon_send(broker_, publish_atom_v, std::move(ptr), actual_port,
             std::move(whom), std::move(sigs));
   return actual_port;
@@ -219,6 +213,74 @@ middleman_actor_impl::put_udp(uint16_t port, strong_actor_ptr& whom,
   return actual_port;
 }
 
+middleman_actor_impl::get_res
+middleman_actor_impl::connect_to(endpoint key, bool udp) {
+  CAF_LOG_TRACE(CAF_ARG(key) << CAF_ARG(udp));
+  auto rp = make_response_promise();
+  // respond immediately if endpoint is cached
+  auto x = udp ? cached_udp(key) : cached_tcp(key);
+  if (x) {
+    CAF_LOG_DEBUG("found cached entry" << CAF_ARG(*x));
+    rp.deliver(get<0>(*x), get<1>(*x), get<2>(*x));
+    return get_delegated{};
+  }
+  // attach this promise to a pending request if possible
+  auto rps = pending(key, udp);
+  if (rps) {
+    CAF_LOG_DEBUG("attach to pending request");
+    rps->emplace_back(std::move(rp));
+    return get_delegated{};
+  }
+  // connect to endpoint and initiate handhsake etc.
+  auto port = key.second;
+  auto on_result = [=](node_id& nid, strong_actor_ptr& addr, mpi_set& sigs) {
+    auto& pending = udp ? pending_udp_ : pending_;
+    auto i = pending.find(key);
+    if (i == pending.end())
+      return;
+    if (nid && addr) {
+      monitor(addr);
+      auto& cache = udp ? cached_udp_ : cached_tcp_;
+      cache.emplace(key, std::make_tuple(nid, addr, sigs));
+    }
+    auto res = make_message(std::move(nid), std::move(addr), std::move(sigs));
+    for (auto& promise : i->second)
+      promise.deliver(res);
+    pending.erase(i);
+  };
+  auto on_error = [=](error& err) {
+    auto& pending = udp ? pending_udp_ : pending_;
+    auto i = pending.find(key);
+    if (i == pending.end())
+      return;
+    for (auto& promise : i->second)
+      promise.deliver(err);
+    pending.erase(i);
+  };
+  if (udp) {
+    auto r = contact(key.first, port);
+    if (!r) {
+      rp.deliver(std::move(r.error()));
+      return get_delegated{};
+    }
+    std::vector<response_promise> tmp{std::move(rp)};
+    pending_udp_.emplace(key, std::move(tmp));
+    request(broker_, infinite, contact_atom_v, std::move(*r), port)
+      .then(on_result, on_error);
+  } else {
+    auto r = connect(key.first, port);
+    if (!r) {
+      rp.deliver(std::move(r.error()));
+      return get_delegated{};
+    }
+    std::vector<response_promise> tmp{std::move(rp)};
+    pending_.emplace(key, std::move(tmp));
+    request(broker_, infinite, connect_atom_v, std::move(*r), port)
+      .then(on_result, on_error);
+  }
+  return get_delegated{};
+}
+
 optional<middleman_actor_impl::endpoint_data&>
 middleman_actor_impl::cached_tcp(const endpoint& ep) {
   auto i = cached_tcp_.find(ep);
@@ -236,16 +298,38 @@ middleman_actor_impl::cached_udp(const endpoint& ep) {
 }
 
 optional<std::vector<response_promise>&>
-middleman_actor_impl::pending(const endpoint& ep) {
-  auto i = pending_.find(ep);
-  if (i != pending_.end())
+middleman_actor_impl::pending(const endpoint& ep, bool udp) {
+  auto& xs = udp ? pending_udp_ : pending_;
+  auto i = xs.find(ep);
+  if (i != xs.end())
     return i->second;
   return none;
 }
 
+std::string middleman_actor_impl::local_socket_path(uint16_t port) {
+  std::string result = get_or(system().config(), "middleman.local-socket-dir",
+                              defaults::middleman::local_socket_dir);
+  if (result.empty())
+    return result;
+  if (result.back() != '/')
+    result += '/';
+  result += "caf-";
+  result += std::to_string(port);
+  result += ".sock";
+  return result;
+}
+
 expected<scribe_ptr>
 middleman_actor_impl::connect(const std::string& host, uint16_t port) {
-  return system().middleman().backend().new_tcp_scribe(host, port);
+  auto& backend = system().middleman().backend();
+  auto path = local_socket_path(port);
+  if (!path.empty() && is_local_host(host)) {
+    if (auto res = backend.new_local_scribe(path))
+      return res;
+    CAF_LOG_DEBUG("no local socket for" << CAF_ARG(port)
+                                        << ", fall back to TCP");
+  }
+  return backend.new_tcp_scribe(host, port);
 }
 
 expected<datagram_servant_ptr>
@@ -258,6 +342,11 @@ middleman_actor_impl::open(uint16_t port, const char* addr, bool reuse) {
   return system().middleman().backend().new_tcp_doorman(port, addr, reuse);
 }
 
+expected<doorman_ptr> middleman_actor_impl::open_local(uint16_t port) {
+  return system().middleman().backend().new_local_doorman(
+    local_socket_path(port), port);
+}
+
 expected<datagram_servant_ptr>
 middleman_actor_impl::open_udp(uint16_t port, const char* addr, bool reuse) {
   return system().middleman().backend().new_local_udp_endpoint(port, addr,
@@ -0,0 +1,51 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/network/byte_buffer_pool.hpp"
+
+namespace caf::io::network {
+
+byte_buffer_pool::byte_buffer_pool(size_t max_size, size_t max_capacity)
+  : max_size_(max_size), max_capacity_(max_capacity) {
+  buffers_.reserve(max_size);
+}
+
+byte_buffer byte_buffer_pool::get() {
+  byte_buffer result;
+  if (!buffers_.empty()) {
+    result.swap(buffers_.back());
+    buffers_.pop_back();
+  }
+  return result;
+}
+
+byte_buffer byte_buffer_pool::get(size_t min_capacity) {
+  auto result = get();
+  result.reserve(min_capacity);
+  return result;
+}
+
+void byte_buffer_pool::put(byte_buffer&& buf) {
+  if (buffers_.size() >= max_size_ || buf.capacity() == 0
+      || buf.capacity() > max_capacity_)
+    return;
+  buf.clear();
+  buffers_.emplace_back(std::move(buf));
+}
+
+} // namespace caf::io::network
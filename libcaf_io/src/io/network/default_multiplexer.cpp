@@ -18,6 +18,7 @@
 
 #include "caf/io/network/default_multiplexer.hpp"
 
+#include <algorithm>
 #include <utility>
 
 #include "caf/actor_system_config.hpp"
@@ -31,6 +32,8 @@
 #include "caf/io/network/datagram_servant_impl.hpp"
 #include "caf/io/network/doorman_impl.hpp"
 #include "caf/io/network/interfaces.hpp"
+#include "caf/io/network/io_uring_context.hpp"
+#include "caf/io/network/local_doorman_impl.hpp"
 #include "caf/io/network/protocol.hpp"
 #include "caf/io/network/scribe_impl.hpp"
 
@@ -69,6 +72,7 @@
 #  include <netinet/ip.h>
 #  include <netinet/tcp.h>
 #  include <sys/socket.h>
+#  include <sys/un.h>
 #  include <unistd.h>
 #  ifdef CAF_POLL_MULTIPLEXER
 #    include <poll.h>
@@ -145,7 +149,15 @@ const event_mask_type output_mask = EPOLLOUT;
 #ifdef CAF_EPOLL_MULTIPLEXER
 
 // In this implementation, shadow_ is the number of sockets we have
-// registered to epoll.
+// registered to epoll (or io_uring).
+
+namespace {
+
+// Number of submission queue entries for the io_uring backend. The kernel
+// sizes the completion queue to twice this value.
+constexpr unsigned io_uring_entries = 4096;
+
+} // namespace
 
 default_multiplexer::default_multiplexer(actor_system* sys)
   : multiplexer(sys),
@@ -153,8 +165,37 @@ default_multiplexer::default_multiplexer(actor_system* sys)
     shadow_(1),
     pipe_reader_(*this),
     servant_ids_(0),
-    max_throughput_(0) {
+    max_throughput_(0),
+    mode_(backend_mode::level_triggered) {
   init();
+  auto backend = get_or(system().config(), "middleman.network-backend",
+                        defaults::middleman::network_backend);
+  if (backend == "epoll-et") {
+    mode_ = backend_mode::edge_triggered;
+  } else if (backend == "io-uring") {
+    uring_.reset(new io_uring_context);
+    if (uring_->init(io_uring_entries)) {
+      mode_ = backend_mode::io_uring;
+    } else {
+      CAF_LOG_WARNING("io_uring not available, fall back to epoll");
+      uring_.reset();
+    }
+  }
+  pipe_ = create_pipe();
+  pipe_reader_.init(pipe_.first);
+  if (mode_ != backend_mode::level_triggered) {
+    // Both backends look up handlers by file descriptor, including the pipe.
+    pipe_reader_.eventbf(input_mask);
+    entry(pipe_reader_.fd()).ptr = &pipe_reader_;
+  }
+  if (mode_ == backend_mode::edge_triggered) {
+    // The pipe reader drains the pipe until it would block.
+    nonblocking(pipe_.first, true);
+  }
+  if (mode_ == backend_mode::io_uring) {
+    arm(pipe_reader_.fd(), entry(pipe_reader_.fd()));
+    return;
+  }
   epollfd_ = epoll_create1(EPOLL_CLOEXEC);
   if (epollfd_ == -1) {
     CAF_LOG_ERROR("epoll_create1: " << strerror(errno));
@@ -162,10 +203,9 @@ default_multiplexer::default_multiplexer(actor_system* sys)
   }
   // handle at most 64 events at a time
   pollset_.resize(64);
-  pipe_ = create_pipe();
-  pipe_reader_.init(pipe_.first);
   epoll_event ee;
-  ee.events = input_mask;
+  ee.events = mode_ == backend_mode::edge_triggered ? input_mask | EPOLLET
+                                                    : input_mask;
   ee.data.ptr = &pipe_reader_;
   if (epoll_ctl(epollfd_, EPOLL_CTL_ADD, pipe_reader_.fd(), &ee) < 0) {
     CAF_LOG_ERROR("epoll_ctl: " << strerror(errno));
@@ -174,8 +214,13 @@ default_multiplexer::default_multiplexer(actor_system* sys)
 }
 
 bool default_multiplexer::poll_once_impl(bool block) {
+  if (mode_ == backend_mode::io_uring)
+    return poll_io_uring(block);
   CAF_LOG_TRACE("epoll()-based multiplexer");
   CAF_ASSERT(block == false || internally_posted_.empty());
+  // Sockets with pending data make progress without waiting for new events.
+  if (!ready_.empty())
+    block = false;
   // Keep running in case of `EINTR`.
   for (;;) {
     int presult = epoll_wait(epollfd_, pollset_.data(),
@@ -195,20 +240,101 @@ bool default_multiplexer::poll_once_impl(bool block) {
         }
       }
     }
-    if (presult == 0)
+    // Take the ready list before handling new events, so that each handler
+    // runs at most twice per loop iteration.
+    ready_.swap(ready_cache_);
+    if (presult == 0 && ready_cache_.empty())
       return false;
     auto iter = pollset_.begin();
     auto last = iter + presult;
     for (; iter != last; ++iter) {
       auto ptr = reinterpret_cast<event_handler*>(iter->data.ptr);
       auto fd = ptr ? ptr->fd() : pipe_.first;
-      handle_socket_event(fd, static_cast<int>(iter->events), ptr);
+      auto mask = static_cast<int>(iter->events);
+      if (mode_ == backend_mode::edge_triggered) {
+        // Edge-triggered sockets report all events, including events that
+        // the handler currently has no interest in.
+        mask &= ptr->eventbf() | error_mask;
+        if (mask == 0)
+          continue;
+        handle_socket_event(fd, mask, ptr);
+        add_if_pending(fd, ptr);
+      } else {
+        handle_socket_event(fd, mask, ptr);
+      }
+    }
+    for (auto fd : ready_cache_) {
+      auto& x = entry(fd);
+      x.ready = false;
+      if (x.ptr == nullptr)
+        continue;
+      auto ptr = x.ptr;
+      handle_socket_event(fd, ptr->eventbf() & (input_mask | output_mask),
+                          ptr);
+      add_if_pending(fd, ptr);
     }
+    ready_cache_.clear();
     handle_internal_events();
     return true;
   }
 }
 
+bool default_multiplexer::poll_io_uring(bool block) {
+  CAF_LOG_TRACE("io_uring-based multiplexer");
+  CAF_ASSERT(block == false || internally_posted_.empty());
+  // Submits all interest changes of the previous iteration and waits for new
+  // events with a single system call.
+  uring_->submit_and_consume(block, [&](uint64_t user_data, int32_t res) {
+    auto fd = static_cast<native_socket>(user_data & 0xFFFFFFFFu);
+    auto generation = static_cast<uint32_t>(user_data >> 32);
+    auto& x = entry(fd);
+    if (x.ptr == nullptr || x.generation != generation) {
+      // Completion of a cancelled request.
+      return;
+    }
+    x.armed = 0;
+    if (res < 0) {
+      switch (-res) {
+        case EAGAIN:
+        case ECANCELED:
+        case EINTR:
+        case ENOMEM:
+          // Transient failure: report no event and re-arm the socket below,
+          // just like the epoll loop retries after `EINTR`.
+          CAF_LOG_DEBUG("poll request interrupted:" << CAF_ARG(fd)
+                                                    << strerror(-res));
+          res = 0;
+          break;
+        default:
+          // Let the event handler deal with the broken socket.
+          CAF_LOG_ERROR("poll request failed:" << CAF_ARG(fd)
+                                               << strerror(-res));
+          res = EPOLLERR;
+      }
+    }
+    polled_.emplace_back(event{fd, res, x.ptr});
+  });
+  CAF_LOG_DEBUG("io_uring on" << shadow_ << "sockets reported"
+                              << polled_.size() << "event(s)");
+  if (polled_.empty())
+    return false;
+  for (auto& e : polled_) {
+    // Interest may have changed since submitting the request.
+    auto mask = e.mask & (e.ptr->eventbf() | error_mask);
+    if (mask != 0)
+      handle_socket_event(e.fd, mask, e.ptr);
+  }
+  handle_internal_events();
+  // Poll requests are one-shot, so we need to re-arm them.
+  for (auto& e : polled_) {
+    auto& x = entry(e.fd);
+    if (x.ptr != nullptr && x.armed == 0)
+      arm(e.fd, x);
+  }
+  polled_.clear();
+  return true;
+}
+
 void default_multiplexer::run() {
   CAF_LOG_TRACE("epoll()-based multiplexer");
   while (shadow_ > 0)
@@ -228,45 +354,90 @@ void default_multiplexer::handle(const default_multiplexer::event& e) {
   if (e.ptr) {
     e.ptr->eventbf(e.mask);
   }
-  epoll_event ee;
-  ee.events = static_cast<uint32_t>(e.mask);
-  ee.data.ptr = e.ptr;
-  int op;
-  if (e.mask == 0) {
-    CAF_LOG_DEBUG("attempt to remove socket " << CAF_ARG(e.fd)
-                                              << " from epoll");
-    op = EPOLL_CTL_DEL;
-    --shadow_;
-  } else if (old == 0) {
-    CAF_LOG_DEBUG("attempt to add socket " << CAF_ARG(e.fd) << " to epoll");
-    op = EPOLL_CTL_ADD;
-    ++shadow_;
+  if (mode_ == backend_mode::io_uring) {
+    auto& x = entry(e.fd);
+    if (e.mask == 0) {
+      CAF_LOG_DEBUG("remove socket " << CAF_ARG(e.fd) << " from io_uring");
+      if (x.armed != 0)
+        uring_->poll_remove(user_data(e.fd, x));
+      ++x.generation;
+      x.armed = 0;
+      x.ptr = nullptr;
+      --shadow_;
+    } else if (old == 0) {
+      CAF_LOG_DEBUG("add socket " << CAF_ARG(e.fd) << " to io_uring");
+      x.ptr = e.ptr;
+      ++shadow_;
+      arm(e.fd, x);
+    } else if (x.armed == 0) {
+      // The socket is currently handling an event and we re-arm it afterwards.
+    } else if ((e.mask & ~x.armed) != 0) {
+      // Replace the pending request, since it doesn't cover the new interest.
+      uring_->poll_remove(user_data(e.fd, x));
+      ++x.generation;
+      arm(e.fd, x);
+    }
+    // Otherwise, the pending request is a superset of the new interest and we
+    // filter unwanted events when handling them.
   } else {
-    CAF_LOG_DEBUG("modify epoll event mask for socket "
-                  << CAF_ARG(e.fd) << ": " << CAF_ARG(old) << " -> "
-                  << CAF_ARG(e.mask));
-    op = EPOLL_CTL_MOD;
-  }
-  if (epoll_ctl(epollfd_, op, e.fd, &ee) < 0) {
-    switch (last_socket_error()) {
-      // supplied file descriptor is already registered
-      case EEXIST:
-        CAF_LOG_ERROR("file descriptor registered twice");
-        --shadow_;
-        break;
-      // op was EPOLL_CTL_MOD or EPOLL_CTL_DEL,
-      // and fd is not registered with this epoll instance.
-      case ENOENT:
-        CAF_LOG_ERROR("cannot delete file descriptor "
-                      "because it isn't registered");
-        if (e.mask == 0) {
-          ++shadow_;
-        }
-        break;
-      default:
-        CAF_LOG_ERROR(strerror(errno));
-        perror("epoll_ctl() failed");
-        CAF_CRITICAL("epoll_ctl() failed");
+    epoll_event ee;
+    ee.data.ptr = e.ptr;
+    int op;
+    if (mode_ == backend_mode::edge_triggered) {
+      // Each socket is registered once for all events. Interest changes only
+      // require a system call when adding or removing the socket.
+      ee.events = static_cast<uint32_t>(input_mask | output_mask | EPOLLET);
+      if (e.mask == 0) {
+        op = EPOLL_CTL_DEL;
+        entry(e.fd).ptr = nullptr;
+      } else if (old == 0) {
+        op = EPOLL_CTL_ADD;
+        entry(e.fd).ptr = e.ptr;
+      } else {
+        // The socket may have become ready before adding the new interest, in
+        // which case epoll does not report it again.
+        if ((e.mask & ~old) != 0)
+          add_ready(e.fd);
+        op = 0;
+      }
+    } else {
+      ee.events = static_cast<uint32_t>(e.mask);
+      op = e.mask == 0 ? EPOLL_CTL_DEL
+                       : (old == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+    }
+    if (op == EPOLL_CTL_DEL) {
+      CAF_LOG_DEBUG("attempt to remove socket " << CAF_ARG(e.fd)
+                                                << " from epoll");
+      --shadow_;
+    } else if (op == EPOLL_CTL_ADD) {
+      CAF_LOG_DEBUG("attempt to add socket " << CAF_ARG(e.fd) << " to epoll");
+      ++shadow_;
+    } else if (op == EPOLL_CTL_MOD) {
+      CAF_LOG_DEBUG("modify epoll event mask for socket "
+                    << CAF_ARG(e.fd) << ": " << CAF_ARG(old) << " -> "
+                    << CAF_ARG(e.mask));
+    }
+    if (op != 0 && epoll_ctl(epollfd_, op, e.fd, &ee) < 0) {
+      switch (last_socket_error()) {
+        // supplied file descriptor is already registered
+        case EEXIST:
+          CAF_LOG_ERROR("file descriptor registered twice");
+          --shadow_;
+          break;
+        // op was EPOLL_CTL_MOD or EPOLL_CTL_DEL,
+        // and fd is not registered with this epoll instance.
+        case ENOENT:
+          CAF_LOG_ERROR("cannot delete file descriptor "
+                        "because it isn't registered");
+          if (e.mask == 0) {
+            ++shadow_;
+          }
+          break;
+        default:
+          CAF_LOG_ERROR(strerror(errno));
+          perror("epoll_ctl() failed");
+          CAF_CRITICAL("epoll_ctl() failed");
+      }
     }
   }
   if (e.ptr) {
@@ -284,6 +455,40 @@ size_t default_multiplexer::num_socket_handlers() const noexcept {
   return shadow_;
 }
 
+default_multiplexer::fd_entry& default_multiplexer::entry(native_socket fd) {
+  CAF_ASSERT(fd >= 0);
+  auto index = static_cast<size_t>(fd);
+  if (index >= fds_.size())
+    fds_.resize(std::max(index + 1, fds_.size() * 2));
+  return fds_[index];
+}
+
+uint64_t default_multiplexer::user_data(native_socket fd, const fd_entry& x) {
+  return (uint64_t{x.generation} << 32) | static_cast<uint32_t>(fd);
+}
+
+void default_multiplexer::arm(native_socket fd, fd_entry& x) {
+  CAF_ASSERT(x.ptr != nullptr);
+  x.armed = x.ptr->eventbf();
+  uring_->poll_add(fd, static_cast<uint32_t>(x.armed), user_data(fd, x));
+}
+
+void default_multiplexer::add_ready(native_socket fd) {
+  auto& x = entry(fd);
+  if (!x.ready) {
+    x.ready = true;
+    ready_.emplace_back(fd);
+  }
+}
+
+void default_multiplexer::add_if_pending(native_socket fd,
+                                         event_handler* ptr) {
+  auto bf = ptr->eventbf();
+  if (((bf & input_mask) != 0 && ptr->pending(operation::read))
+      || ((bf & output_mask) != 0 && ptr->pending(operation::write)))
+    add_ready(fd);
+}
+
 #else // CAF_EPOLL_MULTIPLEXER
 
 // Let's be honest: the API of poll() sucks. When dealing with 1000 sockets
@@ -611,6 +816,10 @@ bool default_multiplexer::poll_once(bool block) {
     poll_once_impl(false);
     return true;
   }
+  // Apply interest changes that happened outside of event handlers, e.g., a
+  // flush before the first poll. Otherwise we would wait for events on
+  // sockets that are not registered yet.
+  handle_internal_events();
   return poll_once_impl(block);
 }
 
@@ -694,6 +903,25 @@ default_multiplexer::new_tcp_doorman(uint16_t port, const char* in,
   return std::move(fd.error());
 }
 
+expected<scribe_ptr>
+default_multiplexer::new_local_scribe(const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+  auto fd = new_local_connection(path);
+  if (!fd)
+    return std::move(fd.error());
+  return make_counted<scribe_impl>(*this, *fd);
+}
+
+expected<doorman_ptr>
+default_multiplexer::new_local_doorman(const std::string& path,
+                                       uint16_t port) {
+  CAF_LOG_TRACE(CAF_ARG(path) << CAF_ARG(port));
+  auto fd = new_local_acceptor_impl(path);
+  if (!fd)
+    return std::move(fd.error());
+  return make_counted<local_doorman_impl>(*this, *fd, path, port);
+}
+
 datagram_servant_ptr
 default_multiplexer::new_datagram_servant(native_socket fd) {
   CAF_LOG_TRACE(CAF_ARG(fd));
@@ -797,6 +1025,108 @@ new_tcp_connection(const std::string& host, uint16_t port,
   return sguard.release();
 }
 
+#ifdef CAF_WINDOWS
+
+expected<native_socket> new_local_connection(const std::string& path) {
+  return make_error(sec::feature_disabled,
+                    "local sockets are not available on this platform", path);
+}
+
+expected<native_socket> new_local_acceptor_impl(const std::string& path) {
+  return make_error(sec::feature_disabled,
+                    "local sockets are not available on this platform", path);
+}
+
+#else // CAF_WINDOWS
+
+namespace {
+
+bool make_local_addr(sockaddr_un& sa, const std::string& path) {
+  if (path.empty() || path.size() >= sizeof(sa.sun_path))
+    return false;
+  memset(&sa, 0, sizeof(sockaddr_un));
+  sa.sun_family = AF_UNIX;
+  memcpy(sa.sun_path, path.c_str(), path.size());
+  return true;
+}
+
+// Removes the socket file at `sa` unless a process still listens on it.
+// Returns `false` if the path is in use or refers to something other than a
+// stale socket.
+bool remove_stale_socket(const sockaddr_un& sa) {
+  auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == invalid_native_socket)
+    return false;
+  detail::socket_guard sguard{fd};
+  // A full backlog of a live listener must not block us.
+  if (!nonblocking(fd, true))
+    return false;
+  if (connect(fd, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) == 0)
+    return false;
+  switch (errno) {
+    case ENOENT:
+      return true;
+    case ECONNREFUSED:
+      // Nobody listens on the socket, i.e., its owner did not shut down
+      // cleanly.
+      return unlink(sa.sun_path) == 0 || errno == ENOENT;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+expected<native_socket> new_local_connection(const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+  sockaddr_un sa;
+  if (!make_local_addr(sa, path))
+    return make_error(sec::cannot_connect_to_node, "invalid socket path",
+                      path);
+  int socktype = SOCK_STREAM;
+#  ifdef SOCK_CLOEXEC
+  socktype |= SOCK_CLOEXEC;
+#  endif
+  CALL_CFUN(fd, detail::cc_valid_socket, "socket",
+            socket(AF_UNIX, socktype, 0));
+  child_process_inherit(fd, false);
+  detail::socket_guard sguard{fd};
+  if (connect(fd, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) != 0) {
+    CAF_LOG_DEBUG("could not connect to:" << CAF_ARG(path));
+    return make_error(sec::cannot_connect_to_node, "connect failed", path);
+  }
+  CAF_LOG_INFO("successfully connected to local socket:" << CAF_ARG(path));
+  return sguard.release();
+}
+
+expected<native_socket> new_local_acceptor_impl(const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+  sockaddr_un sa;
+  if (!make_local_addr(sa, path))
+    return make_error(sec::cannot_open_port, "invalid socket path", path);
+  int socktype = SOCK_STREAM;
+#  ifdef SOCK_CLOEXEC
+  socktype |= SOCK_CLOEXEC;
+#  endif
+  CALL_CFUN(fd, detail::cc_valid_socket, "socket",
+            socket(AF_UNIX, socktype, 0));
+  child_process_inherit(fd, false);
+  detail::socket_guard sguard{fd};
+  // Multiple processes may share a TCP port, e.g., via `reuse_addr`, and
+  // processes in other network namespaces may use the same path. Hence, we
+  // only replace sockets that nobody listens on.
+  if (!remove_stale_socket(sa))
+    return make_error(sec::cannot_open_port, "socket path in use", path);
+  CALL_CFUN(res, detail::cc_zero, "bind",
+            bind(fd, reinterpret_cast<sockaddr*>(&sa),
+                 static_cast<socket_size_type>(sizeof(sa))));
+  CALL_CFUN(tmp, detail::cc_zero, "listen", listen(fd, SOMAXCONN));
+  CAF_LOG_DEBUG(CAF_ARG(fd));
+  return sguard.release();
+}
+
+#endif // CAF_WINDOWS
+
 template <class SockAddrType>
 expected<void> read_port(native_socket fd, SockAddrType& sa) {
   socket_size_type len = sizeof(SockAddrType);
@@ -823,7 +1153,8 @@ expected<void> set_inaddr_any(native_socket fd, sockaddr_in6& sa) {
 
 template <int Family, int SockType = SOCK_STREAM>
 expected<native_socket> new_ip_acceptor_impl(uint16_t port, const char* addr,
-                                             bool reuse_addr, bool any) {
+                                             bool reuse_addr, bool any,
+                                             bool reuse_port = false) {
   static_assert(Family == AF_INET || Family == AF_INET6, "invalid family");
   CAF_LOG_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
   int socktype = SockType;
@@ -841,6 +1172,18 @@ expected<native_socket> new_ip_acceptor_impl(uint16_t port, const char* addr,
                          reinterpret_cast<setsockopt_ptr>(&on),
                          static_cast<socket_size_type>(sizeof(on))));
   }
+  if (reuse_port) {
+#ifdef SO_REUSEPORT
+    int on = 1;
+    CALL_CFUN(tmp1, detail::cc_zero, "setsockopt",
+              setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+                         reinterpret_cast<setsockopt_ptr>(&on),
+                         static_cast<socket_size_type>(sizeof(on))));
+#else
+    return make_error(sec::cannot_open_port,
+                      "SO_REUSEPORT not available on this platform");
+#endif
+  }
   using sockaddr_type =
     typename std::conditional<Family == AF_INET, sockaddr_in,
                               sockaddr_in6>::type;
@@ -859,7 +1202,8 @@ expected<native_socket> new_ip_acceptor_impl(uint16_t port, const char* addr,
 }
 
 expected<native_socket>
-new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr) {
+new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr,
+                      bool reuse_port) {
   CAF_LOG_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
   auto addrs = interfaces::server_address(port, addr);
   auto addr_str = std::string{addr == nullptr ? "" : addr};
@@ -872,8 +1216,10 @@ new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr) {
     auto hostname = elem.first.c_str();
     auto p
       = elem.second == ipv4
-          ? new_ip_acceptor_impl<AF_INET>(port, hostname, reuse_addr, any)
-          : new_ip_acceptor_impl<AF_INET6>(port, hostname, reuse_addr, any);
+          ? new_ip_acceptor_impl<AF_INET>(port, hostname, reuse_addr, any,
+                                          reuse_port)
+          : new_ip_acceptor_impl<AF_INET6>(port, hostname, reuse_addr, any,
+                                           reuse_port);
     if (!p) {
       CAF_LOG_DEBUG(p.error());
       continue;
@@ -33,7 +33,7 @@ namespace caf::io::network {
 event_handler::event_handler(default_multiplexer& dm, native_socket sockfd)
   : fd_(sockfd),
     state_{true, false, false, false,
-           to_integer(receive_policy_flag::at_least)},
+           to_integer(receive_policy_flag::at_least), false, false},
     eventbf_(0),
     backend_(dm) {
   set_fd_flags();
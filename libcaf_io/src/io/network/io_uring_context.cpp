@@ -0,0 +1,241 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/network/io_uring_context.hpp"
+
+#ifdef CAF_LINUX
+
+#  include <algorithm>
+#  include <cerrno>
+#  include <cstdio>
+#  include <cstring>
+
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+#  include "caf/logger.hpp"
+
+// Added in Linux 5.8.
+#  ifndef IORING_SQ_CQ_OVERFLOW
+#    define IORING_SQ_CQ_OVERFLOW (1U << 1)
+#  endif
+
+namespace caf::io::network {
+
+namespace {
+
+unsigned* offset_ptr(void* base, uint32_t offset) {
+  return reinterpret_cast<unsigned*>(static_cast<char*>(base) + offset);
+}
+
+unsigned load_acquire(const unsigned* ptr) {
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void store_release(unsigned* ptr, unsigned value) {
+  __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+} // namespace
+
+io_uring_context::io_uring_context()
+  : fd_(-1),
+    sq_ring_ptr_(MAP_FAILED),
+    sq_ring_size_(0),
+    cq_ring_ptr_(MAP_FAILED),
+    cq_ring_size_(0),
+    sqes_(nullptr),
+    sqes_size_(0),
+    sq_head_(nullptr),
+    sq_tail_(nullptr),
+    sq_array_(nullptr),
+    sq_flags_(nullptr),
+    sq_mask_(0),
+    sq_entries_(0),
+    cq_head_(nullptr),
+    cq_tail_(nullptr),
+    cqes_(nullptr),
+    cq_mask_(0),
+    pending_(0) {
+  // nop
+}
+
+io_uring_context::~io_uring_context() {
+  if (sqes_ != nullptr)
+    munmap(sqes_, sqes_size_);
+  if (cq_ring_ptr_ != MAP_FAILED && cq_ring_ptr_ != sq_ring_ptr_)
+    munmap(cq_ring_ptr_, cq_ring_size_);
+  if (sq_ring_ptr_ != MAP_FAILED)
+    munmap(sq_ring_ptr_, sq_ring_size_);
+  if (fd_ != -1)
+    close(fd_);
+}
+
+bool io_uring_context::init(unsigned entries) {
+  CAF_LOG_TRACE(CAF_ARG(entries));
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  auto fd = syscall(__NR_io_uring_setup, entries, &params);
+  if (fd < 0) {
+    CAF_LOG_DEBUG("io_uring_setup failed:" << strerror(errno));
+    return false;
+  }
+  fd_ = static_cast<int>(fd);
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes
+                  + params.cq_entries * sizeof(io_uring_cqe);
+  auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  sq_ring_ptr_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ptr_ == MAP_FAILED) {
+    CAF_LOG_DEBUG("mmap failed for the submission ring:" << strerror(errno));
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ptr_ = sq_ring_ptr_;
+  } else {
+    cq_ring_ptr_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ptr_ == MAP_FAILED) {
+      CAF_LOG_DEBUG("mmap failed for the completion ring:" << strerror(errno));
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  auto sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    CAF_LOG_DEBUG("mmap failed for the submission entries:" << strerror(errno));
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+  sq_head_ = offset_ptr(sq_ring_ptr_, params.sq_off.head);
+  sq_tail_ = offset_ptr(sq_ring_ptr_, params.sq_off.tail);
+  sq_array_ = offset_ptr(sq_ring_ptr_, params.sq_off.array);
+  sq_flags_ = offset_ptr(sq_ring_ptr_, params.sq_off.flags);
+  sq_mask_ = *offset_ptr(sq_ring_ptr_, params.sq_off.ring_mask);
+  sq_entries_ = *offset_ptr(sq_ring_ptr_, params.sq_off.ring_entries);
+  cq_head_ = offset_ptr(cq_ring_ptr_, params.cq_off.head);
+  cq_tail_ = offset_ptr(cq_ring_ptr_, params.cq_off.tail);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cq_ring_ptr_)
+                                          + params.cq_off.cqes);
+  cq_mask_ = *offset_ptr(cq_ring_ptr_, params.cq_off.ring_mask);
+  return true;
+}
+
+void io_uring_context::poll_add(native_socket fd, uint32_t mask,
+                                uint64_t user_data) {
+  auto sqe = next_sqe();
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+#  if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  mask = (mask << 16) | (mask >> 16);
+#  endif
+  sqe->poll32_events = mask;
+  sqe->user_data = user_data;
+}
+
+void io_uring_context::poll_remove(uint64_t user_data) {
+  auto sqe = next_sqe();
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = user_data;
+  sqe->user_data = ignored_user_data;
+}
+
+io_uring_sqe* io_uring_context::next_sqe() {
+  auto tail = *sq_tail_;
+  // Hand queued entries to the kernel if the ring runs full. The kernel
+  // refuses new entries while the completion ring is full, so we move
+  // completions to the backlog in order to make room.
+  while (tail - load_acquire(sq_head_) >= sq_entries_) {
+    if (!submit(false) && reap() == 0) {
+      CAF_LOG_ERROR("io_uring refuses submissions without pending completions");
+      CAF_CRITICAL("io_uring_enter() failed");
+    }
+  }
+  auto index = tail & sq_mask_;
+  auto sqe = sqes_ + index;
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  sq_array_[index] = index;
+  store_release(sq_tail_, tail + 1);
+  ++pending_;
+  return sqe;
+}
+
+bool io_uring_context::submit(bool block) {
+  auto overflow = overflowed();
+  if (pending_ == 0 && !block && !overflow)
+    return true;
+  auto result = true;
+  auto flags = block || overflow ? IORING_ENTER_GETEVENTS : 0u;
+  auto res = syscall(__NR_io_uring_enter, fd_, pending_, block ? 1u : 0u,
+                     flags, nullptr, 0);
+  if (res < 0) {
+    switch (errno) {
+      case EINTR:
+        // A signal interrupted the wait. Our caller simply tries again.
+        break;
+      case EAGAIN:
+      case EBUSY:
+        // The completion ring is full. Consuming completions makes room.
+        result = false;
+        break;
+      default:
+        perror("io_uring_enter() failed");
+        CAF_CRITICAL("io_uring_enter() failed");
+    }
+  }
+  pending_ = *sq_tail_ - load_acquire(sq_head_);
+  return result;
+}
+
+bool io_uring_context::overflowed() const noexcept {
+  return (load_acquire(sq_flags_) & IORING_SQ_CQ_OVERFLOW) != 0;
+}
+
+size_t io_uring_context::reap() {
+  size_t result = 0;
+  uint64_t user_data;
+  int32_t res;
+  while (next_completion(user_data, res)) {
+    ++result;
+    if (user_data != ignored_user_data)
+      backlog_.emplace_back(user_data, res);
+  }
+  return result;
+}
+
+bool io_uring_context::next_completion(uint64_t& user_data, int32_t& res) {
+  auto head = *cq_head_;
+  if (head == load_acquire(cq_tail_))
+    return false;
+  auto& cqe = cqes_[head & cq_mask_];
+  user_data = cqe.user_data;
+  res = cqe.res;
+  store_release(cq_head_, head + 1);
+  return true;
+}
+
+} // namespace caf::io::network
+
+#endif // CAF_LINUX
@@ -19,10 +19,39 @@
 #include "caf/io/network/multiplexer.hpp"
 #include "caf/io/network/default_multiplexer.hpp" // default singleton
 
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+#include "caf/defaults.hpp"
+#include "caf/io/doorman.hpp"
+#include "caf/io/scribe.hpp"
+#include "caf/sec.hpp"
+
 namespace caf::io::network {
 
+namespace {
+
+size_t get_or_default(actor_system* sys, string_view key, size_t fallback) {
+  if (sys == nullptr)
+    return fallback;
+  return get_or(sys->config(), key, fallback);
+}
+
+size_t buffer_pool_size(actor_system* sys) {
+  return get_or_default(sys, "middleman.buffer-pool-size",
+                        defaults::middleman::buffer_pool_size);
+}
+
+size_t buffer_pool_max_capacity(actor_system* sys) {
+  return get_or_default(sys, "middleman.buffer-pool-max-capacity",
+                        defaults::middleman::buffer_pool_max_capacity);
+}
+
+} // namespace
+
 multiplexer::multiplexer(actor_system* sys)
-  : execution_unit(sys), tid_(std::this_thread::get_id()) {
+  : execution_unit(sys),
+    tid_(std::this_thread::get_id()),
+    buffer_pool_(buffer_pool_size(sys), buffer_pool_max_capacity(sys)) {
   // nop
 }
 
@@ -31,6 +60,15 @@ multiplexer_ptr multiplexer::make(actor_system& sys) {
   return multiplexer_ptr{new default_multiplexer(&sys)};
 }
 
+expected<scribe_ptr> multiplexer::new_local_scribe(const std::string&) {
+  return sec::feature_disabled;
+}
+
+expected<doorman_ptr>
+multiplexer::new_local_doorman(const std::string&, uint16_t) {
+  return sec::feature_disabled;
+}
+
 multiplexer_backend* multiplexer::pimpl() {
   return nullptr;
 }
@@ -412,9 +412,13 @@ expected<string> local_addr_of_fd(native_socket fd) {
 expected<uint16_t> local_port_of_fd(native_socket fd) {
   sockaddr_storage st;
   socket_size_type st_len = sizeof(st);
-  CALL_CFUN(tmp, detail::cc_zero, "getsockname",
-            getsockname(fd, reinterpret_cast<sockaddr*>(&st), &st_len));
-  return ntohs(port_of(reinterpret_cast<sockaddr&>(st)));
+  sockaddr* sa = reinterpret_cast<sockaddr*>(&st);
+  CALL_CFUN(tmp, detail::cc_zero, "getsockname", getsockname(fd, sa, &st_len));
+  // Unix domain sockets have no port.
+  if (sa->sa_family != AF_INET && sa->sa_family != AF_INET6)
+    return make_error(sec::invalid_protocol_family, "local_port_of_fd",
+                      sa->sa_family);
+  return ntohs(port_of(*sa));
 }
 
 expected<string> remote_addr_of_fd(native_socket fd) {
@@ -441,9 +445,13 @@ expected<string> remote_addr_of_fd(native_socket fd) {
 expected<uint16_t> remote_port_of_fd(native_socket fd) {
   sockaddr_storage st;
   socket_size_type st_len = sizeof(st);
-  CALL_CFUN(tmp, detail::cc_zero, "getpeername",
-            getpeername(fd, reinterpret_cast<sockaddr*>(&st), &st_len));
-  return ntohs(port_of(reinterpret_cast<sockaddr&>(st)));
+  sockaddr* sa = reinterpret_cast<sockaddr*>(&st);
+  CALL_CFUN(tmp, detail::cc_zero, "getpeername", getpeername(fd, sa, &st_len));
+  // Unix domain sockets have no port.
+  if (sa->sa_family != AF_INET && sa->sa_family != AF_INET6)
+    return make_error(sec::invalid_protocol_family, "remote_port_of_fd",
+                      sa->sa_family);
+  return ntohs(port_of(*sa));
 }
 
 // -- shutdown function family -------------------------------------------------
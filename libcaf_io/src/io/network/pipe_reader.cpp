@@ -63,6 +63,7 @@ void pipe_reader::handle_event(operation op) {
   CAF_LOG_TRACE(CAF_ARG(op));
   if (op == operation::read) {
     auto ptr = try_read_next();
+    state_.read_pending = ptr != nullptr;
     if (ptr != nullptr)
       backend().resume({ptr, false});
   }
@@ -0,0 +1,519 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/network/reliable_channel.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace caf::io::network {
+
+namespace {
+
+template <class T>
+void put(byte_buffer& buf, T x) {
+  for (size_t i = sizeof(T); i > 0; --i)
+    buf.emplace_back(static_cast<byte>((x >> ((i - 1) * 8)) & 0xFF));
+}
+
+template <class T>
+bool get(const byte*& first, const byte* last, T& x) {
+  if (static_cast<size_t>(last - first) < sizeof(T))
+    return false;
+  x = 0;
+  for (size_t i = 0; i < sizeof(T); ++i)
+    x = static_cast<T>((x << 8) | static_cast<uint8_t>(*first++));
+  return true;
+}
+
+} // namespace
+
+reliable_channel::reliable_channel(uint32_t session)
+  : reliable_channel(session, 0) {
+  // nop
+}
+
+reliable_channel::reliable_channel(uint32_t session, uint64_t first)
+  : session_(session),
+    first_(first),
+    next_pkt_(first),
+    cwnd_(initial_window * max_datagram_size),
+    ssthresh_(std::numeric_limits<size_t>::max()),
+    recovery_start_(time_point::min()) {
+  // nop
+}
+
+bool reliable_channel::is_packet(const void* data, size_t size) noexcept {
+  auto first = static_cast<const byte*>(data);
+  return size >= 5 && static_cast<uint8_t>(*first) <= close_packet;
+}
+
+bool reliable_channel::accepts(const void* data, size_t size) const noexcept {
+  if (!is_packet(data, size))
+    return false;
+  if (!has_peer_session_)
+    return true;
+  auto first = static_cast<const byte*>(data) + 1;
+  uint32_t session = 0;
+  return get(first, first + sizeof(session), session)
+         && session == peer_session_;
+}
+
+span<const byte> reliable_channel::initial_frame(const void* data,
+                                                 size_t size) noexcept {
+  auto first = static_cast<const byte*>(data);
+  auto last = first + size;
+  uint8_t type = 0;
+  uint32_t session = 0;
+  uint64_t pkt = 0;
+  uint16_t stream_id = 0;
+  uint64_t seq = 0;
+  uint16_t frag = 0;
+  uint16_t frags = 0;
+  if (!get(first, last, type) || type != data_packet
+      || !get(first, last, session) || !get(first, last, pkt)
+      || !get(first, last, stream_id) || !get(first, last, seq)
+      || !get(first, last, frag) || !get(first, last, frags) || stream_id != 0
+      || seq != 0 || frag != 0 || frags != 1 || first == last)
+    return {};
+  return {first, static_cast<size_t>(last - first)};
+}
+
+// -- sending ------------------------------------------------------------------
+
+bool reliable_channel::send(uint16_t stream, const void* data, size_t size) {
+  if (closing_ || stream >= max_streams || size == 0 || size > max_frame_size)
+    return false;
+  auto frags = (size + max_chunk_size - 1) / max_chunk_size;
+  auto first = static_cast<const byte*>(data);
+  auto seq = next_seq_.emplace(stream, first_).first->second++;
+  for (size_t i = 0; i < frags; ++i) {
+    auto offset = i * max_chunk_size;
+    auto len = std::min(max_chunk_size, size - offset);
+    queue_.emplace_back(chunk{stream, seq, static_cast<uint16_t>(i),
+                              static_cast<uint16_t>(frags),
+                              byte_buffer(first + offset,
+                                          first + offset + len)});
+  }
+  queued_bytes_ += size;
+  unacked_[stream][seq] = frags;
+  return true;
+}
+
+void reliable_channel::close() {
+  closing_ = true;
+}
+
+void reliable_channel::write_ack(const datagram_consumer& f) {
+  unacked_packets_ = 0;
+  ack_deadline_ = time_point::max();
+  if (received_.empty())
+    return;
+  byte_buffer buf;
+  buf.reserve(packet_header_size + received_.size() * 16);
+  put(buf, static_cast<uint8_t>(ack_packet));
+  put(buf, session_);
+  put(buf, static_cast<uint8_t>(received_.size()));
+  for (auto& range : received_) {
+    put(buf, range.second);
+    put(buf, range.first);
+  }
+  f(buf);
+}
+
+void reliable_channel::write_close(const datagram_consumer& f) {
+  // Acknowledge everything we received before leaving.
+  if (!received_.empty())
+    write_ack(f);
+  byte_buffer buf;
+  put(buf, static_cast<uint8_t>(close_packet));
+  put(buf, session_);
+  f(buf);
+  close_sent_ = true;
+}
+
+void reliable_channel::write_chunk(time_point now, chunk& x,
+                                   const datagram_consumer& f) {
+  auto pkt = next_pkt_++;
+  byte_buffer buf;
+  buf.reserve(packet_header_size + chunk_header_size + x.data.size());
+  put(buf, static_cast<uint8_t>(data_packet));
+  put(buf, session_);
+  put(buf, pkt);
+  put(buf, x.stream);
+  put(buf, x.seq);
+  put(buf, x.frag);
+  put(buf, x.frags);
+  buf.insert(buf.end(), x.data.begin(), x.data.end());
+  auto size = buf.size();
+  f(buf);
+  queued_bytes_ -= x.data.size();
+  bytes_in_flight_ += size;
+  last_send_ = now;
+  // Allow short bursts after idle periods, but pace sending otherwise.
+  auto interval = pacing_interval(size);
+  next_send_time_ = std::max(next_send_time_, now - 4 * interval) + interval;
+  sent_.emplace(pkt, sent_packet{std::move(x), now, size});
+}
+
+bool reliable_channel::can_send(time_point now, const chunk& x) const
+  noexcept {
+  auto size = packet_header_size + chunk_header_size + x.data.size();
+  if (bytes_in_flight_ > 0 && bytes_in_flight_ + size > cwnd_)
+    return false;
+  return next_send_time_ <= now;
+}
+
+bool reliable_channel::in_window(const chunk& x) const noexcept {
+  // All frames before the first unacknowledged frame of a stream reached the
+  // receiver, i.e., its window starts at this frame or later.
+  auto base = [this](uint16_t stream) -> uint64_t {
+    auto i = unacked_.find(stream);
+    if (i != unacked_.end() && !i->second.empty())
+      return i->second.begin()->first;
+    auto j = next_seq_.find(stream);
+    return j != next_seq_.end() ? j->second : first_;
+  };
+  // Receivers hold back all other streams until the first control frame
+  // arrived. Hence, their window may still start at the first frame.
+  if (x.stream != 0 && base(0) == first_)
+    return x.seq - first_ < receive_window;
+  return x.seq - base(x.stream) < receive_window;
+}
+
+const reliable_channel::chunk* reliable_channel::next_chunk() const noexcept {
+  // Retransmitted chunks always fit into the window, because the window only
+  // moves forward.
+  if (!retransmit_.empty())
+    return &retransmit_.front();
+  if (!queue_.empty() && in_window(queue_.front()))
+    return &queue_.front();
+  return nullptr;
+}
+
+reliable_channel::duration
+reliable_channel::pacing_interval(size_t packet_size) const noexcept {
+  if (!has_rtt_sample_)
+    return duration::zero();
+  // Send at 5/4 of the rate cwnd / srtt to compensate for timer granularity.
+  using rep = duration::rep;
+  return duration{srtt_.count() * static_cast<rep>(packet_size) * 4
+                  / (static_cast<rep>(cwnd_) * 5)};
+}
+
+reliable_channel::duration reliable_channel::probe_timeout() const noexcept {
+  auto result = srtt_
+                + std::max<duration>(4 * rttvar_,
+                                     std::chrono::milliseconds(1))
+                + max_ack_delay;
+  return result * (size_t{1} << std::min(probe_timeouts_, size_t{10}));
+}
+
+// -- event handling -----------------------------------------------------------
+
+bool reliable_channel::handle_datagram(time_point now, const void* data,
+                                       size_t size, const frame_consumer& f) {
+  auto first = static_cast<const byte*>(data);
+  auto last = first + size;
+  uint8_t type = 0;
+  uint32_t session = 0;
+  if (!get(first, last, type) || !get(first, last, session))
+    return false;
+  if (!has_peer_session_) {
+    peer_session_ = session;
+    has_peer_session_ = true;
+  } else if (session != peer_session_) {
+    return false;
+  }
+  switch (type) {
+    case data_packet: {
+      uint64_t pkt = 0;
+      if (!get(first, last, pkt))
+        return false;
+      return handle_data(now, first, last, pkt, f);
+    }
+    case ack_packet:
+      return handle_ack(now, first, last);
+    case close_packet:
+      peer_closed_ = true;
+      return true;
+    default:
+      return false;
+  }
+}
+
+void reliable_channel::transmit(time_point now, const datagram_consumer& f) {
+  if (failed_ || close_sent_)
+    return;
+  // A closed peer no longer accepts data, so there is nothing left to drain.
+  if (closing_ && peer_closed_) {
+    write_close(f);
+    return;
+  }
+  if (loss_time_ <= now)
+    detect_losses(now);
+  if (!sent_.empty() && last_send_ + probe_timeout() <= now) {
+    if (++probe_timeouts_ > max_probe_timeouts) {
+      failed_ = true;
+      return;
+    }
+    // Retransmit the oldest packet as probe, regardless of the congestion
+    // window. Repeated timeouts indicate persistent congestion.
+    auto i = sent_.begin();
+    bytes_in_flight_ -= i->second.size;
+    queued_bytes_ += i->second.content.data.size();
+    ++lost_packets_;
+    retransmit_.emplace_front(std::move(i->second.content));
+    sent_.erase(i);
+    if (probe_timeouts_ > 1)
+      cwnd_ = min_window * max_datagram_size;
+    probe_ = true;
+  }
+  if (ack_deadline_ <= now)
+    write_ack(f);
+  for (;;) {
+    auto x = next_chunk();
+    if (x == nullptr || (!probe_ && !can_send(now, *x)))
+      break;
+    probe_ = false;
+    auto& q = !retransmit_.empty() ? retransmit_ : queue_;
+    write_chunk(now, q.front(), f);
+    q.pop_front();
+  }
+  if (closing_ && idle())
+    write_close(f);
+}
+
+reliable_channel::time_point reliable_channel::next_timeout() const noexcept {
+  if (failed_ || close_sent_)
+    return time_point::max();
+  if (closing_ && (peer_closed_ || idle()))
+    return time_point::min();
+  auto result = std::min(ack_deadline_, loss_time_);
+  if (!sent_.empty())
+    result = std::min(result, last_send_ + probe_timeout());
+  if (auto ptr = next_chunk()) {
+    auto& x = *ptr;
+    auto size = packet_header_size + chunk_header_size + x.data.size();
+    if (probe_ || bytes_in_flight_ == 0 || bytes_in_flight_ + size <= cwnd_)
+      result = std::min(result, next_send_time_);
+  }
+  return result;
+}
+
+// -- receiving ----------------------------------------------------------------
+
+bool reliable_channel::handle_data(time_point now, const byte* first,
+                                   const byte* last, uint64_t pkt,
+                                   const frame_consumer& f) {
+  uint16_t stream_id = 0;
+  uint64_t seq = 0;
+  uint16_t frag = 0;
+  uint16_t frags = 0;
+  if (!get(first, last, stream_id) || !get(first, last, seq)
+      || !get(first, last, frag) || !get(first, last, frags)
+      || stream_id >= max_streams || frags == 0 || frags > max_frags
+      || frag >= frags || first == last)
+    return false;
+  // Drop packets beyond the receive window without acknowledging them. The
+  // sender retransmits them once the window moved on.
+  auto& x = streams_.emplace(stream_id, inbound_stream{first_, {}})
+              .first->second;
+  if (seq >= x.next_seq && seq - x.next_seq >= receive_window)
+    return true;
+  // Acknowledge immediately if the packet is a duplicate or opens a gap in the
+  // sequence of packet numbers. Otherwise, acknowledge every other packet.
+  auto in_order = received_.empty() || received_.front().second + 1 == pkt;
+  auto is_new = record_packet(pkt);
+  if (!is_new || !in_order || ++unacked_packets_ >= 2)
+    ack_deadline_ = now;
+  else
+    ack_deadline_ = std::min(ack_deadline_, now + max_ack_delay);
+  if (!is_new || seq < x.next_seq)
+    return true;
+  auto& pf = x.pending[seq];
+  if (pf.frags == 0)
+    pf.frags = frags;
+  else if (pf.frags != frags)
+    return false;
+  pf.chunks.emplace(frag, byte_buffer(first, last));
+  drain(stream_id, x, f);
+  return true;
+}
+
+bool reliable_channel::handle_ack(time_point now, const byte* first,
+                                  const byte* last) {
+  uint8_t n = 0;
+  if (!get(first, last, n) || n == 0)
+    return false;
+  std::pair<uint64_t, uint64_t> ranges[std::numeric_limits<uint8_t>::max()];
+  for (size_t i = 0; i < n; ++i) {
+    auto& range = ranges[i];
+    if (!get(first, last, range.second) || !get(first, last, range.first)
+        || range.first > range.second || range.second >= next_pkt_)
+      return false;
+  }
+  auto largest = ranges[0].second;
+  auto newly_acked = false;
+  for (size_t i = 0; i < n; ++i) {
+    auto j = sent_.lower_bound(ranges[i].first);
+    auto e = sent_.upper_bound(ranges[i].second);
+    while (j != e) {
+      if (j->first == largest)
+        update_rtt(now - j->second.time);
+      on_acked(j->second);
+      newly_acked = true;
+      j = sent_.erase(j);
+    }
+  }
+  if (!has_largest_acked_ || largest > largest_acked_) {
+    largest_acked_ = largest;
+    has_largest_acked_ = true;
+  }
+  if (newly_acked)
+    probe_timeouts_ = 0;
+  detect_losses(now);
+  return true;
+}
+
+void reliable_channel::drain(uint16_t stream_id, inbound_stream& x,
+                             const frame_consumer& f) {
+  if (stream_id != 0 && !control_established_)
+    return;
+  while (!x.pending.empty()) {
+    auto i = x.pending.begin();
+    auto& pf = i->second;
+    if (i->first != x.next_seq || pf.chunks.size() != pf.frags)
+      return;
+    byte_buffer frame;
+    if (pf.frags == 1) {
+      frame.swap(pf.chunks.begin()->second);
+    } else {
+      for (auto& kvp : pf.chunks)
+        frame.insert(frame.end(), kvp.second.begin(), kvp.second.end());
+    }
+    x.pending.erase(i);
+    ++x.next_seq;
+    f(stream_id, frame);
+    if (stream_id == 0 && !control_established_) {
+      control_established_ = true;
+      for (auto& kvp : streams_)
+        if (kvp.first != 0)
+          drain(kvp.first, kvp.second, f);
+    }
+  }
+}
+
+bool reliable_channel::record_packet(uint64_t pkt) {
+  // Ranges are stored as (low, high) pairs in descending order.
+  auto trim = [this] {
+    if (received_.size() > max_ack_ranges)
+      received_.pop_back();
+  };
+  for (auto i = received_.begin(); i != received_.end(); ++i) {
+    if (pkt >= i->first && pkt <= i->second)
+      return false;
+    if (pkt > i->second) {
+      auto prev = i != received_.begin() ? i - 1 : received_.end();
+      auto joins_prev = prev != received_.end() && prev->first == pkt + 1;
+      if (pkt == i->second + 1) {
+        i->second = pkt;
+        if (joins_prev) {
+          prev->first = i->first;
+          received_.erase(i);
+        }
+      } else if (joins_prev) {
+        prev->first = pkt;
+      } else {
+        received_.emplace(i, pkt, pkt);
+        trim();
+      }
+      return true;
+    }
+  }
+  if (!received_.empty() && received_.back().first == pkt + 1) {
+    received_.back().first = pkt;
+  } else {
+    received_.emplace_back(pkt, pkt);
+    trim();
+  }
+  return true;
+}
+
+// -- loss detection and congestion control ------------------------------------
+
+void reliable_channel::detect_losses(time_point now) {
+  loss_time_ = time_point::max();
+  if (!has_largest_acked_)
+    return;
+  auto loss_delay = std::max<duration>(srtt_ * 9 / 8,
+                                       std::chrono::milliseconds(1));
+  auto i = sent_.begin();
+  while (i != sent_.end() && i->first < largest_acked_) {
+    auto& x = i->second;
+    if (largest_acked_ - i->first >= reordering_threshold
+        || x.time + loss_delay <= now) {
+      on_loss(x, now);
+      queued_bytes_ += x.content.data.size();
+      retransmit_.emplace_back(std::move(x.content));
+      i = sent_.erase(i);
+    } else {
+      loss_time_ = std::min(loss_time_, x.time + loss_delay);
+      ++i;
+    }
+  }
+}
+
+void reliable_channel::on_loss(const sent_packet& x, time_point now) {
+  bytes_in_flight_ -= x.size;
+  ++lost_packets_;
+  // Reduce the window only once per round trip.
+  if (x.time > recovery_start_) {
+    recovery_start_ = now;
+    ssthresh_ = std::max(cwnd_ / 2, min_window * max_datagram_size);
+    cwnd_ = ssthresh_;
+  }
+}
+
+void reliable_channel::on_acked(const sent_packet& x) {
+  bytes_in_flight_ -= x.size;
+  auto& frames = unacked_[x.content.stream];
+  auto i = frames.find(x.content.seq);
+  if (i != frames.end() && --i->second == 0)
+    frames.erase(i);
+  if (x.time <= recovery_start_)
+    return;
+  if (cwnd_ < ssthresh_)
+    cwnd_ += x.size;
+  else
+    cwnd_ += max_datagram_size * x.size / cwnd_;
+}
+
+void reliable_channel::update_rtt(duration sample) {
+  if (!has_rtt_sample_) {
+    srtt_ = sample;
+    rttvar_ = sample / 2;
+    has_rtt_sample_ = true;
+    return;
+  }
+  auto delta = srtt_ > sample ? srtt_ - sample : sample - srtt_;
+  rttvar_ = (3 * rttvar_ + delta) / 4;
+  srtt_ = (7 * srtt_ + sample) / 8;
+}
+
+} // namespace caf::io::network
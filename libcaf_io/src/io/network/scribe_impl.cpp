@@ -49,6 +49,14 @@ byte_buffer& scribe_impl::wr_buf() {
   return stream_.wr_buf();
 }
 
+void scribe_impl::write(byte_buffer&& buf) {
+  stream_.write(std::move(buf));
+}
+
+size_t scribe_impl::pending_bytes() {
+  return stream_.pending_bytes();
+}
+
 byte_buffer& scribe_impl::rd_buf() {
   return stream_.rd_buf();
 }
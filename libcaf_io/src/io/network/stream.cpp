@@ -35,7 +35,8 @@ stream::stream(default_multiplexer& backend_ref, native_socket sockfd)
                                   defaults::middleman::max_consecutive_reads)),
     read_threshold_(1),
     collected_(0),
-    written_(0) {
+    written_(0),
+    wr_pos_(0) {
   configure_read(receive_policy::at_most(1024));
 }
 
@@ -64,10 +65,27 @@ void stream::write(const void* buf, size_t num_bytes) {
   wr_offline_buf_.insert(wr_offline_buf_.end(), first, last);
 }
 
+void stream::write(byte_buffer&& buf) {
+  CAF_LOG_TRACE(CAF_ARG2("num_bytes", buf.size()));
+  if (buf.size() < zero_copy_threshold) {
+    wr_offline_buf_.insert(wr_offline_buf_.end(), buf.begin(), buf.end());
+    backend().buffer_pool().put(std::move(buf));
+    return;
+  }
+  // Close the current segment to preserve the order of all writes.
+  if (!wr_offline_buf_.empty()) {
+    wr_offline_bufs_.emplace_back(std::move(wr_offline_buf_));
+    wr_offline_buf_.clear();
+  }
+  wr_offline_bufs_.emplace_back(std::move(buf));
+}
+
 void stream::flush(const manager_ptr& mgr) {
   CAF_ASSERT(mgr != nullptr);
-  CAF_LOG_TRACE(CAF_ARG(wr_offline_buf_.size()));
-  if (!wr_offline_buf_.empty() && !state_.writing) {
+  CAF_LOG_TRACE(CAF_ARG(wr_offline_buf_.size())
+                << CAF_ARG2("segments", wr_offline_bufs_.size()));
+  if ((!wr_offline_buf_.empty() || !wr_offline_bufs_.empty())
+      && !state_.writing) {
     backend().add(operation::write, fd(), this);
     writer_ = mgr;
     state_.writing = true;
@@ -115,36 +133,67 @@ void stream::prepare_next_read() {
   switch (static_cast<receive_policy_flag>(state_.rd_flag)) {
     case receive_policy_flag::exactly:
       if (rd_buf_.size() != max_)
-        rd_buf_.resize(max_);
+        resize_rd_buf(max_);
       read_threshold_ = max_;
       break;
     case receive_policy_flag::at_most:
       if (rd_buf_.size() != max_)
-        rd_buf_.resize(max_);
+        resize_rd_buf(max_);
       read_threshold_ = 1;
       break;
     case receive_policy_flag::at_least: {
       // read up to 10% more, but at least allow 100 bytes more
       auto max_size = max_ + std::max<size_t>(100, max_ / 10);
       if (rd_buf_.size() != max_size)
-        rd_buf_.resize(max_size);
+        resize_rd_buf(max_size);
       read_threshold_ = max_;
       break;
     }
   }
 }
 
+void stream::resize_rd_buf(size_t new_size) {
+  // The manager may have taken our buffer, e.g., when a broker kept the
+  // buffer of a `new_data_msg`. Try to refill from the pool in this case.
+  if (rd_buf_.capacity() < new_size) {
+    auto& pool = backend().buffer_pool();
+    auto buf = pool.get();
+    if (buf.capacity() > rd_buf_.capacity())
+      rd_buf_.swap(buf);
+    pool.put(std::move(buf));
+  }
+  rd_buf_.resize(new_size);
+}
+
 void stream::prepare_next_write() {
-  CAF_LOG_TRACE(CAF_ARG(wr_buf_.size()) << CAF_ARG(wr_offline_buf_.size()));
+  CAF_LOG_TRACE(CAF_ARG2("segments", wr_bufs_.size())
+                << CAF_ARG(wr_offline_buf_.size()));
   written_ = 0;
-  wr_buf_.clear();
-  if (wr_offline_buf_.empty()) {
+  wr_pos_ = 0;
+  // Recycle the memory of drained segments for the next writes.
+  byte_buffer spare;
+  if (!wr_bufs_.empty()) {
+    spare.swap(wr_bufs_.back());
+    spare.clear();
+    wr_bufs_.pop_back();
+    auto& pool = backend().buffer_pool();
+    for (auto& buf : wr_bufs_)
+      pool.put(std::move(buf));
+    wr_bufs_.clear();
+  }
+  if (!wr_offline_buf_.empty()) {
+    wr_offline_bufs_.emplace_back(std::move(wr_offline_buf_));
+    wr_offline_buf_.clear();
+  }
+  if (spare.capacity() > wr_offline_buf_.capacity())
+    wr_offline_buf_.swap(spare);
+  if (wr_offline_bufs_.empty()) {
     state_.writing = false;
     backend().del(operation::write, fd(), this);
     if (state_.shutting_down)
       send_fin();
   } else {
-    wr_buf_.swap(wr_offline_buf_);
+    wr_bufs_.swap(wr_offline_bufs_);
   }
 }
 
@@ -182,20 +231,39 @@ void stream::handle_write_result(rw_state write_result, size_t wb) {
     case rw_state::indeterminate:
       prepare_next_write();
       break;
-    case rw_state::success:
-      written_ += wb;
-      CAF_ASSERT(written_ <= wr_buf_.size());
-      auto remaining = wr_buf_.size() - written_;
+    case rw_state::success: {
+      // Advance to the first segment with remaining data.
+      for (auto n = wb; n > 0;) {
+        CAF_ASSERT(wr_pos_ < wr_bufs_.size());
+        auto& buf = wr_bufs_[wr_pos_];
+        auto k = std::min(n, buf.size() - written_);
+        written_ += k;
+        n -= k;
+        if (written_ == buf.size()) {
+          ++wr_pos_;
+          written_ = 0;
+        }
+      }
       if (state_.ack_writes)
-        writer_->data_transferred(&backend(), wb,
-                                  remaining + wr_offline_buf_.size());
+        writer_->data_transferred(&backend(), wb, pending_bytes());
       // prepare next send (or stop sending)
-      if (remaining == 0)
+      if (wr_pos_ == wr_bufs_.size())
         prepare_next_write();
       break;
+    }
   }
 }
 
+size_t stream::pending_bytes() const {
+  auto result = wr_offline_buf_.size();
+  for (auto i = wr_pos_; i < wr_bufs_.size(); ++i)
+    result += wr_bufs_[i].size();
+  result -= written_;
+  for (auto& buf : wr_offline_bufs_)
+    result += buf.size();
+  return result;
+}
+
 void stream::handle_error_propagation() {
   if (reader_)
     reader_->io_failure(&backend(), operation::read);
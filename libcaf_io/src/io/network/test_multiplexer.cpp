@@ -66,7 +66,10 @@ test_multiplexer::datagram_data::datagram_data(shared_job_queue_type input,
 }
 
 test_multiplexer::test_multiplexer(actor_system* sys)
-  : multiplexer(sys), inline_runnables_(0), servant_ids_(0) {
+  : multiplexer(sys),
+    inline_runnables_(0),
+    max_throughput_(1),
+    servant_ids_(0) {
   CAF_ASSERT(sys != nullptr);
 }
 
@@ -1019,7 +1022,7 @@ void test_multiplexer::exec(resumable_ptr& ptr) {
   CAF_ASSERT(std::this_thread::get_id() == tid_);
   CAF_ASSERT(ptr != nullptr);
   CAF_LOG_TRACE("");
-  switch (ptr->resume(this, 1)) {
+  switch (ptr->resume(this, max_throughput_)) {
     case resumable::resume_later:
       exec_later(ptr.get());
       break;
@@ -30,6 +30,15 @@ scribe::~scribe() {
   CAF_LOG_TRACE("");
 }
 
+void scribe::write(byte_buffer&& buf) {
+  auto& out = wr_buf();
+  out.insert(out.end(), buf.begin(), buf.end());
+}
+
+size_t scribe::pending_bytes() {
+  return wr_buf().size();
+}
+
 message scribe::detach_message() {
   return make_message(connection_closed_msg{hdl()});
 }
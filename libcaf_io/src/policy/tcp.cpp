@@ -18,6 +18,7 @@
 
 #include "caf/policy/tcp.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 #include "caf/io/network/native_socket.hpp"
@@ -28,6 +29,7 @@
 #else
 #  include <sys/socket.h>
 #  include <sys/types.h>
+#  include <sys/uio.h>
 #endif
 
 using caf::io::network::is_error;
@@ -78,6 +80,52 @@ tcp::write_some(size_t& result, native_socket fd, const void* buf, size_t len) {
   return rw_state::success;
 }
 
+rw_state tcp::writev_some(size_t& result, native_socket fd,
+                          const span<const byte>* bufs, size_t num_bufs) {
+  CAF_LOG_TRACE(CAF_ARG(fd) << CAF_ARG(num_bufs));
+  // Writing fewer buffers than requested is just another partial write.
+  constexpr size_t max_bufs = 64;
+  num_bufs = std::min(num_bufs, max_bufs);
+  size_t len = 0;
+#ifdef CAF_WINDOWS
+  WSABUF vec[max_bufs];
+  for (size_t i = 0; i < num_bufs; ++i) {
+    vec[i].buf = reinterpret_cast<CHAR*>(const_cast<byte*>(bufs[i].data()));
+    vec[i].len = static_cast<ULONG>(bufs[i].size());
+    len += bufs[i].size();
+  }
+  DWORD bytes_sent = 0;
+  auto sres = WSASend(fd, vec, static_cast<DWORD>(num_bufs), &bytes_sent, 0,
+                      nullptr, nullptr)
+                  == 0
+                ? static_cast<int>(bytes_sent)
+                : SOCKET_ERROR;
+#else
+  iovec vec[max_bufs];
+  for (size_t i = 0; i < num_bufs; ++i) {
+    vec[i].iov_base = const_cast<byte*>(bufs[i].data());
+    vec[i].iov_len = bufs[i].size();
+    len += bufs[i].size();
+  }
+  msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = vec;
+  msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(num_bufs);
+  auto sres = ::sendmsg(fd, &msg, no_sigpipe_io_flag);
+#endif
+  if (is_error(sres, true)) {
+    // Make sure WSAGetLastError gets called immediately on Windows.
+    auto err = last_socket_error();
+    CAF_IGNORE_UNUSED(err);
+    CAF_LOG_ERROR("sendmsg failed:" << socket_error_as_string(err));
+    return rw_state::failure;
+  }
+  CAF_IGNORE_UNUSED(len);
+  CAF_LOG_DEBUG(CAF_ARG(len) << CAF_ARG(fd) << CAF_ARG(sres));
+  result = (sres > 0) ? static_cast<size_t>(sres) : 0;
+  return rw_state::success;
+}
+
 bool tcp::try_accept(native_socket& result, native_socket fd) {
   using namespace io::network;
   CAF_LOG_TRACE(CAF_ARG(fd));
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE io.basp.compression
+
+#include "caf/io/basp/compression.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <random>
+#include <string>
+
+using namespace caf;
+using namespace caf::io::basp;
+
+namespace {
+
+struct fixture {
+  byte_buffer make_text(size_t size) {
+    std::string words = "lorem ipsum dolor sit amet consectetur adipiscing ";
+    byte_buffer result;
+    for (size_t i = 0; result.size() < size; ++i) {
+      // Vary the input a bit to produce literals between matches.
+      if (i % 7 == 0)
+        result.emplace_back(static_cast<byte>(i));
+      for (auto c : words)
+        result.emplace_back(static_cast<byte>(c));
+    }
+    result.resize(size);
+    return result;
+  }
+
+  byte_buffer make_noise(size_t size) {
+    std::minstd_rand rng{42};
+    byte_buffer result;
+    for (size_t i = 0; i < size; ++i)
+      result.emplace_back(static_cast<byte>(rng() & 0xff));
+    return result;
+  }
+
+  byte_buffer round_trip(const byte_buffer& input) {
+    byte_buffer compressed;
+    if (!compress(compressed, input))
+      CAF_FAIL("failed to compress " << input.size() << " bytes");
+    CAF_CHECK_LESS(compressed.size(), input.size());
+    byte_buffer result;
+    if (!decompress(result, compressed))
+      CAF_FAIL("failed to decompress " << compressed.size() << " bytes");
+    return result;
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(compression_tests, fixture)
+
+CAF_TEST(compressible payloads survive a round trip) {
+  for (auto size : {256u, 1000u, 4096u, 100000u}) {
+    auto input = make_text(size);
+    CAF_CHECK_EQUAL(round_trip(input), input);
+  }
+}
+
+CAF_TEST(runs of the same byte use overlapping matches) {
+  byte_buffer input(5000, byte{'x'});
+  byte_buffer compressed;
+  CAF_REQUIRE(compress(compressed, input));
+  CAF_CHECK_LESS(compressed.size(), 64u);
+  byte_buffer output;
+  CAF_REQUIRE(decompress(output, compressed));
+  CAF_CHECK_EQUAL(output, input);
+}
+
+CAF_TEST(compression leaves incompressible payloads alone) {
+  byte_buffer out{byte{1}, byte{2}};
+  CAF_CHECK(!compress(out, byte_buffer{}));
+  CAF_CHECK(!compress(out, make_noise(16)));
+  CAF_CHECK(!compress(out, make_noise(4096)));
+  CAF_CHECK_EQUAL(out, byte_buffer({byte{1}, byte{2}}));
+}
+
+CAF_TEST(decompression appends to the output buffer) {
+  auto input = make_text(2000);
+  byte_buffer compressed;
+  CAF_REQUIRE(compress(compressed, input));
+  byte_buffer output{byte{1}};
+  CAF_REQUIRE(decompress(output, compressed));
+  CAF_REQUIRE_EQUAL(output.size(), input.size() + 1);
+  CAF_CHECK(std::equal(input.begin(), input.end(), output.begin() + 1));
+}
+
+CAF_TEST(decompression rejects malformed input) {
+  auto input = make_text(2000);
+  byte_buffer compressed;
+  CAF_REQUIRE(compress(compressed, input));
+  byte_buffer output;
+  CAF_MESSAGE("truncated input");
+  auto truncated = compressed;
+  truncated.resize(truncated.size() / 2);
+  CAF_CHECK(!decompress(output, truncated));
+  CAF_CHECK(!decompress(output, byte_buffer{byte{0}, byte{0}}));
+  CAF_MESSAGE("wrong original size");
+  auto wrong_size = compressed;
+  wrong_size[3] = static_cast<byte>(static_cast<uint8_t>(wrong_size[3]) + 1);
+  CAF_CHECK(!decompress(output, wrong_size));
+  CAF_MESSAGE("bogus size that exceeds the maximum compression ratio");
+  byte_buffer bogus{byte{0xff}, byte{0xff}, byte{0xff}, byte{0xff}, byte{0}};
+  CAF_CHECK(!decompress(output, bogus));
+  CAF_CHECK(output.empty());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
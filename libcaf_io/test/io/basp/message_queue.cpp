@@ -22,6 +22,9 @@
 
 #include "caf/test/dsl.hpp"
 
+#include <thread>
+#include <vector>
+
 #include "caf/actor_cast.hpp"
 #include "caf/actor_system.hpp"
 #include "caf/behavior.hpp"
@@ -62,16 +65,23 @@ struct fixture : test_coordinator_fixture<> {
 CAF_TEST_FIXTURE_SCOPE(message_queue_tests, fixture)
 
 CAF_TEST(default construction) {
-  CAF_CHECK_EQUAL(queue.next_id, 0u);
-  CAF_CHECK_EQUAL(queue.next_undelivered, 0u);
-  CAF_CHECK_EQUAL(queue.pending.size(), 0u);
+  CAF_CHECK_EQUAL(queue.next_id(), 0u);
+  CAF_CHECK_EQUAL(queue.next_undelivered(), 0u);
+  CAF_CHECK_EQUAL(queue.capacity(), 1024u);
 }
 
 CAF_TEST(ascending IDs) {
   CAF_CHECK_EQUAL(queue.new_id(), 0u);
   CAF_CHECK_EQUAL(queue.new_id(), 1u);
   CAF_CHECK_EQUAL(queue.new_id(), 2u);
-  CAF_CHECK_EQUAL(queue.next_undelivered, 0u);
+  CAF_CHECK_EQUAL(queue.next_undelivered(), 0u);
+}
+
+CAF_TEST(reserving ID ranges) {
+  CAF_CHECK_EQUAL(queue.new_id(), 0u);
+  CAF_CHECK_EQUAL(queue.new_ids(3), 1u);
+  CAF_CHECK_EQUAL(queue.new_id(), 4u);
+  CAF_CHECK_EQUAL(queue.next_undelivered(), 0u);
 }
 
 CAF_TEST(push order 0 - 1 - 2) {
@@ -152,4 +162,58 @@ CAF_TEST(dropping) {
   expect((ok_atom, int), from(self).to(testee).with(_, 2));
 }
 
+CAF_TEST(messages that do not fit into the ring wait in the overflow list) {
+  io::basp::message_queue small_queue{4};
+  CAF_REQUIRE_EQUAL(small_queue.capacity(), 4u);
+  small_queue.new_ids(8);
+  auto push_to_small_queue = [&](int msg_id) {
+    small_queue.push(nullptr, static_cast<uint64_t>(msg_id), testee,
+                     make_mailbox_element(self->ctrl(), make_message_id(), {},
+                                          ok_atom_v, msg_id));
+  };
+  for (int i = 7; i > 0; --i)
+    push_to_small_queue(i);
+  disallow((ok_atom, int), from(self).to(testee));
+  CAF_CHECK_EQUAL(small_queue.next_undelivered(), 0u);
+  push_to_small_queue(0);
+  for (int i = 0; i < 8; ++i)
+    expect((ok_atom, int), from(self).to(testee).with(_, i));
+  CAF_CHECK_EQUAL(small_queue.next_undelivered(), 8u);
+}
+
+CAF_TEST(concurrent producers deliver in order) {
+  std::vector<int> received;
+  io::basp::message_queue mt_queue{16};
+  constexpr int num_threads = 8;
+  constexpr int msgs_per_thread = 1000;
+  auto first = mt_queue.new_ids(num_threads * msgs_per_thread);
+  CAF_REQUIRE_EQUAL(first, 0u);
+  auto sink = sys.spawn<lazy_init>([&received] {
+    return behavior{[&received](int x) { received.push_back(x); }};
+  });
+  auto sink_ptr = actor_cast<strong_actor_ptr>(sink);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      // Each thread pushes every num_threads-th ID.
+      for (int i = 0; i < msgs_per_thread; ++i) {
+        auto id = i * num_threads + t;
+        mt_queue.push(nullptr, static_cast<uint64_t>(id), sink_ptr,
+                      make_mailbox_element(nullptr, make_message_id(), {},
+                                           id));
+      }
+    });
+  }
+  for (auto& th : threads)
+    th.join();
+  CAF_CHECK_EQUAL(mt_queue.next_undelivered(),
+                  static_cast<uint64_t>(num_threads * msgs_per_thread));
+  sched.run();
+  CAF_REQUIRE_EQUAL(received.size(),
+                    static_cast<size_t>(num_threads * msgs_per_thread));
+  for (size_t i = 0; i < received.size(); ++i)
+    if (received[i] != static_cast<int>(i))
+      CAF_FAIL("message " << received[i] << " delivered at position " << i);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE io.basp.routing_table
+
+#include "caf/io/basp/routing_table.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+struct fixture {
+  basp::routing_table tbl{nullptr};
+  node_id mars;
+  node_id jupiter;
+  node_id venus;
+  connection_handle mars_hdl = connection_handle::from_int(1);
+  connection_handle jupiter_hdl = connection_handle::from_int(2);
+
+  fixture() {
+    mars = unbox(make_node_id(1, "0011223344556677889900112233445566778899"));
+    jupiter
+      = unbox(make_node_id(2, "9988776655443322110099887766554433221100"));
+    venus = unbox(make_node_id(3, "0000000000000000000000000000000000000003"));
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(routing_table_tests, fixture)
+
+CAF_TEST(direct routes take precedence over indirect routes) {
+  tbl.add_direct(mars_hdl, mars);
+  CAF_CHECK(tbl.add_indirect(mars, venus));
+  auto path = tbl.lookup(venus);
+  CAF_REQUIRE(path);
+  CAF_CHECK_EQUAL(path->next_hop, mars);
+  CAF_CHECK_EQUAL(path->hdl, mars_hdl);
+  CAF_CHECK(!tbl.add_indirect(venus, mars));
+}
+
+CAF_TEST(erasing a direct route drops all indirect routes over it) {
+  tbl.add_direct(mars_hdl, mars);
+  tbl.add_direct(jupiter_hdl, jupiter);
+  CAF_CHECK(tbl.add_indirect(mars, venus));
+  CAF_CHECK(!tbl.add_indirect(jupiter, venus));
+  CAF_CHECK_EQUAL(tbl.erase_direct(mars_hdl), mars);
+  CAF_CHECK_EQUAL(tbl.lookup_indirect(venus), jupiter);
+  auto path = tbl.lookup(venus);
+  CAF_REQUIRE(path);
+  CAF_CHECK_EQUAL(path->hdl, jupiter_hdl);
+  CAF_CHECK_EQUAL(tbl.erase_direct(jupiter_hdl), jupiter);
+  CAF_CHECK_EQUAL(tbl.lookup_indirect(venus), none);
+  CAF_CHECK(!tbl.lookup(venus));
+  CAF_CHECK(!tbl.erase_indirect(venus));
+}
+
+CAF_TEST(concurrent lookups) {
+  tbl.add_direct(mars_hdl, mars);
+  CAF_CHECK(tbl.add_indirect(mars, venus));
+  std::vector<std::thread> threads;
+  std::atomic<size_t> hits{0};
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&] {
+      for (int j = 0; j < 1000; ++j)
+        if (tbl.lookup_direct(mars_hdl) == mars && tbl.lookup(venus))
+          ++hits;
+    });
+  for (auto& th : threads)
+    th.join();
+  CAF_CHECK_EQUAL(hits.load(), 4000u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -23,15 +23,18 @@
 #include "caf/test/dsl.hpp"
 
 #include <array>
+#include <chrono>
 #include <condition_variable>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 #include "caf/all.hpp"
 #include "caf/deep_to_string.hpp"
+#include "caf/defaults.hpp"
 #include "caf/io/all.hpp"
 #include "caf/io/network/interfaces.hpp"
 #include "caf/io/network/test_multiplexer.hpp"
@@ -103,10 +106,13 @@ struct node {
 
 class fixture {
 public:
-  fixture(bool autoconn = false)
+  fixture(bool autoconn = false,
+          size_t high_watermark = defaults::middleman::high_watermark,
+          size_t workers = 0)
     : sys(cfg.load<io::middleman, network::test_multiplexer>()
             .set("middleman.enable-automatic-connections", autoconn)
-            .set("middleman.workers", size_t{0})
+            .set("middleman.workers", workers)
+            .set("middleman.high-watermark", high_watermark)
             .set("scheduler.policy", autoconn ? "testing" : "stealing")
             .set("middleman.attach-utility-actors", autoconn)) {
     auto& mm = sys.middleman();
@@ -221,6 +227,32 @@ public:
       CAF_FAIL("failed to serialize payload: " << sys.render(err));
   }
 
+  // Sends a batch with a corrupted second sub-header to us.
+  void send_malformed_batch(connection_handle hdl) {
+    byte_buffer msg_buf;
+    to_payload(msg_buf, std::vector<strong_actor_ptr>{}, make_message(1));
+    basp::header sub_hdr{basp::message_type::direct_message,
+                         0,
+                         static_cast<uint32_t>(msg_buf.size()),
+                         make_message_id().integer_value(),
+                         invalid_actor_id,
+                         self()->id()};
+    byte_buffer payload;
+    basp::write_sub_header(payload, sub_hdr);
+    payload.insert(payload.end(), msg_buf.begin(), msg_buf.end());
+    payload.insert(payload.end(), 4, byte{0xFF});
+    basp::header batch_hdr{basp::message_type::batched_message,
+                           0,
+                           static_cast<uint32_t>(payload.size()),
+                           2,
+                           invalid_actor_id,
+                           invalid_actor_id};
+    byte_buffer buf;
+    to_payload(buf, batch_hdr);
+    buf.insert(buf.end(), payload.begin(), payload.end());
+    mpx()->virtual_send(hdl, buf);
+  }
+
   void to_buf(byte_buffer& buf, basp::header& hdr, payload_writer* writer) {
     instance().write(mpx_, buf, hdr, writer);
   }
@@ -252,7 +284,8 @@ public:
 
   void connect_node(node& n, optional<accept_handle> ax = none,
                     actor_id published_actor_id = invalid_actor_id,
-                    const std::set<std::string>& published_actor_ifs = {}) {
+                    const std::set<std::string>& published_actor_ifs = {},
+                    uint64_t client_version = 0) {
     auto src = ax ? *ax : ahdl_;
     CAF_MESSAGE("connect remote node "
                 << n.name << ", connection ID = " << n.connection.id()
@@ -263,8 +296,8 @@ public:
     // technically, the server handshake arrives
     // before we send the client handshake
     mock(hdl,
-         {basp::message_type::client_handshake, 0, 0, 0, invalid_actor_id,
-          invalid_actor_id},
+         {basp::message_type::client_handshake, 0, 0, client_version,
+          invalid_actor_id, invalid_actor_id},
          n.id)
       .receive(hdl, basp::message_type::server_handshake, no_flags, any_vals,
                basp::version, invalid_actor_id, invalid_actor_id, this_node(),
@@ -438,6 +471,36 @@ public:
   }
 };
 
+class worker_fixture : public fixture {
+public:
+  worker_fixture() : fixture(false, defaults::middleman::high_watermark, 1) {
+    // nop
+  }
+};
+
+class flow_control_fixture : public fixture {
+public:
+  flow_control_fixture() : fixture(false, 16384) {
+    // nop
+  }
+
+  // Connects to Jupiter and fills the send buffer beyond the high watermark.
+  actor congest_jupiter() {
+    connect_node(jupiter());
+    auto hdl = jupiter().connection;
+    auto prx = proxies().get_or_put(jupiter().id, jupiter().dummy_actor->id());
+    mock().receive(hdl, basp::message_type::monitor_message, no_flags,
+                   any_vals, no_operation_data, invalid_actor_id, prx->id(),
+                   this_node(), prx->node());
+    auto dest = actor_cast<actor>(prx);
+    self()->send(dest, std::string(20000, 'x'));
+    while (mpx()->output_buffer(hdl).empty())
+      mpx()->exec_runnable();
+    CAF_REQUIRE(instance().congested(hdl));
+    return dest;
+  }
+};
+
 } // namespace
 
 CAF_TEST_FIXTURE_SCOPE(basp_tests, fixture)
@@ -552,6 +615,54 @@ CAF_TEST(message_forwarding) {
              std::vector<strong_actor_ptr>{}, msg);
 }
 
+CAF_TEST(interned_node_ids) {
+  connect_node(jupiter(), none, invalid_actor_id, {}, basp::version);
+  connect_node(mars(), none, invalid_actor_id, {}, basp::version);
+  auto msg = make_message(1, 2, 3);
+  CAF_MESSAGE("forwarding a message interns both nodes on the next hop");
+  mock(jupiter().connection,
+       {basp::message_type::routed_message, 0, 0, default_operation_data,
+        invalid_actor_id, mars().dummy_actor->id()},
+       jupiter().id, mars().id, std::vector<strong_actor_ptr>{}, msg)
+    .receive(mars().connection, basp::message_type::intern_node, no_flags,
+             any_vals, uint64_t{0}, invalid_actor_id, invalid_actor_id,
+             jupiter().id)
+    .receive(mars().connection, basp::message_type::intern_node, no_flags,
+             any_vals, uint64_t{1}, invalid_actor_id, invalid_actor_id,
+             mars().id)
+    .receive(mars().connection, basp::message_type::routed_message,
+             basp::header::interned_flag, any_vals, default_operation_data,
+             invalid_actor_id, mars().dummy_actor->id(), uint8_t{0},
+             uint8_t{1}, std::vector<strong_actor_ptr>{}, msg);
+  CAF_MESSAGE("subsequent messages reuse the handles");
+  mock(jupiter().connection,
+       {basp::message_type::routed_message, 0, 0, default_operation_data,
+        invalid_actor_id, mars().dummy_actor->id()},
+       jupiter().id, mars().id, std::vector<strong_actor_ptr>{}, msg)
+    .receive(mars().connection, basp::message_type::routed_message,
+             basp::header::interned_flag, any_vals, default_operation_data,
+             invalid_actor_id, mars().dummy_actor->id(), uint8_t{0},
+             uint8_t{1}, std::vector<strong_actor_ptr>{}, msg);
+  CAF_CHECK(mpx()->output_buffer(mars().connection).empty());
+  CAF_MESSAGE("receive a routed message with interned node IDs");
+  mock(mars().connection,
+       {basp::message_type::intern_node, 0, 0, 0, invalid_actor_id,
+        invalid_actor_id},
+       jupiter().id);
+  mock(mars().connection,
+       {basp::message_type::intern_node, 0, 0, 1, invalid_actor_id,
+        invalid_actor_id},
+       this_node());
+  mock(mars().connection,
+       {basp::message_type::routed_message, basp::header::interned_flag, 0,
+        default_operation_data, invalid_actor_id, self()->id()},
+       uint8_t{0}, uint8_t{1}, std::vector<strong_actor_ptr>{},
+       make_message("hello from jupiter!"));
+  self()->receive([](const std::string& str) {
+    CAF_CHECK_EQUAL(str, "hello from jupiter!");
+  });
+}
+
 CAF_TEST(publish_and_connect) {
   auto ax = accept_handle::from_int(4242);
   mpx()->provide_acceptor(4242, ax);
@@ -582,7 +693,7 @@ CAF_TEST(remote_actor_and_send) {
        jupiter().id, defaults::middleman::app_identifiers,
        jupiter().dummy_actor->id(), std::set<std::string>{})
     .receive(jupiter().connection, basp::message_type::client_handshake,
-             no_flags, any_vals, no_operation_data, invalid_actor_id,
+             no_flags, any_vals, basp::version, invalid_actor_id,
              invalid_actor_id, this_node())
     .receive(jupiter().connection, basp::message_type::direct_message,
              basp::header::named_receiver_flag, any_vals,
@@ -630,6 +741,110 @@ CAF_TEST(remote_actor_and_send) {
   });
 }
 
+CAF_TEST(batched_messages) {
+  CAF_MESSAGE("connect to Jupiter with batching enabled");
+  connect_node(jupiter(), none, invalid_actor_id, {}, basp::version);
+  auto hdl = jupiter().connection;
+  auto prx = proxies().get_or_put(jupiter().id, jupiter().dummy_actor->id());
+  mock().receive(hdl, basp::message_type::monitor_message, no_flags, any_vals,
+                 no_operation_data, invalid_actor_id, prx->id(), this_node(),
+                 prx->node());
+  CAF_MESSAGE("messages sent in one broker run travel in a single frame");
+  mpx()->max_throughput(3);
+  for (int i = 1; i <= 3; ++i)
+    anon_send(actor_cast<actor>(prx), i);
+  mpx()->flush_runnables();
+  basp::header hdr;
+  byte_buffer payload;
+  std::tie(hdr, payload) = read_from_out_buf(hdl);
+  CAF_CHECK_EQUAL(hdr.operation, basp::message_type::batched_message);
+  CAF_CHECK_EQUAL(hdr.operation_data, 3u);
+  CAF_CHECK(mpx()->output_buffer(hdl).empty());
+  span<const byte> bytes{payload.data(), payload.size()};
+  for (int i = 1; i <= 3; ++i) {
+    basp::header sub_hdr;
+    CAF_REQUIRE(basp::read_sub_header(bytes, sub_hdr));
+    CAF_CHECK_EQUAL(sub_hdr.operation, basp::message_type::direct_message);
+    CAF_CHECK_EQUAL(sub_hdr.operation_data, default_operation_data);
+    CAF_CHECK_EQUAL(sub_hdr.source_actor, invalid_actor_id);
+    CAF_CHECK_EQUAL(sub_hdr.dest_actor, prx->id());
+    byte_buffer expected;
+    to_payload(expected, std::vector<strong_actor_ptr>{}, make_message(i));
+    CAF_REQUIRE_EQUAL(sub_hdr.payload_len, expected.size());
+    CAF_CHECK(std::equal(expected.begin(), expected.end(), bytes.begin()));
+    bytes = bytes.subspan(sub_hdr.payload_len,
+                          bytes.size() - sub_hdr.payload_len);
+  }
+  CAF_CHECK(bytes.empty());
+  CAF_MESSAGE("a batch of one becomes an ordinary direct_message");
+  anon_send(actor_cast<actor>(prx), 4);
+  mpx()->flush_runnables();
+  mock().receive(hdl, basp::message_type::direct_message, no_flags, any_vals,
+                 default_operation_data, invalid_actor_id, prx->id(),
+                 std::vector<strong_actor_ptr>{}, make_message(4));
+  CAF_MESSAGE("receive a batched message from Jupiter");
+  payload.clear();
+  for (int i = 1; i <= 2; ++i) {
+    byte_buffer msg_buf;
+    to_payload(msg_buf, std::vector<strong_actor_ptr>{}, make_message(i));
+    basp::header sub_hdr{basp::message_type::direct_message,
+                         0,
+                         static_cast<uint32_t>(msg_buf.size()),
+                         default_operation_data,
+                         jupiter().dummy_actor->id(),
+                         self()->id()};
+    basp::write_sub_header(payload, sub_hdr);
+    payload.insert(payload.end(), msg_buf.begin(), msg_buf.end());
+  }
+  basp::header batch_hdr{basp::message_type::batched_message,
+                         0,
+                         static_cast<uint32_t>(payload.size()),
+                         2,
+                         invalid_actor_id,
+                         invalid_actor_id};
+  byte_buffer buf;
+  to_payload(buf, batch_hdr);
+  buf.insert(buf.end(), payload.begin(), payload.end());
+  mpx()->virtual_send(hdl, buf);
+  for (int i = 1; i <= 2; ++i)
+    self()->receive([&](int x) { CAF_CHECK_EQUAL(x, i); });
+}
+
+CAF_TEST(malformed batches close the connection) {
+  connect_node(jupiter());
+  auto hdl = jupiter().connection;
+  send_malformed_batch(hdl);
+  CAF_CHECK(!aut()->valid(hdl));
+  CAF_CHECK(!tbl().lookup_direct(jupiter().id));
+  self()->receive(
+    [](int) { CAF_FAIL("received a message of a malformed batch"); },
+    after(std::chrono::milliseconds(10)) >> [] {
+      // nop
+    });
+}
+
+CAF_TEST(compressed_messages) {
+  connect_node(jupiter());
+  auto hdl = jupiter().connection;
+  CAF_MESSAGE("receive a compressed message from Jupiter");
+  auto text = std::string(4096, 'a');
+  byte_buffer payload;
+  to_payload(payload, std::vector<strong_actor_ptr>{}, make_message(text));
+  byte_buffer compressed;
+  CAF_REQUIRE(basp::compress(compressed, payload));
+  basp::header hdr{basp::message_type::direct_message,
+                   basp::header::compressed_flag,
+                   static_cast<uint32_t>(compressed.size()),
+                   default_operation_data,
+                   jupiter().dummy_actor->id(),
+                   self()->id()};
+  byte_buffer buf;
+  to_payload(buf, hdr);
+  buf.insert(buf.end(), compressed.begin(), compressed.end());
+  mpx()->virtual_send(hdl, buf);
+  self()->receive([&](const std::string& str) { CAF_CHECK_EQUAL(str, text); });
+}
+
 CAF_TEST(actor_serialize_and_deserialize) {
   auto testee_impl = [](event_based_actor* testee_self) -> behavior {
     testee_self->set_default_handler(reflect_and_quit);
@@ -776,7 +991,7 @@ CAF_TEST(automatic_connection) {
        jupiter().id, defaults::middleman::app_identifiers,
        jupiter().dummy_actor->id(), std::set<std::string>{})
     .receive(jupiter().connection, basp::message_type::client_handshake,
-             no_flags, any_vals, no_operation_data, invalid_actor_id,
+             no_flags, any_vals, basp::version, invalid_actor_id,
              invalid_actor_id, this_node());
   CAF_CHECK_EQUAL(tbl().lookup_indirect(jupiter().id), none);
   CAF_CHECK_EQUAL(tbl().lookup_indirect(mars().id), none);
@@ -798,3 +1013,81 @@ CAF_TEST(automatic_connection) {
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(basp_flow_control_tests, flow_control_fixture)
+
+CAF_TEST(congested connections drop regular messages) {
+  auto dest = congest_jupiter();
+  auto hdl = jupiter().connection;
+  CAF_MESSAGE("drop regular messages to congested peers");
+  auto pending = mpx()->output_buffer(hdl).size();
+  self()->send(dest, std::string("hello"));
+  mpx()->exec_runnable();
+  CAF_CHECK_EQUAL(mpx()->output_buffer(hdl).size(), pending);
+  CAF_MESSAGE("deliver high-priority messages regardless");
+  self()->send<message_priority::high>(dest, std::string("urgent"));
+  mpx()->exec_runnable();
+  CAF_CHECK_GREATER(mpx()->output_buffer(hdl).size(), pending);
+  CAF_MESSAGE("accept regular messages again after draining the buffer");
+  mpx()->output_buffer(hdl).clear();
+  CAF_CHECK(!instance().congested(hdl));
+}
+
+CAF_TEST(congested connections bounce requests) {
+  auto dest = congest_jupiter();
+  auto hdl = jupiter().connection;
+  auto pending = mpx()->output_buffer(hdl).size();
+  auto rh = self()->request(dest, infinite, std::string("hello"));
+  do {
+    mpx()->exec_runnable();
+  } while (self()->mailbox().empty());
+  CAF_CHECK_EQUAL(mpx()->output_buffer(hdl).size(), pending);
+  std::move(rh).receive(
+    [](const std::string&) { CAF_FAIL("unexpected response"); },
+    [](const error& err) {
+      CAF_CHECK_EQUAL(err, sec::unavailable_or_would_block);
+    });
+}
+
+CAF_TEST(the middleman reports the state of connections) {
+  congest_jupiter();
+  auto hdl = jupiter().connection;
+  auto mm = sys.middleman().actor_handle();
+  auto query = [&] {
+    self()->send(mm, get_atom_v, pending_atom_v, jupiter().id);
+    do {
+      mpx()->exec_runnable();
+    } while (self()->mailbox().empty());
+    std::tuple<uint64_t, bool> result;
+    self()->receive([&](uint64_t pending, bool congested) {
+      result = std::make_tuple(pending, congested);
+    });
+    return result;
+  };
+  CAF_MESSAGE("congested connections report their pending bytes");
+  auto [pending, congested] = query();
+  CAF_CHECK_GREATER_OR_EQUAL(pending, 16384u);
+  CAF_CHECK(congested);
+  CAF_MESSAGE("drained connections are no longer congested");
+  mpx()->output_buffer(hdl).clear();
+  CAF_CHECK_EQUAL(query(), std::make_tuple(uint64_t{0}, false));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(basp_worker_tests, worker_fixture)
+
+CAF_TEST(workers close connections on malformed batches) {
+  connect_node(jupiter());
+  auto hdl = jupiter().connection;
+  send_malformed_batch(hdl);
+  // The worker runs asynchronously and then sends a message to the broker.
+  for (int i = 0; i < 1000 && aut()->valid(hdl); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    mpx()->flush_runnables();
+  }
+  CAF_CHECK(!aut()->valid(hdl));
+  CAF_CHECK(!tbl().lookup_direct(jupiter().id));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,229 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE io.middleman
+
+#include "caf/io/middleman.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <chrono>
+#include <numeric>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#ifndef CAF_WINDOWS
+#  include <unistd.h>
+#endif
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+constexpr size_t num_threads = 3;
+
+struct config : actor_system_config {
+  config() {
+    load<middleman>();
+    set("middleman.multiplexer-threads", num_threads);
+  }
+};
+
+struct fixture {
+  config cfg;
+  actor_system sys{cfg};
+  middleman& mm = sys.middleman();
+};
+
+struct lossy_config : actor_system_config {
+  lossy_config() {
+    load<middleman>();
+    set("middleman.udp-loss-rate", 0.1);
+  }
+};
+
+struct local_config : actor_system_config {
+  local_config() {
+    load<middleman>();
+    set("middleman.local-socket-dir", "/tmp");
+  }
+};
+
+behavior echo_server(broker* self) {
+  return {
+    [=](const new_connection_msg& msg) {
+      self->configure_read(msg.handle, receive_policy::exactly(4));
+    },
+    [=](const new_data_msg& msg) {
+      self->write(msg.handle, msg.buf.size(), msg.buf.data());
+      self->flush(msg.handle);
+    },
+    [](const connection_closed_msg&) {
+      // nop
+    },
+  };
+}
+
+behavior echo_client(broker* self, connection_handle hdl, actor buddy) {
+  self->configure_read(hdl, receive_policy::exactly(4));
+  self->write(hdl, 4, "ping");
+  self->flush(hdl);
+  return {
+    [=](const new_data_msg& msg) {
+      auto first = reinterpret_cast<const char*>(msg.buf.data());
+      self->send(buddy, std::string{first, first + msg.buf.size()});
+      self->quit();
+    },
+  };
+}
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(middleman_tests, fixture)
+
+CAF_TEST(the middleman runs one multiplexer per configured thread) {
+  CAF_REQUIRE_EQUAL(mm.num_backends(), num_threads);
+  std::set<network::multiplexer*> backends;
+  for (size_t i = 0; i < mm.num_backends(); ++i)
+    backends.emplace(&mm.backend_at(i));
+  CAF_CHECK_EQUAL(backends.size(), num_threads);
+  CAF_CHECK(&mm.backend_at(0) == &mm.backend());
+  CAF_CHECK(&mm.backend_for(num_threads + 1) == &mm.backend_at(1));
+  CAF_CHECK(mm.backend_of(&mm.backend_at(2)) == &mm.backend_at(2));
+  CAF_CHECK(mm.backend_of(nullptr) == nullptr);
+}
+
+CAF_TEST(sharded servers accept connections on all multiplexers) {
+  uint16_t port = 0;
+  auto servers = unbox(mm.spawn_sharded_server(echo_server, port));
+  CAF_REQUIRE(!servers.empty());
+  CAF_REQUIRE_NOT_EQUAL(port, 0u);
+#ifdef CAF_LINUX
+  CAF_CHECK_EQUAL(servers.size(), num_threads);
+#endif
+  scoped_actor self{sys};
+  constexpr size_t num_clients = 6;
+  for (size_t i = 0; i < num_clients; ++i) {
+    auto client = mm.spawn_client(echo_client, "localhost", port,
+                                  actor_cast<actor>(self));
+    CAF_REQUIRE(client);
+  }
+  size_t received = 0;
+  self->receive_for(received, num_clients)([](const std::string& str) {
+    CAF_CHECK_EQUAL(str, "ping");
+  });
+  CAF_CHECK_EQUAL(received, num_clients);
+  for (auto& server : servers)
+    anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+CAF_TEST(servers on ephemeral ports spread over all multiplexers) {
+  std::vector<actor> servers;
+  std::set<network::multiplexer*> backends;
+  for (size_t i = 0; i < num_threads; ++i) {
+    uint16_t port = 0;
+    auto server = unbox(mm.spawn_server(echo_server, port));
+    CAF_CHECK_NOT_EQUAL(port, 0u);
+    backends.emplace(&actor_cast<abstract_broker*>(server)->backend());
+    servers.emplace_back(std::move(server));
+  }
+  CAF_CHECK_EQUAL(backends.size(), num_threads);
+  for (auto& server : servers)
+    anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST(the testing backend ignores additional multiplexer threads) {
+  test_coordinator_fixture<config> fix;
+  CAF_CHECK_EQUAL(fix.sys.middleman().num_backends(), 1u);
+}
+
+CAF_TEST(BASP over UDP delivers messages in order despite packet loss) {
+  lossy_config server_cfg;
+  actor_system server_sys{server_cfg};
+  lossy_config client_cfg;
+  actor_system client_sys{client_cfg};
+  auto server = server_sys.spawn([]() -> behavior {
+    return {
+      [](int x) { return x; },
+    };
+  });
+  auto port = unbox(server_sys.middleman().publish_udp(server, 0, "127.0.0.1"));
+  CAF_REQUIRE_NOT_EQUAL(port, 0u);
+  auto remote = unbox(
+    client_sys.middleman().remote_actor_udp("127.0.0.1", port));
+  CAF_CHECK_EQUAL(remote, server);
+  scoped_actor self{client_sys};
+  constexpr int num_messages = 200;
+  for (int i = 0; i < num_messages; ++i)
+    self->send(remote, i);
+  std::vector<int> received;
+  for (int i = 0; i < num_messages; ++i)
+    self->receive([&](int x) { received.emplace_back(x); },
+                  after(std::chrono::seconds(10)) >> [&] {
+                    CAF_FAIL("timeout after " << received.size()
+                                              << " messages");
+                  });
+  std::vector<int> expected(num_messages);
+  std::iota(expected.begin(), expected.end(), 0);
+  CAF_CHECK_EQUAL(received, expected);
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+#ifndef CAF_WINDOWS
+
+CAF_TEST(remote_actor uses Unix domain sockets for peers on the same host) {
+  local_config server_cfg;
+  actor_system server_sys{server_cfg};
+  local_config client_cfg;
+  actor_system client_sys{client_cfg};
+  auto server = server_sys.spawn([]() -> behavior {
+    return {
+      [](int x) { return x; },
+    };
+  });
+  auto port = unbox(server_sys.middleman().publish(server, 0, "127.0.0.1"));
+  CAF_REQUIRE_NOT_EQUAL(port, 0u);
+  auto path = "/tmp/caf-" + std::to_string(port) + ".sock";
+  CAF_CHECK_EQUAL(access(path.c_str(), F_OK), 0);
+  auto remote = unbox(client_sys.middleman().remote_actor("127.0.0.1", port));
+  CAF_CHECK_EQUAL(remote, server);
+  scoped_actor self{client_sys};
+  self->request(remote, std::chrono::seconds(10), 42)
+    .receive([](int x) { CAF_CHECK_EQUAL(x, 42); },
+             [](const error& err) { CAF_FAIL("request failed: " << err); });
+  CAF_MESSAGE("local connections have no remote address");
+  self
+    ->request(client_sys.middleman().actor_handle(), std::chrono::seconds(10),
+              get_atom_v, server.node())
+    .receive(
+      [&](const node_id& nid, const std::string& addr, uint16_t) {
+        CAF_CHECK_EQUAL(nid, server.node());
+        CAF_CHECK_EQUAL(addr, "");
+      },
+      [](const error& err) { CAF_FAIL("request failed: " << err); });
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+#endif // CAF_WINDOWS
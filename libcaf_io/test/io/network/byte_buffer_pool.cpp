@@ -0,0 +1,65 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE io.network.byte_buffer_pool
+
+#include "caf/io/network/byte_buffer_pool.hpp"
+
+#include "caf/test/dsl.hpp"
+
+using namespace caf;
+using namespace caf::io::network;
+
+CAF_TEST(pools reuse the memory of recycled buffers) {
+  byte_buffer_pool pool{2, 1024};
+  byte_buffer buf;
+  buf.resize(100);
+  auto data = buf.data();
+  pool.put(std::move(buf));
+  CAF_CHECK_EQUAL(pool.size(), 1u);
+  auto result = pool.get();
+  CAF_CHECK(result.empty());
+  CAF_CHECK_GREATER_OR_EQUAL(result.capacity(), 100u);
+  CAF_CHECK(result.data() == data);
+  CAF_CHECK_EQUAL(pool.size(), 0u);
+}
+
+CAF_TEST(pools return new buffers when running empty) {
+  byte_buffer_pool pool{2, 1024};
+  auto buf = pool.get();
+  CAF_CHECK_EQUAL(buf.capacity(), 0u);
+  buf = pool.get(64);
+  CAF_CHECK_GREATER_OR_EQUAL(buf.capacity(), 64u);
+}
+
+CAF_TEST(pools drop buffers without memory or when full) {
+  byte_buffer_pool pool{2, 1024};
+  pool.put(byte_buffer{});
+  CAF_CHECK_EQUAL(pool.size(), 0u);
+  for (int i = 0; i < 3; ++i)
+    pool.put(byte_buffer(10));
+  CAF_CHECK_EQUAL(pool.size(), 2u);
+}
+
+CAF_TEST(pools drop buffers above their maximum capacity) {
+  byte_buffer_pool pool{2, 1024};
+  pool.put(byte_buffer(1025));
+  CAF_CHECK_EQUAL(pool.size(), 0u);
+  pool.put(byte_buffer(1024));
+  CAF_CHECK_EQUAL(pool.size(), 1u);
+}
@@ -23,12 +23,25 @@
 #include "caf/test/io_dsl.hpp"
 
 #include <algorithm>
+#include <cstring>
+#include <string>
 #include <vector>
 
 #include "caf/all.hpp"
 #include "caf/io/all.hpp"
+#include "caf/io/network/io_uring_context.hpp"
 #include "caf/io/network/operation.hpp"
 
+#ifndef CAF_WINDOWS
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
+#ifdef CAF_LINUX
+#  include <poll.h>
+#endif
+
 using namespace caf;
 
 namespace {
@@ -36,10 +49,16 @@ namespace {
 struct sub_fixture : test_coordinator_fixture<> {
   io::network::default_multiplexer mpx;
 
-  sub_fixture() : mpx(&sys) {
+  explicit sub_fixture(std::string backend = "default")
+    : mpx(select_backend(this, std::move(backend))) {
     // nop
   }
 
+  static actor_system* select_backend(sub_fixture* self, std::string backend) {
+    self->cfg.set("middleman.network-backend", std::move(backend));
+    return &self->sys;
+  }
+
   bool exec_all() {
     size_t count = 0;
     while (mpx.poll_once(false)) {
@@ -79,4 +98,121 @@ CAF_TEST(doorman io_failure) {
   CAF_CHECK_EQUAL(server.mpx.num_socket_handlers(), 1u);
 }
 
+#ifndef CAF_WINDOWS
+
+CAF_TEST(local doormen shadow TCP ports) {
+  auto path = "/tmp/caf-test-" + std::to_string(getpid()) + ".sock";
+  CAF_MESSAGE("connecting fails without a local doorman");
+  CAF_CHECK(!client.mpx.new_local_scribe(path));
+  CAF_MESSAGE("add local doorman to server");
+  auto doorman = unbox(server.mpx.new_local_doorman(path, 8080));
+  CAF_CHECK_EQUAL(doorman->port(), 8080u);
+  CAF_CHECK_EQUAL(doorman->addr(), path);
+  doorman->add_to_loop();
+  server.mpx.handle_internal_events();
+  CAF_CHECK_EQUAL(server.mpx.num_socket_handlers(), 2u);
+  CAF_MESSAGE("other doormen cannot take over the socket");
+  CAF_CHECK(!client.mpx.new_local_doorman(path, 8081));
+  CAF_MESSAGE("connect to the local doorman");
+  auto scribe = unbox(client.mpx.new_local_scribe(path));
+  CAF_CHECK_EQUAL(scribe->addr(), "");
+  CAF_MESSAGE("the doorman removes its socket file on destruction");
+  doorman->io_failure(&server.mpx, io::network::operation::propagate_error);
+  server.mpx.handle_internal_events();
+  CAF_CHECK_EQUAL(server.mpx.num_socket_handlers(), 1u);
+  scribe = nullptr;
+  doorman = nullptr;
+  CAF_CHECK_EQUAL(access(path.c_str(), F_OK), -1);
+}
+
+CAF_TEST(local doormen replace stale sockets) {
+  auto path = "/tmp/caf-test-stale-" + std::to_string(getpid()) + ".sock";
+  CAF_MESSAGE("leave a socket file without listener behind");
+  sockaddr_un sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sun_family = AF_UNIX;
+  memcpy(sa.sun_path, path.c_str(), path.size());
+  auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  CAF_REQUIRE_NOT_EQUAL(fd, -1);
+  CAF_REQUIRE_EQUAL(bind(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)), 0);
+  close(fd);
+  CAF_REQUIRE_EQUAL(access(path.c_str(), F_OK), 0);
+  CAF_MESSAGE("the doorman replaces the stale socket");
+  auto doorman = unbox(server.mpx.new_local_doorman(path, 8080));
+  CAF_CHECK(client.mpx.new_local_scribe(path));
+  doorman = nullptr;
+  CAF_CHECK_EQUAL(access(path.c_str(), F_OK), -1);
+}
+
+#endif // CAF_WINDOWS
+
 CAF_TEST_FIXTURE_SCOPE_END()
+
+namespace {
+
+// Selects the backend on Linux, other platforms always use the default.
+const char* backends[] = {"default", "epoll-et", "io-uring"};
+
+} // namespace
+
+CAF_TEST(all backends run posted functions) {
+  for (auto backend : backends) {
+    CAF_MESSAGE("backend: " << backend);
+    sub_fixture fix{backend};
+    size_t calls = 0;
+    for (size_t i = 0; i < 10; ++i)
+      fix.mpx.post([&] { ++calls; });
+    fix.exec_all();
+    CAF_CHECK_EQUAL(calls, 10u);
+  }
+}
+
+CAF_TEST(all backends track socket handlers) {
+  for (auto backend : backends) {
+    CAF_MESSAGE("backend: " << backend);
+    sub_fixture fix{backend};
+    auto& mpx = fix.mpx;
+    CAF_CHECK_EQUAL(mpx.num_socket_handlers(), 1u);
+    auto doorman = unbox(mpx.new_tcp_doorman(0, nullptr, false));
+    doorman->add_to_loop();
+    mpx.handle_internal_events();
+    CAF_CHECK_EQUAL(mpx.num_socket_handlers(), 2u);
+    fix.exec_all();
+    doorman->io_failure(&mpx, io::network::operation::propagate_error);
+    mpx.handle_internal_events();
+    CAF_CHECK_EQUAL(mpx.num_socket_handlers(), 1u);
+  }
+}
+
+#ifdef CAF_LINUX
+
+CAF_TEST(io_uring delivers all completions when its rings run full) {
+  io::network::io_uring_context ctx;
+  if (!ctx.init(4)) {
+    CAF_MESSAGE("io_uring unavailable, skip test");
+    return;
+  }
+  int fds[2];
+  CAF_REQUIRE_EQUAL(pipe(fds), 0);
+  // A readable pipe completes each poll request right away, i.e., queueing
+  // more requests than the rings hold overflows the completion ring.
+  CAF_REQUIRE_EQUAL(write(fds[1], "x", 1), 1);
+  constexpr uint64_t num_requests = 64;
+  for (uint64_t id = 0; id < num_requests; ++id)
+    ctx.poll_add(fds[0], POLLIN, id);
+  std::vector<uint64_t> ids;
+  for (size_t i = 0; i < 100 && ids.size() < num_requests; ++i)
+    ctx.submit_and_consume(false, [&](uint64_t id, int32_t res) {
+      CAF_CHECK_GREATER(res, 0);
+      ids.emplace_back(id);
+    });
+  std::sort(ids.begin(), ids.end());
+  std::vector<uint64_t> expected(num_requests);
+  for (uint64_t id = 0; id < num_requests; ++id)
+    expected[id] = id;
+  CAF_CHECK_EQUAL(ids, expected);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+#endif // CAF_LINUX
@@ -0,0 +1,428 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE io.network.reliable_channel
+
+#include "caf/io/network/reliable_channel.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace caf;
+using namespace caf::io;
+using namespace std::literals;
+
+namespace {
+
+using channel = network::reliable_channel;
+
+using time_point = channel::time_point;
+
+struct peer {
+  peer(uint32_t session, uint64_t first) : ch(session, first) {
+    // nop
+  }
+
+  // Returns all frames on `stream` in order of arrival.
+  std::vector<std::string> frames(uint16_t stream) const {
+    std::vector<std::string> result;
+    for (auto& x : received)
+      if (x.first == stream)
+        result.emplace_back(x.second);
+    return result;
+  }
+
+  channel ch;
+  std::vector<std::pair<uint16_t, std::string>> received;
+};
+
+// Connects two channels through a simulated network that delays, reorders and
+// drops datagrams.
+struct fixture {
+  struct datagram {
+    time_point arrival;
+    peer* dst;
+    byte_buffer buf;
+  };
+
+  explicit fixture(uint64_t first = 0) : alice(1, first), bob(2, first) {
+    // nop
+  }
+
+  peer alice;
+  peer bob;
+  time_point now = time_point{} + 1s;
+  std::minstd_rand rng{42};
+  double loss = 0;
+  timespan latency = 10ms;
+  timespan jitter = 0ms;
+  std::function<bool(const byte_buffer&)> drop_if;
+  std::vector<datagram> in_flight;
+
+  void send(peer& src, uint16_t stream, const std::string& str) {
+    CAF_REQUIRE(src.ch.send(stream, str.data(), str.size()));
+  }
+
+  void transmit(peer& src, peer& dst) {
+    src.ch.transmit(now, [&](byte_buffer& buf) {
+      std::uniform_real_distribution<double> coin{0, 1};
+      if ((drop_if && drop_if(buf)) || coin(rng) < loss)
+        return;
+      auto delay = latency;
+      if (jitter.count() > 0) {
+        std::uniform_int_distribution<timespan::rep> dis{0, jitter.count()};
+        delay += timespan{dis(rng)};
+      }
+      in_flight.emplace_back(datagram{now + delay, &dst, std::move(buf)});
+    });
+  }
+
+  void deliver(datagram& x) {
+    auto dst = x.dst;
+    auto f = [dst](uint16_t stream, byte_buffer& frame) {
+      auto first = reinterpret_cast<const char*>(frame.data());
+      dst->received.emplace_back(stream,
+                                 std::string{first, first + frame.size()});
+    };
+    CAF_CHECK(dst->ch.handle_datagram(now, x.buf.data(), x.buf.size(), f));
+  }
+
+  // Advances the simulation to the next event. Returns `false` once both
+  // channels went idle and no datagram is in flight.
+  bool step() {
+    transmit(alice, bob);
+    transmit(bob, alice);
+    auto next = std::min(alice.ch.next_timeout(), bob.ch.next_timeout());
+    for (auto& x : in_flight)
+      next = std::min(next, x.arrival);
+    if (next == time_point::max())
+      return false;
+    now = std::max(now, next);
+    std::stable_sort(in_flight.begin(), in_flight.end(),
+                     [](const datagram& x, const datagram& y) {
+                       return x.arrival < y.arrival;
+                     });
+    auto i = in_flight.begin();
+    for (; i != in_flight.end() && i->arrival <= now; ++i)
+      deliver(*i);
+    in_flight.erase(in_flight.begin(), i);
+    return true;
+  }
+
+  void run() {
+    for (size_t i = 0; i < 100000 && step(); ++i)
+      ; // Repeat.
+  }
+
+  // Sends a control frame in each direction, which also provides the first
+  // round-trip time samples.
+  void handshake() {
+    send(alice, 0, "alice");
+    send(bob, 0, "bob");
+    run();
+    CAF_REQUIRE_EQUAL(bob.frames(0), std::vector<std::string>{"alice"});
+    CAF_REQUIRE_EQUAL(alice.frames(0), std::vector<std::string>{"bob"});
+  }
+
+  // Sends `n` frames on each of the streams 1 to 3.
+  std::map<uint16_t, std::vector<std::string>> send_frames(size_t n) {
+    std::map<uint16_t, std::vector<std::string>> result;
+    for (size_t i = 0; i < n; ++i) {
+      for (uint16_t stream = 1; stream <= 3; ++stream) {
+        auto str = std::to_string(stream) + ":" + std::to_string(i);
+        // Every 10th frame requires fragmentation.
+        if (i % 10 == 0)
+          str.append(3 * channel::max_chunk_size, 'x');
+        send(alice, stream, str);
+        result[stream].emplace_back(std::move(str));
+      }
+    }
+    return result;
+  }
+
+  static bool is_data(const byte_buffer& buf) {
+    return !buf.empty() && buf[0] == byte{0};
+  }
+
+  // Reads a big-endian integer of `size` bytes at `pos`.
+  static uint64_t read(const byte_buffer& buf, size_t pos, size_t size) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < size; ++i)
+      result = (result << 8) | static_cast<uint64_t>(buf[pos + i]);
+    return result;
+  }
+
+  // Creates a data packet of session 1 that carries the first fragment of the
+  // frame `seq` on `stream`.
+  static byte_buffer make_data(uint64_t pkt, uint16_t stream, uint64_t seq,
+                               uint16_t frags) {
+    byte_buffer result;
+    auto put = [&](uint64_t x, size_t size) {
+      for (size_t i = size; i > 0; --i)
+        result.emplace_back(static_cast<byte>((x >> ((i - 1) * 8)) & 0xFF));
+    };
+    put(0, 1);
+    put(1, 4);
+    put(pkt, 8);
+    put(stream, 2);
+    put(seq, 8);
+    put(0, 2);
+    put(frags, 2);
+    put('x', 1);
+    return result;
+  }
+};
+
+// Starts all packet and sequence numbers shortly before 2^32.
+struct wrap_fixture : fixture {
+  static constexpr uint64_t first = std::numeric_limits<uint32_t>::max() - 15;
+
+  wrap_fixture() : fixture(first) {
+    // nop
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(reliable_channel_tests, fixture)
+
+CAF_TEST(frames arrive in order on each stream) {
+  handshake();
+  auto frames = send_frames(50);
+  run();
+  for (auto& kvp : frames)
+    CAF_CHECK_EQUAL(bob.frames(kvp.first), kvp.second);
+  CAF_CHECK_EQUAL(alice.ch.lost_packets(), 0u);
+  CAF_CHECK(alice.ch.idle());
+  CAF_CHECK_EQUAL(alice.ch.bytes_in_flight(), 0u);
+  CAF_CHECK_EQUAL(alice.ch.queued_bytes(), 0u);
+}
+
+CAF_TEST(retransmissions recover lost and reordered packets) {
+  loss = 0.2;
+  jitter = 20ms;
+  handshake();
+  auto frames = send_frames(100);
+  run();
+  for (auto& kvp : frames)
+    CAF_CHECK_EQUAL(bob.frames(kvp.first), kvp.second);
+  CAF_CHECK_NOT_EQUAL(alice.ch.lost_packets(), 0u);
+  CAF_CHECK(alice.ch.idle());
+  CAF_CHECK(!alice.ch.failed());
+}
+
+CAF_TEST(lost packets block only their own stream) {
+  handshake();
+  auto dropped = false;
+  drop_if = [&](const byte_buffer& buf) {
+    if (dropped || !is_data(buf))
+      return false;
+    dropped = true;
+    return true;
+  };
+  send(alice, 1, "first");
+  send(alice, 2, "second");
+  run();
+  CAF_REQUIRE_EQUAL(bob.received.size(), 3u);
+  CAF_CHECK_EQUAL(bob.received[1], std::make_pair(uint16_t{2}, "second"s));
+  CAF_CHECK_EQUAL(bob.received[2], std::make_pair(uint16_t{1}, "first"s));
+}
+
+CAF_TEST(streams wait for the first control frame) {
+  auto dropped = false;
+  drop_if = [&](const byte_buffer& buf) {
+    if (dropped || !is_data(buf))
+      return false;
+    dropped = true;
+    return true;
+  };
+  send(alice, 0, "handshake");
+  send(alice, 1, "message");
+  run();
+  CAF_REQUIRE_EQUAL(bob.received.size(), 2u);
+  CAF_CHECK_EQUAL(bob.received[0], std::make_pair(uint16_t{0}, "handshake"s));
+  CAF_CHECK_EQUAL(bob.received[1], std::make_pair(uint16_t{1}, "message"s));
+}
+
+CAF_TEST(losses shrink the congestion window) {
+  handshake();
+  fixture lossless;
+  lossless.handshake();
+  size_t count = 0;
+  drop_if = [&](const byte_buffer& buf) {
+    return is_data(buf) && ++count == 5;
+  };
+  send_frames(20);
+  lossless.send_frames(20);
+  run();
+  lossless.run();
+  CAF_CHECK_EQUAL(alice.ch.lost_packets(), 1u);
+  CAF_CHECK_EQUAL(lossless.alice.ch.lost_packets(), 0u);
+  CAF_CHECK_LESS(alice.ch.cwnd(), lossless.alice.ch.cwnd());
+}
+
+CAF_TEST(pacing spreads packets over the round-trip time) {
+  handshake();
+  for (int i = 0; i < 20; ++i)
+    send(alice, 1, std::string(1000, 'x'));
+  size_t burst = 0;
+  alice.ch.transmit(now, [&](byte_buffer&) { ++burst; });
+  CAF_CHECK_GREATER(burst, 0u);
+  CAF_CHECK_LESS(burst, channel::initial_window);
+  CAF_CHECK(alice.ch.next_timeout() > now);
+}
+
+CAF_TEST(channels fail after repeated probe timeouts) {
+  handshake();
+  loss = 1;
+  send(alice, 1, "hello?");
+  run();
+  CAF_CHECK(alice.ch.failed());
+  CAF_CHECK(alice.ch.next_timeout() == time_point::max());
+}
+
+CAF_TEST(closing notifies the peer) {
+  handshake();
+  alice.ch.close();
+  run();
+  CAF_CHECK(bob.ch.closed());
+}
+
+CAF_TEST(closing delivers all queued frames first) {
+  loss = 0.2;
+  handshake();
+  auto frames = send_frames(20);
+  alice.ch.close();
+  CAF_CHECK(!alice.ch.close_sent());
+  CAF_CHECK(!alice.ch.send(1, "late", 4));
+  run();
+  for (auto& kvp : frames)
+    CAF_CHECK_EQUAL(bob.frames(kvp.first), kvp.second);
+  CAF_CHECK(alice.ch.idle());
+  CAF_CHECK(alice.ch.close_sent());
+  CAF_CHECK(bob.ch.closed());
+}
+
+CAF_TEST(receivers drop frames beyond the receive window) {
+  auto f = [](uint16_t, byte_buffer&) {};
+  auto acks = [&] {
+    size_t result = 0;
+    bob.ch.transmit(now + 1s, [&](byte_buffer&) { ++result; });
+    return result;
+  };
+  auto beyond = make_data(0, 1, channel::receive_window, 1);
+  CAF_CHECK(bob.ch.handle_datagram(now, beyond.data(), beyond.size(), f));
+  CAF_CHECK_EQUAL(acks(), 0u);
+  auto within = make_data(1, 1, channel::receive_window - 1, 1);
+  CAF_CHECK(bob.ch.handle_datagram(now, within.data(), within.size(), f));
+  CAF_CHECK_EQUAL(acks(), 1u);
+  CAF_MESSAGE("receivers reject frames with too many fragments or streams");
+  auto frags = static_cast<uint16_t>(channel::max_frags + 1);
+  auto too_large = make_data(2, 1, 0, frags);
+  CAF_CHECK(!bob.ch.handle_datagram(now, too_large.data(), too_large.size(),
+                                    f));
+  auto bad_stream = make_data(3, channel::max_streams, 0, 1);
+  CAF_CHECK(!bob.ch.handle_datagram(now, bad_stream.data(), bad_stream.size(),
+                                    f));
+}
+
+CAF_TEST(senders hold back frames beyond the receive window) {
+  handshake();
+  size_t drops = 0;
+  size_t beyond = 0;
+  drop_if = [&](const byte_buffer& buf) {
+    if (!is_data(buf) || read(buf, 13, 2) != 1)
+      return false;
+    auto seq = read(buf, 15, 8);
+    if (bob.frames(1).empty() && seq >= channel::receive_window)
+      ++beyond;
+    return seq == 0 && drops++ < 2;
+  };
+  std::vector<std::string> frames;
+  for (uint32_t i = 0; i < 2 * channel::receive_window; ++i) {
+    frames.emplace_back(std::to_string(i));
+    send(alice, 1, frames.back());
+  }
+  run();
+  CAF_CHECK_EQUAL(drops, 3u);
+  CAF_CHECK_EQUAL(beyond, 0u);
+  CAF_CHECK_EQUAL(bob.frames(1), frames);
+}
+
+CAF_TEST(users may inspect the initial frame of new peers) {
+  send(alice, 0, "hello");
+  std::vector<byte_buffer> out;
+  alice.ch.transmit(now, [&](byte_buffer& buf) { out.emplace_back(buf); });
+  CAF_REQUIRE_EQUAL(out.size(), 1u);
+  auto frame = channel::initial_frame(out[0].data(), out[0].size());
+  CAF_CHECK_EQUAL(std::string(reinterpret_cast<const char*>(frame.data()),
+                              frame.size()),
+                  "hello");
+  auto other = make_data(0, 1, 0, 1);
+  CAF_CHECK(channel::initial_frame(other.data(), other.size()).empty());
+}
+
+CAF_TEST(channels reject malformed and foreign datagrams) {
+  handshake();
+  auto f = [](uint16_t, byte_buffer&) { CAF_FAIL("unexpected frame"); };
+  byte_buffer garbage{byte{0x42}, byte{0}, byte{0}, byte{0}, byte{1}};
+  CAF_CHECK(!bob.ch.handle_datagram(now, garbage.data(), garbage.size(), f));
+  channel mallory{3};
+  std::string str = "intruder";
+  mallory.send(1, str.data(), str.size());
+  mallory.transmit(now, [&](byte_buffer& buf) {
+    CAF_CHECK(!bob.ch.handle_datagram(now, buf.data(), buf.size(), f));
+  });
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(reliable_channel_wrap_tests, wrap_fixture)
+
+CAF_TEST(packet and sequence numbers continue beyond 32 bits) {
+  handshake();
+  loss = 0.1;
+  jitter = 5ms;
+  uint64_t max_pkt = 0;
+  uint64_t max_seq = 0;
+  drop_if = [&](const byte_buffer& buf) {
+    if (is_data(buf)) {
+      max_pkt = std::max(max_pkt, read(buf, 5, 8));
+      max_seq = std::max(max_seq, read(buf, 15, 8));
+    }
+    return false;
+  };
+  auto frames = send_frames(50);
+  run();
+  for (auto& kvp : frames)
+    CAF_CHECK_EQUAL(bob.frames(kvp.first), kvp.second);
+  CAF_CHECK(alice.ch.idle());
+  CAF_CHECK_GREATER(alice.ch.lost_packets(), 0u);
+  CAF_CHECK_GREATER(max_pkt, std::numeric_limits<uint32_t>::max());
+  CAF_CHECK_GREATER(max_seq, std::numeric_limits<uint32_t>::max());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
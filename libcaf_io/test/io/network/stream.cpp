@@ -0,0 +1,123 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE io.network.stream
+
+#include "caf/io/network/stream.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include "caf/io/network/default_multiplexer.hpp"
+#include "caf/io/network/native_socket.hpp"
+#include "caf/io/scribe.hpp"
+#include "caf/policy/tcp.hpp"
+
+using namespace caf;
+using namespace caf::io::network;
+
+namespace {
+
+byte_buffer make_buffer(size_t size, uint8_t first) {
+  byte_buffer result;
+  result.reserve(size);
+  for (size_t i = 0; i < size; ++i)
+    result.emplace_back(static_cast<byte>(first + i));
+  return result;
+}
+
+struct fixture : test_coordinator_fixture<> {
+  default_multiplexer mpx{&sys};
+  native_socket acceptor = invalid_native_socket;
+  native_socket sender = invalid_native_socket;
+  native_socket receiver = invalid_native_socket;
+
+  fixture() {
+    acceptor = unbox(new_tcp_acceptor_impl(0, "127.0.0.1", false));
+    auto port = unbox(local_port_of_fd(acceptor));
+    sender = unbox(new_tcp_connection("127.0.0.1", port));
+    if (!policy::tcp::try_accept(receiver, acceptor))
+      CAF_FAIL("unable to accept the test connection");
+  }
+
+  ~fixture() {
+    close_socket(acceptor);
+    close_socket(receiver);
+    if (sender != invalid_native_socket)
+      close_socket(sender);
+  }
+
+  byte_buffer receive(size_t num_bytes) {
+    byte_buffer result(num_bytes);
+    size_t received = 0;
+    while (received < num_bytes) {
+      size_t n = 0;
+      auto res = policy::tcp::read_some(n, receiver, result.data() + received,
+                                        num_bytes - received);
+      if (res != rw_state::success)
+        CAF_FAIL("unable to read from the test connection");
+      received += n;
+    }
+    return result;
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(stream_tests, fixture)
+
+CAF_TEST(gather writes send all buffers with a single call) {
+  auto xs = make_buffer(10, 0);
+  auto ys = make_buffer(2000, 10);
+  auto zs = make_buffer(5, 30);
+  span<const byte> bufs[] = {make_span(xs), make_span(ys), make_span(zs)};
+  size_t written = 0;
+  CAF_REQUIRE_EQUAL(policy::tcp::writev_some(written, sender, bufs, 3),
+                    rw_state::success);
+  CAF_REQUIRE_EQUAL(written, 2015u);
+  auto expected = xs;
+  expected.insert(expected.end(), ys.begin(), ys.end());
+  expected.insert(expected.end(), zs.begin(), zs.end());
+  CAF_CHECK_EQUAL(receive(2015), expected);
+}
+
+CAF_TEST(scribes send large buffers as separate segments) {
+  auto ptr = mpx.new_scribe(sender);
+  sender = invalid_native_socket; // Owned by the scribe now.
+  byte_buffer expected;
+  auto append = [&](const byte_buffer& buf) {
+    expected.insert(expected.end(), buf.begin(), buf.end());
+  };
+  auto small = make_buffer(100, 1);
+  append(small);
+  ptr->write(byte_buffer(small));
+  auto large = make_buffer(io::network::stream::zero_copy_threshold * 4, 2);
+  append(large);
+  ptr->write(std::move(large));
+  auto& out = ptr->wr_buf();
+  auto tail = make_buffer(50, 3);
+  out.insert(out.end(), tail.begin(), tail.end());
+  append(tail);
+  ptr->flush();
+  while (mpx.poll_once(false))
+    ; // Repeat.
+  CAF_CHECK_EQUAL(receive(expected.size()), expected);
+  CAF_MESSAGE("the stream recycles the memory of drained buffers");
+  CAF_CHECK_GREATER_OR_EQUAL(mpx.buffer_pool().size(), 2u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
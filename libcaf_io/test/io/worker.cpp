@@ -26,6 +26,7 @@
 #include "caf/actor_control_block.hpp"
 #include "caf/actor_system.hpp"
 #include "caf/binary_serializer.hpp"
+#include "caf/io/connection_handle.hpp"
 #include "caf/io/basp/message_queue.hpp"
 #include "caf/make_actor.hpp"
 #include "caf/proxy_registry.hpp"
@@ -35,9 +36,22 @@ using namespace caf;
 namespace {
 
 behavior testee_impl() {
-  return {[](ok_atom) {
-    // nop
-  }};
+  return {
+    [](ok_atom) {
+      // nop
+    },
+    [](ok_atom, int) {
+      // nop
+    },
+  };
+}
+
+behavior broker_impl() {
+  return {
+    [](close_atom, io::connection_handle) {
+      // nop
+    },
+  };
 }
 
 class mock_actor_proxy : public actor_proxy {
@@ -81,11 +95,14 @@ struct fixture : test_coordinator_fixture<> {
   proxy_registry proxies;
   node_id last_hop;
   actor testee;
+  actor broker;
+  io::connection_handle hdl = io::connection_handle::from_int(1);
 
   fixture() : proxies_backend(sys), proxies(sys, proxies_backend) {
     auto tmp = make_node_id(123, "0011223344556677889900112233445566778899");
     last_hop = unbox(std::move(tmp));
     testee = sys.spawn<lazy_init>(testee_impl);
+    broker = sys.spawn<lazy_init>(broker_impl);
     sys.registry().put(testee.id(), testee);
   }
 
@@ -122,4 +139,146 @@ CAF_TEST(deliver serialized message) {
   expect((ok_atom), from(_).to(testee));
 }
 
+CAF_TEST(deliver routed messages with a resolved route) {
+  hub.add_new_worker(queue, proxies);
+  auto w = hub.pop();
+  CAF_REQUIRE_NOT_EQUAL(w, nullptr);
+  auto tmp = make_node_id(456, "9988776655443322110099887766554433221100");
+  auto source_node = unbox(std::move(tmp));
+  CAF_MESSAGE("create a routed message without source and destination node");
+  byte_buffer payload;
+  std::vector<strong_actor_ptr> stages;
+  binary_serializer sink{sys, payload};
+  if (auto err = sink(stages, make_message(ok_atom_v)))
+    CAF_FAIL("unable to serialize message: " << sys.render(err));
+  io::basp::header hdr{io::basp::message_type::routed_message,
+                       io::basp::header::interned_flag,
+                       static_cast<uint32_t>(payload.size()),
+                       make_message_id().integer_value(),
+                       42,
+                       testee.id()};
+  w->launch(last_hop, source_node, hdr, payload);
+  sched.run_once();
+  expect((ok_atom), from(_).to(testee));
+  CAF_CHECK_NOT_EQUAL(proxies.get(source_node, 42), nullptr);
+}
+
+CAF_TEST(deliver batched messages) {
+  CAF_MESSAGE("create the BASP worker");
+  hub.add_new_worker(queue, proxies);
+  auto w = hub.pop();
+  CAF_REQUIRE_NOT_EQUAL(w, nullptr);
+  CAF_MESSAGE("create a batch with three messages");
+  byte_buffer batch;
+  for (int i = 0; i < 3; ++i) {
+    byte_buffer payload;
+    std::vector<strong_actor_ptr> stages;
+    binary_serializer sink{sys, payload};
+    if (auto err = sink(stages, make_message(ok_atom_v, i)))
+      CAF_FAIL("unable to serialize message: " << sys.render(err));
+    io::basp::header hdr{io::basp::message_type::direct_message,
+                         0,
+                         static_cast<uint32_t>(payload.size()),
+                         make_message_id().integer_value(),
+                         42,
+                         testee.id()};
+    io::basp::write_sub_header(batch, hdr);
+    batch.insert(batch.end(), payload.begin(), payload.end());
+  }
+  io::basp::header hdr{io::basp::message_type::batched_message,
+                       0,
+                       static_cast<uint32_t>(batch.size()),
+                       3,
+                       0,
+                       0};
+  CAF_MESSAGE("launch worker");
+  w->launch(actor_cast<strong_actor_ptr>(broker), hdl, last_hop, hdr, batch);
+  sched.run_once();
+  expect((ok_atom, int), from(_).to(testee).with(_, 0));
+  expect((ok_atom, int), from(_).to(testee).with(_, 1));
+  expect((ok_atom, int), from(_).to(testee).with(_, 2));
+  CAF_CHECK_EQUAL(queue.next_undelivered(), 3u);
+}
+
+CAF_TEST(hubs shrink down to a minimum size) {
+  for (int i = 0; i < 3; ++i)
+    hub.add_new_worker(queue, proxies);
+  CAF_CHECK_EQUAL(hub.size(), 3u);
+  CAF_CHECK(hub.idle());
+  CAF_CHECK(hub.shrink(1));
+  CAF_CHECK_EQUAL(hub.size(), 2u);
+  CAF_CHECK(hub.shrink(1));
+  CAF_CHECK_EQUAL(hub.size(), 1u);
+  CAF_CHECK(!hub.shrink(1));
+  CAF_CHECK_EQUAL(hub.size(), 1u);
+  auto w = hub.pop();
+  CAF_REQUIRE_NOT_EQUAL(w, nullptr);
+  CAF_CHECK(!hub.idle());
+  CAF_CHECK_EQUAL(hub.pop(), nullptr);
+  hub.push(w);
+  CAF_CHECK(hub.idle());
+}
+
+CAF_TEST(hubs shrink only after idling for the configured delay) {
+  using std::chrono::milliseconds;
+  auto t0 = actor_clock::time_point{};
+  auto delay = timespan{milliseconds(100)};
+  for (int i = 0; i < 3; ++i)
+    hub.add_new_worker(queue, proxies);
+  CAF_MESSAGE("the first call only starts the idle period");
+  CAF_CHECK(!hub.shrink(1, t0, delay));
+  CAF_CHECK(!hub.shrink(1, t0 + milliseconds(99), delay));
+  CAF_CHECK_EQUAL(hub.size(), 3u);
+  CAF_MESSAGE("busy workers reset the idle period");
+  auto w = hub.pop();
+  CAF_REQUIRE_NOT_EQUAL(w, nullptr);
+  CAF_CHECK(!hub.shrink(1, t0 + milliseconds(150), delay));
+  hub.push(w);
+  CAF_CHECK(!hub.shrink(1, t0 + milliseconds(200), delay));
+  CAF_CHECK(!hub.shrink(1, t0 + milliseconds(250), delay));
+  CAF_CHECK_EQUAL(hub.size(), 3u);
+  CAF_MESSAGE("the hub removes at most one worker per delay");
+  CAF_CHECK(hub.shrink(1, t0 + milliseconds(300), delay));
+  CAF_CHECK_EQUAL(hub.size(), 2u);
+  CAF_CHECK(!hub.shrink(1, t0 + milliseconds(350), delay));
+  CAF_CHECK(hub.shrink(1, t0 + milliseconds(400), delay));
+  CAF_CHECK_EQUAL(hub.size(), 1u);
+  CAF_CHECK(!hub.shrink(1, t0 + milliseconds(1000), delay));
+  CAF_CHECK_EQUAL(hub.size(), 1u);
+}
+
+CAF_TEST(malformed batches close the connection) {
+  hub.add_new_worker(queue, proxies);
+  auto w = hub.pop();
+  CAF_REQUIRE_NOT_EQUAL(w, nullptr);
+  CAF_MESSAGE("create a batch with a valid and a corrupted sub-header");
+  byte_buffer payload;
+  std::vector<strong_actor_ptr> stages;
+  binary_serializer sink{sys, payload};
+  if (auto err = sink(stages, make_message(ok_atom_v, 0)))
+    CAF_FAIL("unable to serialize message: " << sys.render(err));
+  io::basp::header sub_hdr{io::basp::message_type::direct_message,
+                           0,
+                           static_cast<uint32_t>(payload.size()),
+                           make_message_id().integer_value(),
+                           42,
+                           testee.id()};
+  byte_buffer batch;
+  io::basp::write_sub_header(batch, sub_hdr);
+  batch.insert(batch.end(), payload.begin(), payload.end());
+  batch.insert(batch.end(), {byte{0xFF}, byte{0xFF}, byte{0xFF}, byte{0xFF}});
+  io::basp::header hdr{io::basp::message_type::batched_message,
+                       0,
+                       static_cast<uint32_t>(batch.size()),
+                       2,
+                       0,
+                       0};
+  w->launch(actor_cast<strong_actor_ptr>(broker), hdl, last_hop, hdr, batch);
+  sched.run_once();
+  CAF_MESSAGE("the worker drops the batch and asks the broker to close");
+  expect((close_atom, io::connection_handle), from(_).to(broker).with(_, hdl));
+  disallow((ok_atom, int), from(_).to(testee));
+  CAF_CHECK_EQUAL(queue.next_undelivered(), 2u);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
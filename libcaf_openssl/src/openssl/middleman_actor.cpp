@@ -129,6 +129,10 @@ public:
     return stream_.wr_buf();
   }
 
+  size_t pending_bytes() override {
+    return stream_.pending_bytes();
+  }
+
   byte_buffer& rd_buf() override {
     return stream_.rd_buf();
   }
@@ -252,6 +256,21 @@ protected:
     return make_counted<doorman_impl>(mpx(), *fd);
   }
 
+  // BASP over UDP has no encryption layer. Hence, we refuse to send plaintext
+  // data when users ask for an OpenSSL-enabled middleman.
+
+  expected<io::datagram_servant_ptr>
+  contact(const std::string& host, uint16_t port) override {
+    CAF_LOG_TRACE(CAF_ARG(host) << CAF_ARG(port));
+    return sec::feature_disabled;
+  }
+
+  expected<io::datagram_servant_ptr>
+  open_udp(uint16_t port, const char* addr, bool reuse) override {
+    CAF_LOG_TRACE(CAF_ARG(port) << CAF_ARG(addr) << CAF_ARG(reuse));
+    return sec::feature_disabled;
+  }
+
 private:
   default_mpx& mpx() {
     return static_cast<default_mpx&>(system().middleman().backend());
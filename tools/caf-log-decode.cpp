@@ -0,0 +1,141 @@
+// Decodes binary log files written by CAF with `logger.binary-output = true`
+// and renders them as text, using the same format fields as the logger.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "caf/all.hpp"
+#include "caf/detail/binary_log.hpp"
+
+using std::string;
+
+using namespace caf;
+
+namespace {
+
+constexpr string_view level_names[] = {
+  "QUIET", "",     "", "ERROR", "",      "", "WARN", "",
+  "",      "INFO", "", "",      "DEBUG", "", "",     "TRACE",
+};
+
+using reader_type = detail::binary_log_reader;
+
+// Names threads without actor in order of appearance, like the logger does.
+using thread_names = std::map<uint64_t, size_t>;
+
+void render(std::ostream& out, const logger::line_format& lf, timestamp t0,
+            thread_names& threads, const reader_type::event& x) {
+  auto& site = *x.origin;
+  // Allows us to re-use the rendering functions of the logger.
+  logger::event tmp;
+  tmp.pretty_fun = site.pretty_fun;
+  tmp.simple_fun = site.simple_fun;
+  for (auto& f : lf)
+    switch (f.kind) {
+      case logger::category_field:
+        out << site.component;
+        break;
+      case logger::class_name_field:
+        logger::render_fun_prefix(out, tmp);
+        break;
+      case logger::date_field:
+        logger::render_date(out, x.tstamp);
+        break;
+      case logger::file_field:
+        out << site.file_name;
+        break;
+      case logger::line_field:
+        out << site.line;
+        break;
+      case logger::message_field:
+        out << x.message;
+        break;
+      case logger::method_field:
+        logger::render_fun_name(out, tmp);
+        break;
+      case logger::newline_field:
+        out << '\n';
+        break;
+      case logger::priority_field:
+        if (site.level < std::size(level_names))
+          out << level_names[site.level];
+        break;
+      case logger::runtime_field: {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        out << duration_cast<milliseconds>(x.tstamp - t0).count();
+        break;
+      }
+      case logger::thread_field:
+        out << x.tid;
+        break;
+      case logger::actor_field:
+        if (x.aid != 0) {
+          out << "actor" << x.aid;
+        } else {
+          auto i = threads.emplace(x.tid, threads.size() + 1).first;
+          out << "thread" << i->second;
+        }
+        break;
+      case logger::percent_sign_field:
+        out << '%';
+        break;
+      case logger::plain_text_field:
+        out << f.text;
+        break;
+      default:
+        break;
+    }
+}
+
+struct config : public actor_system_config {
+  string output_file;
+  string format = "%r %c %p %a %t %C %M %F:%L %m%n";
+  config() {
+    opt_group{custom_options_, "global"}
+      .add(output_file, "output-file,o", "Path for the output file")
+      .add(format, "format,f", "Format for rendering individual log entries");
+    // shutdown logging per default
+    set("logger.verbosity", "quiet");
+  }
+};
+
+} // namespace
+
+// decodes all binary log files given as remaining CLI arguments
+void caf_main(actor_system&, const config& cfg) {
+  using namespace std;
+  if (cfg.output_file.empty()) {
+    cerr << "*** no output file specified" << endl;
+    return;
+  }
+  std::ofstream out{cfg.output_file};
+  if (!out) {
+    cerr << "unable to open output file: " << cfg.output_file << endl;
+    return;
+  }
+  auto lf = logger::parse_format(cfg.format);
+  for (auto& file : cfg.remainder) {
+    std::ifstream in{file, std::ios::binary};
+    if (!in) {
+      cerr << "could not open file: " << file << endl;
+      continue;
+    }
+    reader_type reader{in};
+    if (!reader.read_header()) {
+      cerr << "not a binary CAF log file: " << file << endl;
+      continue;
+    }
+    reader_type::event x;
+    thread_names threads;
+    while (reader.next(x))
+      render(out, lf, reader.t0(), threads, x);
+    if (reader.malformed())
+      cerr << "stopped at malformed input in file: " << file << endl;
+  }
+}
+
+CAF_MAIN()